@@ -20,16 +20,10 @@ namespace fast {
 
         mIterationError = mTolerance + 10.0;
         mObjectiveFunction = mObjectiveFunction = std::numeric_limits<double>::max();
-        mResponsibilityMatrix = MatrixXf::Zero(mNumMovingPoints, mNumFixedPoints);
     }
 
     void CoherentPointDriftAffine::maximization(Eigen::MatrixXf &fixedPoints, Eigen::MatrixXf &movingPoints) {
 
-        // Define some useful matrix sums
-        mPt1 = mResponsibilityMatrix.transpose().rowwise().sum();      // mNumFixedPoints x 1
-        mP1 = mResponsibilityMatrix.rowwise().sum();                   // mNumMovingPoints x 1
-        mNp = mPt1.sum();                                           // 1 (sum of all P elements)
-
         // Estimate new mean vectors
         MatrixXf fixedMean = fixedPoints.transpose() * mPt1 / mNp;
         MatrixXf movingMean = movingPoints.transpose() * mP1 / mNp;
@@ -41,7 +35,8 @@ namespace fast {
         /* **********************************************************
          * Find transformation parameters: affine matrix, translation
          * *********************************************************/
-        MatrixXf A = fixedPointsCentered.transpose() * mResponsibilityMatrix.transpose() * movingPointsCentered;
+        // Xc^T * P^T * Yc expressed with the sums from the E-step
+        MatrixXf A = mPX.transpose() * movingPoints - mNp * fixedMean * movingMean.transpose();
         MatrixXf YPY = movingPointsCentered.transpose() * mP1.asDiagonal() * movingPointsCentered;
         MatrixXf XPX = fixedPointsCentered.transpose() * mPt1.asDiagonal() * fixedPointsCentered;
 
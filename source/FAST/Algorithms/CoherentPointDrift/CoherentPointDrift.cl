@@ -0,0 +1,50 @@
+/**
+ * E-step of Coherent Point Drift without storing the responsibility matrix.
+ * Points are stored as x, y, z for each point.
+ */
+
+// Denominator of the responsibilities of each fixed point
+__kernel void denominators(
+        __global const float* fixedPoints,
+        __global const float* movingPoints,
+        __private const int nrOfMovingPoints,
+        __private const float variance,
+        __private const float c,
+        __global float* denominators
+        ) {
+    const int n = get_global_id(0);
+    const float3 x = vload3(n, fixedPoints);
+    const float scale = -1.0f / (2.0f * variance);
+    float sum = 0.0f;
+    for(int m = 0; m < nrOfMovingPoints; ++m) {
+        const float3 diff = x - vload3(m, movingPoints);
+        sum += exp(dot(diff, diff) * scale);
+    }
+    denominators[n] = max(sum + c, FLT_EPSILON);
+}
+
+// Sum of the responsibilities (P1) and the responsibility weighted sum of fixed points (PX) of each moving point
+__kernel void responsibilities(
+        __global const float* fixedPoints,
+        __global const float* movingPoints,
+        __private const int nrOfFixedPoints,
+        __private const float variance,
+        __global const float* denominators,
+        __global float* P1,
+        __global float* PX
+        ) {
+    const int m = get_global_id(0);
+    const float3 y = vload3(m, movingPoints);
+    const float scale = -1.0f / (2.0f * variance);
+    float sum = 0.0f;
+    float3 weightedSum = (float3)(0.0f, 0.0f, 0.0f);
+    for(int n = 0; n < nrOfFixedPoints; ++n) {
+        const float3 x = vload3(n, fixedPoints);
+        const float3 diff = x - y;
+        const float p = exp(dot(diff, diff) * scale) / denominators[n];
+        sum += p;
+        weightedSum += p * x;
+    }
+    P1[m] = sum;
+    vstore3(weightedSum, m, PX);
+}
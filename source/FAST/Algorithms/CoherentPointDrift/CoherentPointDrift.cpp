@@ -20,6 +20,8 @@ namespace fast {
         mIteration = 0;
         mTolerance = 1e-4;
         mUniformWeight = 0.5;
+        mTruncation = 0.0f;
+        mUseOpenCL = false;
         mTransformation = Transform::create();
         mRegistrationConverged = false;
         mScale = 1.0;
@@ -34,6 +36,7 @@ namespace fast {
         timeMSVD = 0.0;
         timeMParameters = 0.0;
         timeMUpdate = 0.0;
+        createOpenCLProgram(Config::getKernelSourcePath() + "Algorithms/CoherentPointDrift/CoherentPointDrift.cl");
     }
 
     void CoherentPointDrift::initializePointSets() {
@@ -93,40 +96,114 @@ namespace fast {
     void CoherentPointDrift::expectation(MatrixXf& fixedPoints, MatrixXf& movingPoints) {
 
         /* **********************************************************************************
-         * Calculate distances between the points in the two point sets
-         * Let row i in P equal the squared distances from all fixed points to moving point i
+         * The responsibility matrix P (M x N) is never stored. Element (m, n) is
+         *     exp(-||x_n - y_m||^2 / (2*variance)) / (sum_m' exp(-||x_n - y_m'||^2 / (2*variance)) + c)
+         * First the denominator is found for each fixed point n, then the sums P1, Pt1, PX
+         * needed by the M-step are accumulated for each moving point m.
          * *********************************************************************************/
-
-        /* Implementation without OpenMP
-        MatrixXf movingPointMatrix = MatrixXf::Zero(mNumMovingPoints, mNumFixedPoints);
-        MatrixXf distances = MatrixXf::Zero(mNumMovingPoints, mNumFixedPoints);
-        for (int i = 0; i < mNumMovingPoints; ++i) {
-            movingPointMatrix = movingPoints.row(i).replicate(mNumFixedPoints, 1);
-            distances = fixedPoints - movingPoints.row(i).replicate(mNumFixedPoints, 1);
-            distances = fixedPoints - movingPointMatrix;            // Distance between all fixed points and moving point i
-            distances = distances.cwiseAbs2();                            // Square distance components (3xN)
-            mResponsibilityMatrix.row(i) = distances.rowwise().sum();   // Sum x, y, z components (1xN)
-        }
-        */
-
         auto c = (float) (pow(2*(double)EIGEN_PI*mVariance, (double)mNumDimensions/2.0)
                           * (mUniformWeight/(1-mUniformWeight)) * (float)mNumMovingPoints/mNumFixedPoints);
 
-#pragma omp parallel for //collapse(2)
-        for (int col = 0; col < mNumFixedPoints; ++col) {
-            for (int row = 0; row < mNumMovingPoints; ++row) {
-                double norm = (fixedPoints.row(col) - movingPoints.row(row)).squaredNorm();
-                mResponsibilityMatrix(row, col) = exp(norm / (-2.0 * mVariance));
+        if(mUseOpenCL && mTruncation <= 0 && mNumDimensions == 3 && !getMainDevice()->isHost()) {
+            expectationWithOpenCL(fixedPoints, movingPoints, c);
+        } else {
+            expectationOnHost(fixedPoints, movingPoints, c);
+        }
+        mNp = mPt1.sum();
+    }
+
+    void CoherentPointDrift::expectationOnHost(MatrixXf& fixedPoints, MatrixXf& movingPoints, float c) {
+        // Points as columns for faster access
+        const MatrixXf fixed = fixedPoints.transpose();
+        const MatrixXf moving = movingPoints.transpose();
+        const bool truncate = mTruncation > 0;
+        const float radius = mTruncation*std::sqrt((float)mVariance);
+        const float scale = (float)(-1.0 / (2.0 * mVariance));
+        // The moving points change every iteration, thus the tree has to be rebuilt
+        KDTree movingTree;
+        if(truncate)
+            movingTree.build(moving);
+
+        VectorXf denominators(mNumFixedPoints);
+#pragma omp parallel for
+        for(int n = 0; n < mNumFixedPoints; ++n) {
+            float sum = 0.0f;
+            if(truncate) {
+                for(int m : movingTree.findWithinRadius(fixed.col(n), radius))
+                    sum += std::exp((fixed.col(n) - moving.col(m)).squaredNorm() * scale);
+            } else {
+                for(int m = 0; m < mNumMovingPoints; ++m)
+                    sum += std::exp((fixed.col(n) - moving.col(m)).squaredNorm() * scale);
             }
+            denominators(n) = max(sum + c, Eigen::NumTraits<float>::epsilon());
+            mPt1(n) = sum / denominators(n);
         }
 
 #pragma omp parallel for
-        for (int col = 0; col < mNumFixedPoints; ++col) {
-            float denom = mResponsibilityMatrix.col(col).sum() + c;
-            mResponsibilityMatrix.col(col) /= max(denom, Eigen::NumTraits<float>::epsilon() );
+        for(int m = 0; m < mNumMovingPoints; ++m) {
+            float P1 = 0.0f;
+            VectorXf PX = VectorXf::Zero(mNumDimensions);
+            auto accumulate = [&](int n) {
+                const float p = std::exp((fixed.col(n) - moving.col(m)).squaredNorm() * scale) / denominators(n);
+                P1 += p;
+                PX += p * fixed.col(n);
+            };
+            if(truncate) {
+                for(int n : mFixedTree.findWithinRadius(moving.col(m), radius))
+                    accumulate(n);
+            } else {
+                for(int n = 0; n < mNumFixedPoints; ++n)
+                    accumulate(n);
+            }
+            mP1(m) = P1;
+            mPX.row(m) = PX.transpose();
         }
     }
 
+    void CoherentPointDrift::expectationWithOpenCL(MatrixXf& fixedPoints, MatrixXf& movingPoints, float c) {
+        auto device = std::dynamic_pointer_cast<OpenCLDevice>(getMainDevice());
+        auto queue = device->getCommandQueue();
+        cl::Program program = getOpenCLProgram(device);
+        cl::Kernel denominatorsKernel(program, "denominators");
+        cl::Kernel responsibilitiesKernel(program, "responsibilities");
+
+        // Points as columns, i.e. x, y, z of each point are stored contiguously
+        MatrixXf fixed = fixedPoints.transpose();
+        MatrixXf moving = movingPoints.transpose();
+        cl::Buffer fixedBuffer(device->getContext(), CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                               mNumFixedPoints*3*sizeof(float), fixed.data());
+        cl::Buffer movingBuffer(device->getContext(), CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                                mNumMovingPoints*3*sizeof(float), moving.data());
+        cl::Buffer denominatorsBuffer(device->getContext(), CL_MEM_READ_WRITE, mNumFixedPoints*sizeof(float));
+        cl::Buffer P1Buffer(device->getContext(), CL_MEM_WRITE_ONLY, mNumMovingPoints*sizeof(float));
+        cl::Buffer PXBuffer(device->getContext(), CL_MEM_WRITE_ONLY, mNumMovingPoints*3*sizeof(float));
+
+        denominatorsKernel.setArg(0, fixedBuffer);
+        denominatorsKernel.setArg(1, movingBuffer);
+        denominatorsKernel.setArg(2, (int)mNumMovingPoints);
+        denominatorsKernel.setArg(3, (float)mVariance);
+        denominatorsKernel.setArg(4, c);
+        denominatorsKernel.setArg(5, denominatorsBuffer);
+        queue.enqueueNDRangeKernel(denominatorsKernel, cl::NullRange, cl::NDRange(mNumFixedPoints), cl::NullRange);
+
+        responsibilitiesKernel.setArg(0, fixedBuffer);
+        responsibilitiesKernel.setArg(1, movingBuffer);
+        responsibilitiesKernel.setArg(2, (int)mNumFixedPoints);
+        responsibilitiesKernel.setArg(3, (float)mVariance);
+        responsibilitiesKernel.setArg(4, denominatorsBuffer);
+        responsibilitiesKernel.setArg(5, P1Buffer);
+        responsibilitiesKernel.setArg(6, PXBuffer);
+        queue.enqueueNDRangeKernel(responsibilitiesKernel, cl::NullRange, cl::NDRange(mNumMovingPoints), cl::NullRange);
+
+        VectorXf denominators(mNumFixedPoints);
+        MatrixXf PX(3, mNumMovingPoints);
+        queue.enqueueReadBuffer(denominatorsBuffer, CL_FALSE, 0, mNumFixedPoints*sizeof(float), denominators.data());
+        queue.enqueueReadBuffer(P1Buffer, CL_FALSE, 0, mNumMovingPoints*sizeof(float), mP1.data());
+        queue.enqueueReadBuffer(PXBuffer, CL_TRUE, 0, mNumMovingPoints*3*sizeof(float), PX.data());
+        mPt1 = (denominators.array() - c) / denominators.array();
+        mPX = PX.transpose();
+    }
+
     void CoherentPointDrift::execute() {
 
         // Store the point sets in matrices and store their dimensions
@@ -143,6 +220,11 @@ namespace fast {
 
         // Initialize variance and error
         initializeVarianceAndMore();
+        mPt1 = VectorXf::Zero(mNumFixedPoints);
+        mP1 = VectorXf::Zero(mNumMovingPoints);
+        mPX = MatrixXf::Zero(mNumMovingPoints, mNumDimensions);
+        if(mTruncation > 0)
+            mFixedTree.build(mFixedPoints.transpose());
 
 
         /* *************************
@@ -218,6 +300,16 @@ namespace fast {
         mTolerance = tolerance;
     }
 
+    void CoherentPointDrift::setTruncation(float standardDeviations) {
+        if(standardDeviations < 0)
+            throw Exception("Truncation in CoherentPointDrift must be >= 0");
+        mTruncation = standardDeviations;
+    }
+
+    void CoherentPointDrift::setUseOpenCL(bool useOpenCL) {
+        mUseOpenCL = useOpenCL;
+    }
+
     Transform::pointer CoherentPointDrift::getOutputTransformation() {
         return mTransformation;
     }
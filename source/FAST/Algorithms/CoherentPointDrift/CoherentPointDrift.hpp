@@ -3,11 +3,17 @@
 #include "FAST/Data/DataBoundingBox.hpp"
 #include "FAST/ProcessObject.hpp"
 #include "FAST/Data/Mesh.hpp"
+#include "FAST/KDTree.hpp"
 
 namespace fast {
 
 /**
  * @brief Abstract base class for Coherent Point Drift (CPD) registration
+ *
+ * The E-step computes the responsibilities on the fly, and only stores the sums needed by the M-step,
+ * thus memory use is linear in the number of points.
+ * With truncation enabled, each point is only compared with the points within a number of standard deviations,
+ * found using k-d trees. The E-step can also run as an OpenCL kernel on the main device.
  */
 class FAST_EXPORT  CoherentPointDrift: public ProcessObject {
 //    FAST_OBJECT(CoherentPointDrift)
@@ -20,6 +26,17 @@ class FAST_EXPORT  CoherentPointDrift: public ProcessObject {
         void setMaximumIterations(unsigned char maxIterations);
         void setUniformWeight(float uniformWeight);
         void setTolerance(double tolerance);
+        /**
+         * @brief Only compare points within a distance of the given number of standard deviations in the E-step.
+         * Responsibilities of points further away are set to zero. Speeds up registration of large point clouds.
+         * @param standardDeviations If 0, all point pairs are used (default).
+         */
+        void setTruncation(float standardDeviations);
+        /**
+         * @brief Compute the E-step using OpenCL on the main device. Only used for 3D point sets without truncation.
+         * @param useOpenCL
+         */
+        void setUseOpenCL(bool useOpenCL);
         Transform::pointer getOutputTransformation();
 
         virtual void initializeVarianceAndMore() = 0;
@@ -29,16 +46,25 @@ class FAST_EXPORT  CoherentPointDrift: public ProcessObject {
     protected:
         CoherentPointDrift();
         void execute();
+        void expectationOnHost(MatrixXf& fixedPoints, MatrixXf& movingPoints, float c);
+        void expectationWithOpenCL(MatrixXf& fixedPoints, MatrixXf& movingPoints, float c);
         MatrixXf mFixedPoints;
         MatrixXf mMovingPoints;
         MatrixXf mMovingMeanInitial;
         MatrixXf mFixedMeanInitial;
-        MatrixXf mResponsibilityMatrix;         // P
+        // Sums of the responsibility matrix P (M x N) computed in the E-step
+        VectorXf mPt1;                          // Colwise sum of P, then transpose
+        VectorXf mP1;                           // Rowwise sum of P
+        MatrixXf mPX;                           // P times fixed points
+        float mNp;                              // Sum of all elements in P
         unsigned int mNumFixedPoints;           // N
         unsigned int mNumMovingPoints;          // M
         unsigned int mNumDimensions;            // D
         float mUniformWeight;                   // Weight of the uniform distribution
         double mTolerance;                      // Convergence criteria for EM iterations
+        float mTruncation;                      // Truncation distance in standard deviations, 0 means no truncation
+        bool mUseOpenCL;
+        KDTree mFixedTree;                      // Only built if truncation is enabled
         double mScale;                          // s
         double mVariance;                       // sigma^2
         double mObjectiveFunction;              // Q
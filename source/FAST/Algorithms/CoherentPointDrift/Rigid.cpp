@@ -21,30 +21,9 @@ namespace fast {
 
         mIterationError = mTolerance + 10.0;
         mObjectiveFunction = std::numeric_limits<double>::max();
-        mResponsibilityMatrix = MatrixXf::Zero(mNumMovingPoints, mNumFixedPoints);
-        mPt1 = VectorXf::Zero(mNumFixedPoints);
-        mP1 = VectorXf::Zero(mNumMovingPoints);
     }
 
     void CoherentPointDriftRigid::maximization(MatrixXf& fixedPoints, MatrixXf& movingPoints) {
-        // Calculate some useful matrix reductions
-        mP1 = VectorXf::Zero(mNumMovingPoints);
-        #pragma omp parallel for
-            for (int col = 0; col < mNumFixedPoints; ++col) {
-                mPt1(col) = mResponsibilityMatrix.col(col).sum();
-            }
-        #pragma omp parallel
-        {
-            VectorXf mP1Local = VectorXf::Zero(mNumMovingPoints);
-            #pragma omp for
-            for (int col = 0; col < mNumFixedPoints; ++col) {
-                mP1Local += mResponsibilityMatrix.col(col);
-            }
-            #pragma omp critical
-            mP1 += mP1Local;
-        }
-        mNp = mPt1.sum();                                           // 1 (sum of all P elements)
-
         // Estimate new mean vectors
         MatrixXf fixedMean = fixedPoints.transpose() * mPt1 / mNp;
         MatrixXf movingMean = movingPoints.transpose() * mP1 / mNp;
@@ -56,7 +35,8 @@ namespace fast {
 
 
         // Single value decomposition (SVD)
-        const MatrixXf A = fixedPointsCentered.transpose() * mResponsibilityMatrix.transpose() * movingPointsCentered;
+        // Xc^T * P^T * Yc expressed with the sums from the E-step
+        const MatrixXf A = mPX.transpose() * movingPoints - mNp * fixedMean * movingMean.transpose();
         auto svdU =  A.bdcSvd(Eigen::ComputeThinU);
         auto svdV =  A.bdcSvd(Eigen::ComputeThinV);
         const MatrixXf* U = &svdU.matrixU();
@@ -7,6 +7,7 @@
 #include "FAST/Visualization/TriangleRenderer/TriangleRenderer.hpp"
 #include "FAST/Algorithms/SurfaceExtraction/SurfaceExtraction.hpp"
 #include "FAST/Testing.hpp"
+#include "FAST/SceneGraph.hpp"
 #include "CoherentPointDrift.hpp"
 #include "Rigid.hpp"
 #include "Affine.hpp"
@@ -181,4 +182,34 @@ TEST_CASE("cpd", "[fast][coherentpointdrift][visual][cpd]") {
         window->start();
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("cpd truncated E-step gives same registration as exact E-step", "[fast][coherentpointdrift][cpd]") {
+    auto fixed = getPointCloud();
+    modifyPointCloud(fixed, 0.5);
+
+    Affine3f affine = Affine3f::Identity();
+    affine.rotate(Eigen::AngleAxisf(3.141592f / 180.0f * 10.0f, Eigen::Vector3f::UnitY()));
+    affine.translate(Vector3f(0.01f, 0.0f, -0.005f));
+
+    std::vector<Affine3f> results;
+    for(float truncation : {0.0f, 4.0f}) {
+        auto moving = getPointCloud();
+        modifyPointCloud(moving, 0.5);
+        auto transform = Transform::create();
+        transform->set(affine);
+        moving->getSceneGraphNode()->setTransform(transform);
+
+        auto cpd = CoherentPointDriftRigid::New();
+        cpd->setFixedMesh(fixed);
+        cpd->setMovingMesh(moving);
+        cpd->setMaximumIterations(50);
+        cpd->setTolerance(1e-4);
+        cpd->setTruncation(truncation);
+        auto output = cpd->updateAndGetOutputData<Mesh>();
+        results.push_back(SceneGraph::getEigenTransformFromData(output));
+    }
+
+    CHECK(results[0].matrix().isApprox(results[1].matrix(), 1e-2f));
+    CHECK_THROWS(CoherentPointDriftRigid::New()->setTruncation(-1.0f));
+}
@@ -45,7 +45,9 @@ void* JPEGCompression::decompress(uchar* compressedData, std::size_t bytes, int*
     return outputBuffer;
 }
 
-void JPEGCompression::compress(void *data, int width, int height, std::vector<uint8_t> *compressedData, int quality) {
+void JPEGCompression::compress(void *data, int width, int height, std::vector<uint8_t> *compressedData, int quality, int channels) {
+    if(channels != 1 && channels != 3)
+        throw Exception("JPEGCompression only supports 1 or 3 channels");
     jpeg_compress_struct cinfo;
     jpeg_error_mgr jerr;
 
@@ -60,8 +62,8 @@ void JPEGCompression::compress(void *data, int width, int height, std::vector<ui
     // Set parameters
     cinfo.image_width = width;
     cinfo.image_height = height;
-    cinfo.input_components = 3;
-    cinfo.in_color_space = JCS_RGB;
+    cinfo.input_components = channels;
+    cinfo.in_color_space = channels == 1 ? JCS_GRAYSCALE : JCS_RGB;
     jpeg_set_defaults(&cinfo);
     jpeg_set_quality(&cinfo, quality, TRUE);
     // Use 4:4:4 subsampling, default is 4:2:0
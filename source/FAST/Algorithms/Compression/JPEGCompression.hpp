@@ -7,12 +7,21 @@ namespace fast {
 /**
  * @brief Class for JPEG image compression
  *
- * Only supports 8 bit RGB images for now.
+ * Only supports 8 bit grayscale and RGB images for now.
  */
 class JPEGCompression {
 public:
     JPEGCompression();
-    void compress(void* data, int width, int height, std::vector<uint8_t>* compressedData, int quality = 90);
+    /**
+     * @brief Compress
+     * @param data 8 bit image data
+     * @param width
+     * @param height
+     * @param compressedData Vector to store the JPEG stream in
+     * @param quality JPEG quality 0-100
+     * @param channels Nr of channels, 1 (grayscale) or 3 (RGB)
+     */
+    void compress(void* data, int width, int height, std::vector<uint8_t>* compressedData, int quality = 90, int channels = 3);
     /**
      * @brief Decompress
      * @param compressedData
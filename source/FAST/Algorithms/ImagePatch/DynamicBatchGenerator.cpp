@@ -0,0 +1,174 @@
+#include "DynamicBatchGenerator.hpp"
+#include <FAST/Data/Image.hpp>
+#include <FAST/Algorithms/NeuralNetwork/NeuralNetwork.hpp>
+
+namespace fast {
+
+DynamicBatchGenerator::DynamicBatchGenerator() {
+    createInputPort<Image>(0, false);
+    createOutputPort<Batch>(0);
+
+    m_maxBatchSize = -1;
+    m_maxWaitTime = 10;
+    mIsModified = true;
+
+    createIntegerAttribute("max-batch-size", "Maximum batch size", "", m_maxBatchSize);
+    createIntegerAttribute("max-wait-time", "Maximum wait time", "Maximum time in milliseconds an image can wait for a batch to fill up", m_maxWaitTime);
+}
+
+DynamicBatchGenerator::DynamicBatchGenerator(int maxBatchSize, int maxWaitTime) : DynamicBatchGenerator() {
+    setMaxBatchSize(maxBatchSize);
+    setMaxWaitTime(maxWaitTime);
+}
+
+void DynamicBatchGenerator::loadAttributes() {
+    setMaxBatchSize(getIntegerAttribute("max-batch-size"));
+    setMaxWaitTime(getIntegerAttribute("max-wait-time"));
+}
+
+void DynamicBatchGenerator::readFrames() {
+    // Update will eventually block, therefore this is done in a separate thread from the one sending batches
+    auto po = mParent->getProcessObject();
+    bool firstTime = true;
+    bool lastFrame = false;
+    while(!lastFrame && !isStopped()) {
+        Image::pointer image;
+        try {
+            if(!firstTime) // parent is executed the first time, thus drop it here
+                po->update(); // Make sure execute is called on previous
+            firstTime = false;
+            image = mParent->getNextFrame<Image>();
+        } catch(ThreadStopped &e) {
+            break;
+        } catch(std::exception &e) {
+            std::lock_guard<std::mutex> lock(m_frameMutex);
+            m_readerError = "Error in DynamicBatchGenerator while reading frames: " + std::string(e.what());
+            break;
+        }
+        lastFrame = image->isLastFrame();
+        {
+            std::lock_guard<std::mutex> lock(m_frameMutex);
+            m_frames.push_back(std::make_pair(image, std::chrono::steady_clock::now()));
+        }
+        m_frameCondition.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        m_readerFinished = true;
+    }
+    m_frameCondition.notify_one();
+}
+
+void DynamicBatchGenerator::generateStream() {
+    bool lastFrame = false;
+    while(!lastFrame) {
+        std::vector<Image::pointer> imageList;
+        {
+            std::unique_lock<std::mutex> lock(m_frameMutex);
+            // Wait for the first image of the next batch
+            m_frameCondition.wait(lock, [this]() {
+                return !m_frames.empty() || m_readerFinished || isStopped();
+            });
+            if(m_frames.empty() || isStopped())
+                break;
+            // Wait until batch is full, or the deadline of the oldest image has passed
+            auto deadline = m_frames.front().second + std::chrono::milliseconds(m_maxWaitTime);
+            m_frameCondition.wait_until(lock, deadline, [this]() {
+                return m_frames.size() >= m_maxBatchSize || m_frames.back().first->isLastFrame() ||
+                    m_readerFinished || isStopped();
+            });
+            while(!m_frames.empty() && imageList.size() < m_maxBatchSize && !lastFrame) {
+                imageList.push_back(m_frames.front().first);
+                lastFrame = imageList.back()->isLastFrame();
+                m_frames.pop_front();
+            }
+        }
+        auto batch = Batch::create(imageList);
+        if(lastFrame)
+            batch->setLastFrame(getNameOfClass());
+        try {
+            addOutputData(0, batch);
+        } catch(ThreadStopped &e) {
+            break;
+        }
+        frameAdded();
+    }
+
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        error = m_readerError;
+    }
+    if(!error.empty()) {
+        // Exception happened in reader thread. Stop pipeline, and propagate error message.
+        reportError() << error << reportEnd();
+        for(auto item : mOutputConnections) {
+            for(auto output : item.second) {
+                output.lock()->stop(error);
+            }
+        }
+        frameAdded(); // To unlock if happens before first frame
+    }
+}
+
+void DynamicBatchGenerator::execute() {
+    if(m_maxBatchSize == -1)
+        throw Exception("Max batch size must be given to the DynamicBatchGenerator");
+
+    if(!m_streamIsStarted) {
+        m_streamIsStarted = true;
+        mParent = mInputConnections[0];
+        mInputConnections.clear();
+        m_readerFinished = false;
+        m_readerError.clear();
+        m_frames.clear();
+        m_readerThread = std::make_unique<std::thread>(std::bind(&DynamicBatchGenerator::readFrames, this));
+        m_thread = std::make_unique<std::thread>(std::bind(&DynamicBatchGenerator::generateStream, this));
+    }
+
+    waitForFirstFrame();
+    std::lock_guard<std::mutex> lock(m_frameMutex);
+    if(!m_readerError.empty() && m_readerFinished && m_frames.empty())
+        throw Exception(m_readerError);
+}
+
+void DynamicBatchGenerator::setMaxBatchSize(int size) {
+    if(size <= 0)
+        throw Exception("Max batch size must be larger than 0");
+    m_maxBatchSize = size;
+    mIsModified = true;
+}
+
+void DynamicBatchGenerator::setMaxWaitTime(int milliseconds) {
+    if(milliseconds < 0)
+        throw Exception("Max wait time must be >= 0");
+    m_maxWaitTime = milliseconds;
+    mIsModified = true;
+}
+
+void DynamicBatchGenerator::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stop = true;
+    }
+    bool readerFinished;
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        readerFinished = m_readerFinished;
+    }
+    m_frameCondition.notify_all();
+    if(m_readerThread) {
+        // Unblock the reader thread if it is waiting for the next frame
+        if(!readerFinished && mParent)
+            mParent->stop();
+        m_readerThread->join();
+        m_readerThread = nullptr;
+    }
+    Streamer::stop();
+}
+
+DynamicBatchGenerator::~DynamicBatchGenerator() {
+    stop();
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <FAST/ProcessObject.hpp>
+#include <FAST/Streamers/Streamer.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace fast {
+
+class Image;
+
+/**
+ * @brief Converts a stream of images into a stream of Batch data objects, limited by a latency budget
+ *
+ * Unlike ImageToBatchGenerator, which always waits for a full batch, this process object sends a batch
+ * when it reaches the maximum batch size or when the oldest image in the batch has waited longer than
+ * the maximum wait time, whichever comes first. Thus the batch size will vary.
+ * Each image in the batch keeps its frame data, which NeuralNetwork transfers to the corresponding output.
+ * Note that the inference engine must support dynamic batch sizes to use this with NeuralNetwork.
+ *
+ * @ingroup neural-network
+ */
+class FAST_EXPORT DynamicBatchGenerator : public Streamer {
+    FAST_PROCESS_OBJECT(DynamicBatchGenerator)
+    public:
+        /**
+         * @brief Create instance
+         * @param maxBatchSize Maximum batch size
+         * @param maxWaitTime Maximum time in milliseconds an image can wait for a batch to fill up
+         * @return instance
+         */
+        FAST_CONSTRUCTOR(DynamicBatchGenerator,
+                         int, maxBatchSize,,
+                         int, maxWaitTime, = 10
+        );
+        void setMaxBatchSize(int size);
+        /**
+         * @brief Set maximum time an image can wait for a batch to fill up
+         * @param milliseconds
+         */
+        void setMaxWaitTime(int milliseconds);
+        void stop() override;
+        ~DynamicBatchGenerator() override;
+        void loadAttributes() override;
+    protected:
+        void execute() override;
+        void generateStream() override;
+        void readFrames();
+        int m_maxBatchSize;
+        int m_maxWaitTime;
+
+        DataChannel::pointer mParent;
+        std::unique_ptr<std::thread> m_readerThread;
+        std::mutex m_frameMutex;
+        std::condition_variable m_frameCondition;
+        // Images which are not yet sent, and the time they arrived
+        std::deque<std::pair<std::shared_ptr<Image>, std::chrono::steady_clock::time_point>> m_frames;
+        bool m_readerFinished = false;
+        std::string m_readerError; // Set if the parent failed, the stream is then stopped with this error
+    private:
+        DynamicBatchGenerator();
+};
+
+}
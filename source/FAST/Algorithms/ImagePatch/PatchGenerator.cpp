@@ -1,7 +1,9 @@
 #include <FAST/Data/ImagePyramid.hpp>
 #include <FAST/Data/Image.hpp>
 #include <FAST/Algorithms/ImageResizer/ImageResizer.hpp>
+#include <FAST/ThreadPool.hpp>
 #include "PatchGenerator.hpp"
+#include <deque>
 
 namespace fast {
 
@@ -25,6 +27,8 @@ PatchGenerator::PatchGenerator() {
     createFloatAttribute("patch-overlap", "Patch overlap", "Patch overlap in percent", m_overlapPercent);
     createFloatAttribute("mask-threshold", "Mask threshold", "Threshold, in percent, for how much of the candidate patch must be inside the mask to be accepted", m_maskThreshold);
     createIntegerAttribute("padding-value", "Padding value", "Value to pad patches with when out-of-bounds. Default is negative, meaning it will use (white)255 for color images, and (black)0 for grayscale images", m_paddingValue);
+    createIntegerAttribute("threads", "Threads", "Number of worker threads used to read patches from image pyramids", m_threads);
+    createIntegerAttribute("prefetch", "Prefetch", "Maximum number of patches read ahead by the worker threads", m_prefetch);
 }
 
 PatchGenerator::PatchGenerator(int width, int height, int depth, int level, float magnification, float percent, float maskThreshold, int paddingValue) : PatchGenerator() {
@@ -51,6 +55,8 @@ void PatchGenerator::loadAttributes() {
     setMaskThreshold(getFloatAttribute("mask-threshold"));
     setPaddingValue(getIntegerAttribute("padding-value"));
     setPatchMagnification(getFloatAttribute("patch-magnification"));
+    setNumberOfThreads(getIntegerAttribute("threads"));
+    setPrefetchDepth(getIntegerAttribute("prefetch"));
 }
 
 PatchGenerator::~PatchGenerator() {
@@ -113,9 +119,90 @@ void PatchGenerator::generateStream() {
             const int patchesX = std::ceil((float) levelWidth / (float) (patchWidthWithoutOverlap*resampleFactor));
             const int patchesY = std::ceil((float) levelHeight / (float) (patchHeightWithoutOverlap*resampleFactor));
 
+            int paddingValue = m_paddingValue;
+            if(m_paddingValue < 0) {
+                if(m_inputImagePyramid->getNrOfChannels() > 1) {
+                    paddingValue = 255;
+                } else {
+                    paddingValue = 0;
+                }
+            }
+
+            // Reads, pads and resizes a single patch. Called from the worker threads if threads > 1.
+            auto createPatch = [=](int patchX, int patchY, int patchOffsetX, int patchOffsetY, int patchWidth, int patchHeight, float progress) {
+                reportInfo() << "Generating patch " << patchX << " " << patchY << reportEnd();
+                Image::pointer patch;
+                {
+                    auto access = m_inputImagePyramid->getAccess(ACCESS_READ);
+                    patch = access->getPatchAsImage(level,
+                                                    patchOffsetX,
+                                                    patchOffsetY,
+                                                    patchWidth,
+                                                    patchHeight);
+                }
+
+                // If patch does not have correct size, pad it
+                if(patch->getWidth() != (int)(m_width*resampleFactor) || patch->getHeight() != (int)(m_height*resampleFactor)) {
+                    // Edge cases, patches may not be the target patch size. Need to pad.
+                    patch = patch->crop(Vector2i(0, 0), Vector2i(m_width*resampleFactor, m_height*resampleFactor), true, paddingValue);
+                }
+                if(resampleFactor > 1.0f) {
+                    patch = ImageResizer::create(m_width, m_height, 1, m_inputImagePyramid->getNrOfChannels() > 1)->connect(patch)->runAndGetOutputData<Image>();
+                }
+                if(m_overlapPercent > 0.0f && (patchX == 0 || patchY == 0)) {
+                    int offsetX = patchX == 0 ? -overlapInPixelsX : 0;
+                    int offsetY = patchY == 0 ? -overlapInPixelsY : 0;
+                    patch = patch->crop(Vector2i(offsetX, offsetY), Vector2i(m_width, m_height), true, paddingValue);
+                }
+
+                // Store some frame data useful for patch stitching
+                patch->setFrameData("original-width", std::to_string(round(levelWidth/resampleFactor)));
+                patch->setFrameData("original-height", std::to_string(round(levelHeight/resampleFactor)));
+                patch->setFrameData("patchid-x", std::to_string(patchX));
+                patch->setFrameData("patchid-y", std::to_string(patchY));
+                // Target width/height of patches
+                patch->setFrameData("patch-width", std::to_string(m_width));
+                patch->setFrameData("patch-height", std::to_string(m_height));
+                patch->setFrameData("patch-overlap-x", std::to_string(overlapInPixelsX));
+                patch->setFrameData("patch-overlap-y", std::to_string(overlapInPixelsY));
+                // Image patch spacing of a WSI can be very small, and std::to_string can round the numbers,
+                // and there is no way to set the precision, so we use a custom function instead.
+                patch->setFrameData("patch-spacing-x", to_string_with_precision(patch->getSpacing().x(), 32));
+                patch->setFrameData("patch-spacing-y", to_string_with_precision(patch->getSpacing().y(), 32));
+                patch->setFrameData("patch-level", std::to_string(level));
+                patch->setFrameData("progress", std::to_string(progress));
+                return std::make_pair(patch, progress);
+            };
+
+            // Sends the previous patch downstream, and keeps the current one so that the last patch can be marked.
+            // Returns false if the stream was stopped.
+            bool stopped = false;
+            auto emitPatch = [&](std::pair<Image::pointer, float> patch) {
+                try {
+                    if(previousPatch) {
+                        addOutputData(0, previousPatch, false, false);
+                        frameAdded();
+                    }
+                } catch(ThreadStopped &e) {
+                    std::unique_lock<std::mutex> lock(m_stopMutex);
+                    m_stop = true;
+                    return false;
+                }
+                m_progress = patch.second;
+                previousPatch = patch.first;
+                std::unique_lock<std::mutex> lock(m_stopMutex);
+                return !m_stop;
+            };
+
+            // Worker pool. Decoding with a neural network model is not thread-safe, thus use a single thread then.
+            std::unique_ptr<ThreadPool> pool;
+            std::deque<std::future<std::pair<Image::pointer, float>>> pendingPatches;
+            const std::size_t prefetch = std::max(m_prefetch, m_threads);
+            if(m_threads > 1 && m_inputImagePyramid->getCompression() != ImageCompression::NEURAL_NETWORK)
+                pool = std::make_unique<ThreadPool>(m_threads);
+
             for(int patchY = 0; patchY < patchesY; ++patchY) {
                 for(int patchX = 0; patchX < patchesX; ++patchX) {
-                    mRuntimeManager->startRegularTimer("create patch");
                     int patchWidth = m_width*resampleFactor;
                     if(patchWidth + (patchX*patchWidthWithoutOverlap - overlapInPixelsX)*resampleFactor >= levelWidth) {
                         patchWidth = levelWidth - (patchX * patchWidthWithoutOverlap - overlapInPixelsX)*resampleFactor;
@@ -159,79 +246,44 @@ void PatchGenerator::generateStream() {
                             continue;
                         }
                     }
-                    reportInfo() << "Generating patch " << patchX << " " << patchY << reportEnd();
-                    auto access = m_inputImagePyramid->getAccess(ACCESS_READ);
                     if(patchWidth < overlapInPixelsX*2 || patchHeight < overlapInPixelsY*2)
                         continue;
-                    auto patch = access->getPatchAsImage(level,
-                                                         patchOffsetX,
-                                                         patchOffsetY,
-                                                         patchWidth,
-                                                         patchHeight);
-
-                    // If patch does not have correct size, pad it
-                    int paddingValue = m_paddingValue;
-                    if(m_paddingValue < 0) {
-                        if(m_inputImagePyramid->getNrOfChannels() > 1) {
-                            paddingValue = 255;
-                        } else {
-                            paddingValue = 0;
-                        }
-                    }
-                    if(patch->getWidth() != (int)(m_width*resampleFactor) || patch->getHeight() != (int)(m_height*resampleFactor)) {
-                        // Edge cases, patches may not be the target patch size. Need to pad.
-                        patch = patch->crop(Vector2i(0, 0), Vector2i(m_width*resampleFactor, m_height*resampleFactor), true, paddingValue);
-                    }
-                    if(resampleFactor > 1.0f) {
-                        patch = ImageResizer::create(m_width, m_height, 1, m_inputImagePyramid->getNrOfChannels() > 1)->connect(patch)->runAndGetOutputData<Image>();
-                    }
-                    if(m_overlapPercent > 0.0f && (patchX == 0 || patchY == 0)) {
-                        int offsetX = patchX == 0 ? -overlapInPixelsX : 0;
-                        int offsetY = patchY == 0 ? -overlapInPixelsY : 0;
-                        patch = patch->crop(Vector2i(offsetX, offsetY), Vector2i(m_width, m_height), true, paddingValue);
-                    }
-
-                    // Store some frame data useful for patch stitching
-                    patch->setFrameData("original-width", std::to_string(round(levelWidth/resampleFactor)));
-                    patch->setFrameData("original-height", std::to_string(round(levelHeight/resampleFactor)));
-                    patch->setFrameData("patchid-x", std::to_string(patchX));
-                    patch->setFrameData("patchid-y", std::to_string(patchY));
-                    // Target width/height of patches
-                    patch->setFrameData("patch-width", std::to_string(m_width));
-                    patch->setFrameData("patch-height", std::to_string(m_height));
-                    patch->setFrameData("patch-overlap-x", std::to_string(overlapInPixelsX));
-                    patch->setFrameData("patch-overlap-y", std::to_string(overlapInPixelsY));
-                    // Image patch spacing of a WSI can be very small, and std::to_string can round the numbers,
-                    // and there is no way to set the precision, so we use a custom function instead.
-                    patch->setFrameData("patch-spacing-x", to_string_with_precision(patch->getSpacing().x(), 32));
-                    patch->setFrameData("patch-spacing-y", to_string_with_precision(patch->getSpacing().y(), 32));
-                    patch->setFrameData("patch-level", std::to_string(level));
-                    m_progress = (float)(patchX+patchY*patchesX)/(patchesX*patchesY);
-                    patch->setFrameData("progress", std::to_string(m_progress));
-
-                    mRuntimeManager->stopRegularTimer("create patch");
-                    try {
-                        if(previousPatch) {
-                            addOutputData(0, previousPatch, false, false);
-                            frameAdded();
+                    const float progress = (float)(patchX+patchY*patchesX)/(patchesX*patchesY);
+                    if(pool) {
+                        // Wait for the oldest patch if the prefetch queue is full. This keeps the output order deterministic.
+                        while(pendingPatches.size() >= prefetch && !stopped) {
+                            mRuntimeManager->startRegularTimer("create patch");
+                            auto patch = pendingPatches.front().get();
+                            pendingPatches.pop_front();
+                            mRuntimeManager->stopRegularTimer("create patch");
+                            stopped = !emitPatch(patch);
                         }
-                    } catch(ThreadStopped &e) {
-                        std::unique_lock<std::mutex> lock(m_stopMutex);
-                        m_stop = true;
-                        break;
+                        if(stopped)
+                            break;
+                        pendingPatches.push_back(pool->submit([=]() {
+                            return createPatch(patchX, patchY, patchOffsetX, patchOffsetY, patchWidth, patchHeight, progress);
+                        }));
+                    } else {
+                        mRuntimeManager->startRegularTimer("create patch");
+                        auto patch = createPatch(patchX, patchY, patchOffsetX, patchOffsetY, patchWidth, patchHeight, progress);
+                        mRuntimeManager->stopRegularTimer("create patch");
+                        stopped = !emitPatch(patch);
+                        if(stopped)
+                            break;
                     }
-                    previousPatch = patch;
-                    std::unique_lock<std::mutex> lock(m_stopMutex);
-                    if(m_stop)
-                        break;
                 }
-                std::unique_lock<std::mutex> lock(m_stopMutex);
-                if(m_stop) {
+                if(stopped) {
                     //m_streamIsStarted = false;
                     m_firstFrameIsInserted = false;
                     break;
                 }
             }
+            // Emit remaining prefetched patches in order
+            while(!pendingPatches.empty() && !stopped) {
+                auto patch = pendingPatches.front().get();
+                pendingPatches.pop_front();
+                stopped = !emitPatch(patch);
+            }
         } else if(m_inputVolume) { // Could be 3D or 2D
             const int width = m_inputVolume->getWidth();
             const int height = m_inputVolume->getHeight();
@@ -391,6 +443,20 @@ void PatchGenerator::setPatchMagnification(float magnification) {
     setModified(true);
 }
 
+void PatchGenerator::setNumberOfThreads(int threads) {
+    if(threads < 1)
+        throw Exception("Number of threads in PatchGenerator must be >= 1");
+    m_threads = threads;
+    setModified(true);
+}
+
+void PatchGenerator::setPrefetchDepth(int patches) {
+    if(patches < 1)
+        throw Exception("Prefetch depth in PatchGenerator must be >= 1");
+    m_prefetch = patches;
+    setModified(true);
+}
+
 float PatchGenerator::getProgress() {
     return m_progress;
 }
@@ -17,6 +17,10 @@ class Image;
  * The result of the processed patches can be stitched together again to form a full
  * ImagePyramid/3D Image/Tensor by using the PatchStitcher.
  *
+ * For ImagePyramid inputs, patches can be read and padded by a pool of worker threads,
+ * see setNumberOfThreads and setPrefetchDepth. Patches are always emitted in the same
+ * order as in single-threaded mode.
+ *
  * @ingroup wsi
  * @sa PatchStitcher
  */
@@ -61,6 +65,24 @@ class FAST_EXPORT PatchGenerator : public Streamer {
         void setPatchMagnification(float magnification);
         void setMaskThreshold(float percent);
         void setPaddingValue(int paddingValue);
+        /**
+         * @brief Set number of worker threads used to read patches from an ImagePyramid
+         *
+         * If larger than 1, patches are read from the ImagePyramid and padded in parallel.
+         * The output order of patches is the same as with one thread.
+         * Only used for ImagePyramid inputs.
+         *
+         * @param threads Number of threads. Default is 1.
+         */
+        void setNumberOfThreads(int threads);
+        /**
+         * @brief Set maximum number of patches to read ahead when using multiple threads
+         *
+         * The prefetch depth is always at least the number of threads.
+         *
+         * @param patches Number of patches. Default is 8.
+         */
+        void setPrefetchDepth(int patches);
         ~PatchGenerator();
         void loadAttributes() override;
         /**
@@ -75,6 +97,8 @@ class FAST_EXPORT PatchGenerator : public Streamer {
         int m_paddingValue = -1;
         float m_magnification = -1;
         float m_progress = 0.0f;
+        int m_threads = 1;
+        int m_prefetch = 8;
 
         std::shared_ptr<ImagePyramid> m_inputImagePyramid;
         std::shared_ptr<Image> m_inputVolume;
@@ -4,6 +4,8 @@
 #include <FAST/Algorithms/NeuralNetwork/NeuralNetwork.hpp>
 #include <FAST/Algorithms/ImageResizer/ImageResizer.hpp>
 #include "PatchStitcher.hpp"
+#include <algorithm>
+#include <thread>
 
 namespace fast {
 
@@ -14,12 +16,17 @@ PatchStitcher::PatchStitcher(bool patchesAreCropped, bool forceImagePyramidOutpu
     createOpenCLProgram(Config::getKernelSourcePath() + "/Algorithms/ImagePatch/PatchStitcher2D.cl", "2D");
     createOpenCLProgram(Config::getKernelSourcePath() + "/Algorithms/ImagePatch/PatchStitcher3D.cl", "3D");
     createBooleanAttribute("patches-are-cropped", "Patches are cropped", "Indicate whether incomming patches are already cropped or not.", false);
+    createBooleanAttribute("deferred-pyramid-construction", "Deferred pyramid construction", "Build lower resolution levels of image pyramid output after the last patch.", false);
+    m_tileEncodingThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    createIntegerAttribute("tile-encoding-threads", "Tile encoding threads", "Number of threads used to compress tiles of an image pyramid output. 0 means compress synchronously while stitching.", m_tileEncodingThreads);
     setPatchesAreCropped(patchesAreCropped);
     setForceImagePyramidOutput(forceImagePyramidOutput);
 }
 
 void PatchStitcher::loadAttributes() {
     setPatchesAreCropped(getBooleanAttribute("patches-are-cropped"));
+    setDeferredPyramidConstruction(getBooleanAttribute("deferred-pyramid-construction"));
+    setTileEncodingThreads(getIntegerAttribute("tile-encoding-threads"));
 }
 
 void PatchStitcher::execute() {
@@ -48,6 +55,12 @@ void PatchStitcher::execute() {
     }
     mRuntimeManager->stopRegularTimer("stitch patch");
 
+    if(m_outputImagePyramid && m_deferredPyramidConstruction && patch->isLastFrame()) {
+        mRuntimeManager->startRegularTimer("construct pyramid");
+        m_outputImagePyramid->getAccess(ACCESS_READ_WRITE)->finalize();
+        mRuntimeManager->stopRegularTimer("construct pyramid");
+    }
+
     if(m_outputImage) {
         addOutputData(0, m_outputImage);
     } else if(m_outputTensor) {
@@ -131,6 +144,8 @@ void PatchStitcher::processImage(std::shared_ptr<Image> patch) {
                 int patchWidth = std::stoi(patch->getFrameData("patch-width")) - 2*std::stoi(patch->getFrameData("patch-overlap-x"));
                 int patchHeight = std::stoi(patch->getFrameData("patch-height")) - 2*std::stoi(patch->getFrameData("patch-overlap-y"));
                 m_outputImagePyramid = ImagePyramid::create(fullWidth, fullHeight, patch->getNrOfChannels(), patchWidth, patchHeight);
+                m_outputImagePyramid->setDeferredLevelConstruction(m_deferredPyramidConstruction);
+                m_outputImagePyramid->setTileEncodingThreads(m_tileEncodingThreads);
                 reportInfo() << "Patch stitcher creating image PYRAMID with size " << fullWidth << " " << fullHeight << ", patch size: " <<
                     patchWidth << " " << patchHeight << " Levels: " << m_outputImagePyramid->getNrOfLevels() << reportEnd();
             }
@@ -317,5 +332,25 @@ bool PatchStitcher::getForceImagePyramidOutput() const {
     return m_forceImagePyramidOutput;
 }
 
+void PatchStitcher::setDeferredPyramidConstruction(bool deferred) {
+    m_deferredPyramidConstruction = deferred;
+    setModified(true);
+}
+
+bool PatchStitcher::getDeferredPyramidConstruction() const {
+    return m_deferredPyramidConstruction;
+}
+
+void PatchStitcher::setTileEncodingThreads(int threads) {
+    if(threads < 0)
+        throw Exception("Number of tile encoding threads must be >= 0");
+    m_tileEncodingThreads = threads;
+    setModified(true);
+}
+
+int PatchStitcher::getTileEncodingThreads() const {
+    return m_tileEncodingThreads;
+}
+
 
 }
\ No newline at end of file
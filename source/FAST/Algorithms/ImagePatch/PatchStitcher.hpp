@@ -55,6 +55,29 @@ class FAST_EXPORT PatchStitcher : public ProcessObject {
          * @return
          */
         bool getForceImagePyramidOutput() const;
+        /**
+         * @brief Build the lower resolution levels of an image pyramid output after the last patch
+         *
+         * By default, every stitched patch is propagated to all lower resolution levels of the output image pyramid,
+         * so that the entire pyramid can be rendered while stitching.
+         * With deferred pyramid construction only the full resolution level is written while stitching, and
+         * the other levels are built in one parallel pass when the last patch has been stitched.
+         * This is much faster for large images.
+         *
+         * @param deferred
+         */
+        void setDeferredPyramidConstruction(bool deferred);
+        bool getDeferredPyramidConstruction() const;
+        /**
+         * @brief Set number of threads used to compress tiles of an image pyramid output
+         *
+         * Default is the number of hardware threads.
+         *
+         * @param threads Number of threads. If 0, tiles are compressed synchronously while stitching.
+         * @sa ImagePyramid::setTileEncodingThreads
+         */
+        void setTileEncodingThreads(int threads);
+        int getTileEncodingThreads() const;
     protected:
         void execute() override;
 
@@ -67,6 +90,8 @@ class FAST_EXPORT PatchStitcher : public ProcessObject {
     private:
         bool m_patchesAreCropped = false;
         bool m_forceImagePyramidOutput = false;
+        bool m_deferredPyramidConstruction = false;
+        int m_tileEncodingThreads;
 
 };
 
@@ -8,6 +8,8 @@
 #include <FAST/Algorithms/ImagePatch/PatchGenerator.hpp>
 #include <FAST/Algorithms/ImagePatch/PatchStitcher.hpp>
 #include <FAST/Algorithms/ImagePatch/ImageToBatchGenerator.hpp>
+#include <FAST/Algorithms/ImagePatch/DynamicBatchGenerator.hpp>
+#include <FAST/Streamers/ImageFileStreamer.hpp>
 #include <FAST/Algorithms/NeuralNetwork/NeuralNetwork.hpp>
 #include <FAST/Importers/ImageFileImporter.hpp>
 #include <FAST/Visualization/VolumeRenderer/AlphaBlendingVolumeRenderer.hpp>
@@ -39,6 +41,33 @@ TEST_CASE("Patch generator for WSI", "[fast][wsi][PatchGenerator]") {
     REQUIRE(nrOfPatches == counter);
 }
 
+TEST_CASE("Patch generator for WSI with multiple threads", "[fast][wsi][PatchGenerator]") {
+    auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
+    auto wsi = importer->runAndGetOutputData<ImagePyramid>();
+
+    const int level = 2;
+    const int width = 512;
+    const int height = 256;
+    auto generator = PatchGenerator::create(width, height, 1, level)
+            ->connect(wsi);
+    generator->setNumberOfThreads(4);
+    generator->setPrefetchDepth(16);
+    auto stream = DataStream(generator);
+    const int patchesX = std::ceil((float)wsi->getLevelWidth(level)/width);
+    const int patchesY = std::ceil((float)wsi->getLevelHeight(level)/height);
+    int counter = 0;
+    while(!stream.isDone()) {
+        auto image = stream.getNextFrame<Image>();
+        REQUIRE(image->getWidth() == width);
+        REQUIRE(image->getHeight() == height);
+        // Patches should arrive in the same order as with a single thread
+        CHECK(std::stoi(image->getFrameData("patchid-x")) == counter % patchesX);
+        CHECK(std::stoi(image->getFrameData("patchid-y")) == counter / patchesX);
+        ++counter;
+    }
+    REQUIRE(patchesX*patchesY == counter);
+}
+
 TEST_CASE("Patch generator on 2D image", "[fast][PatchGenerator]") {
     auto importer = ImageFileImporter::create(Config::getTestDataPath() + "/US/US-2D.jpg");
     auto image = importer->runAndGetOutputData<Image>();
@@ -167,6 +196,55 @@ TEST_CASE("Patch generator, sticher and image to batch generator for WSI", "[fas
     std::cout << "Done" << std::endl;
 }
 
+TEST_CASE("Dynamic batch generator for WSI keeps all patches in order", "[fast][wsi][DynamicBatchGenerator]") {
+    auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
+
+    std::vector<std::string> expectedPatches;
+    {
+        auto generator = PatchGenerator::create(512, 512, 1, 2)
+                ->connect(importer);
+        auto stream = DataStream(generator);
+        while(!stream.isDone()) {
+            auto patch = stream.getNextFrame<Image>();
+            expectedPatches.push_back(patch->getFrameData("patchid-x") + "_" + patch->getFrameData("patchid-y"));
+        }
+    }
+
+    auto generator = PatchGenerator::create(512, 512, 1, 2)
+            ->connect(importer);
+    auto batchGenerator = DynamicBatchGenerator::create(4, 5)
+            ->connect(generator);
+
+    std::vector<std::string> patches;
+    auto stream = DataStream(batchGenerator);
+    while(!stream.isDone()) {
+        auto batch = stream.getNextFrame<Batch>();
+        auto images = batch->get().getImages();
+        REQUIRE(images.size() >= 1);
+        CHECK(images.size() <= 4);
+        for(auto&& image : images)
+            patches.push_back(image->getFrameData("patchid-x") + "_" + image->getFrameData("patchid-y"));
+    }
+    CHECK(patches == expectedPatches);
+}
+
+TEST_CASE("Dynamic batch generator sends batch when max wait time is reached", "[fast][DynamicBatchGenerator]") {
+    // Frames arrive every 100 ms, thus every batch should be sent before it is full
+    auto streamer = ImageFileStreamer::create(Config::getTestDataPath() + "US/JugularVein/US-2D_#.mhd", false, false, 10);
+    streamer->setMaximumNumberOfFrames(5);
+    auto batchGenerator = DynamicBatchGenerator::create(8, 10)
+            ->connect(streamer);
+
+    int frames = 0;
+    auto stream = DataStream(batchGenerator);
+    while(!stream.isDone()) {
+        auto batch = stream.getNextFrame<Batch>();
+        CHECK(batch->get().getSize() < 8);
+        frames += batch->get().getSize();
+    }
+    CHECK(frames == 5);
+}
+
 /*
 TEST_CASE("Patch generator for WSI wrong magnification", "[fast][wsi][PatchGenerator]") {
     auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
@@ -1,5 +1,6 @@
 #include "FAST/Algorithms/IterativeClosestPoint/IterativeClosestPoint.hpp"
 #include "FAST/SceneGraph.hpp"
+#include "FAST/KDTree.hpp"
 #undef min
 #undef max
 #include <limits>
@@ -9,13 +10,14 @@
 namespace fast {
 
 IterativeClosestPoint::IterativeClosestPoint(TransformationType type, int maxIterations, float minErrorChange,
-                                                 float distanceThreshold, int randomSamplingPoints) {
+                                                 float distanceThreshold, int randomSamplingPoints, bool useKDTree) {
     createInputPort(0, "Mesh", "Fixed mesh");
     createInputPort(1, "Mesh", "Moving mesh");
     setMaximumNrOfIterations(maxIterations);
     setMinimumErrorChange(minErrorChange);
     setDistanceThreshold(distanceThreshold);
     setRandomPointSampling(randomSamplingPoints);
+    setUseKDTree(useKDTree);
     mError = -1;
     mTransformationType = IterativeClosestPoint::RIGID;
     mIsModified = true;
@@ -109,6 +111,31 @@ inline MatrixXf rearrangeMatrixToClosestPoints(const MatrixXf& A, const MatrixXf
 
 }
 
+/**
+ * Create a 6xN matrix of the features used to find closest points: The position, and the weighted YIQ color.
+ * Euclidean distance between these features is the same distance as used by rearrangeMatrixToClosestPoints.
+ */
+inline MatrixXf getClosestPointFeatures(const MatrixXf& points, const MatrixXf& colors) {
+    Vector3f colorWeights(100.0, 1000.0, 1000.0);
+    MatrixXf features(6, points.cols());
+    for(int i = 0; i < points.cols(); ++i) {
+        features.col(i).head(3) = points.col(i);
+        features.col(i).tail(3) = RGB2YIQ(colors.col(i)).cwiseProduct(colorWeights);
+    }
+    return features;
+}
+
+/**
+ * Same as rearrangeMatrixToClosestPoints, but uses a k-d tree of the features of A
+ */
+inline MatrixXf rearrangeMatrixToClosestPoints(const MatrixXf& A, const KDTree& tree, const MatrixXf& Bfeatures) {
+    MatrixXf result(A.rows(), Bfeatures.cols());
+    const std::vector<int> closestPoints = tree.findNearest(Bfeatures);
+    for(int b = 0; b < Bfeatures.cols(); ++b)
+        result.col(b) = A.col(closestPoints[b]);
+    return result;
+}
+
 /*
  * Get centroid
  */
@@ -245,12 +272,27 @@ void IterativeClosestPoint::execute() {
 
     float colorWeight = 1.0f;
 
+    // The fixed points do not change, thus the k-d tree is only built once
+    KDTree fixedTree;
+    MatrixXf movingFeatures;
+    if(mUseKDTree) {
+        fixedTree.build(getClosestPointFeatures(fixedPoints, fixedColors));
+        movingFeatures = getClosestPointFeatures(movingPoints, movingColors);
+    }
+    auto findClosestPoints = [&](const MatrixXf& movedPoints) {
+        if(mUseKDTree) {
+            movingFeatures.topRows(3) = movedPoints;
+            return rearrangeMatrixToClosestPoints(fixedPoints, fixedTree, movingFeatures);
+        } else {
+            return rearrangeMatrixToClosestPoints(fixedPoints, movedPoints, fixedColors, movingColors, colorWeight);
+        }
+    };
+
     // Want to choose the smallest one as moving
     bool invertTransform = false;
 	MatrixXf movedPoints = currentTransformation*(movingPoints.colwise().homogeneous());
     // Match closest points using current transformation
-    MatrixXf rearrangedFixedPoints = rearrangeMatrixToClosestPoints(
-            fixedPoints, movedPoints, fixedColors, movingColors, colorWeight);
+    MatrixXf rearrangedFixedPoints = findClosestPoints(movedPoints);
     do {
         previousError = error;        
 
@@ -301,8 +343,7 @@ void IterativeClosestPoint::execute() {
         // Calculate RMS error
         // Should we rearrange the points here?
         mRuntimeManager->startRegularTimer("find_closest");
-        rearrangedFixedPoints = rearrangeMatrixToClosestPoints(
-                fixedPoints, movedPoints, fixedColors, movingColors, colorWeight);
+        rearrangedFixedPoints = findClosestPoints(movedPoints);
         mRuntimeManager->stopRegularTimer("find_closest");
 		MatrixXf distance = rearrangedFixedPoints - movedPoints;
         error = 0;
@@ -344,4 +385,9 @@ void IterativeClosestPoint::setMinimumErrorChange(float errorChange) {
     mMinErrorChange = errorChange;
 }
 
+void IterativeClosestPoint::setUseKDTree(bool useKDTree) {
+    mUseKDTree = useKDTree;
+    mIsModified = true;
+}
+
 }
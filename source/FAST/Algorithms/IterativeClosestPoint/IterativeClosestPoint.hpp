@@ -22,6 +22,7 @@ class FAST_EXPORT  IterativeClosestPoint : public ProcessObject {
          * @param minErrorChange Stopping criterion. If change in error is less than this number for an iteration, ICP will stop.
          * @param distanceThreshold If specified, do not accept points that are further away than this threshold.
          * @param randomSamplingPoints If specified, ICP will sample this many points at random to match instead of all points.
+         * @param useKDTree Find closest points using a k-d tree built over the fixed points, instead of brute force.
          * @return instance
          */
         FAST_CONSTRUCTOR(IterativeClosestPoint,
@@ -29,7 +30,8 @@ class FAST_EXPORT  IterativeClosestPoint : public ProcessObject {
                          int, maxIterations, = 100,
                          float, minErrorChange, = 1e-5,
                          float, distanceThreshold, = -1,
-                         int, randomSamplingPoints, = 0
+                         int, randomSamplingPoints, = 0,
+                         bool, useKDTree, = true
         )
         FAST_CONNECT(IterativeClosestPoint, Fixed, 0);
         FAST_CONNECT(IterativeClosestPoint, Moving, 1);
@@ -44,6 +46,13 @@ class FAST_EXPORT  IterativeClosestPoint : public ProcessObject {
         void setMaximumNrOfIterations(uint iterations);
         void setRandomPointSampling(uint nrOfPointsToSample);
         void setDistanceThreshold(float distance);
+        /**
+         * @brief Set whether to find closest points using a k-d tree.
+         * The k-d tree is built once over the fixed points, and queried in parallel. This gives the same result as
+         * the brute force search, but is much faster for large meshes.
+         * @param useKDTree
+         */
+        void setUseKDTree(bool useKDTree);
     private:
         void execute();
 
@@ -51,6 +60,7 @@ class FAST_EXPORT  IterativeClosestPoint : public ProcessObject {
         uint mMaxIterations;
         int mRandomSamplingPoints;
         float mDistanceThreshold;
+        bool mUseKDTree;
         float mError;
         Transform::pointer mTransformation;
         IterativeClosestPoint::TransformationType mTransformationType;
@@ -160,6 +160,21 @@ TEST_CASE("ICP on two point sets which are already transformed by scene graph",
     CHECK(detectedRotation.z() == Approx(rotation.z()).scale(1.0));
 }
 
+TEST_CASE("ICP with k-d tree gives same result as brute force", "[fast][IterativeClosestPoint][icp]") {
+    auto A = VTKMeshFileImporter::create(Config::getTestDataPath() + "Surface_LV.vtk")->runAndGetOutputData<Mesh>();
+    auto B = VTKMeshFileImporter::create(Config::getTestDataPath() + "Surface_LV.vtk")->runAndGetOutputData<Mesh>();
+    Affine3f transform = Affine3f::Identity();
+    transform.translate(Vector3f(0.01, 0.0, 0.01));
+    transform.rotate(Eigen::AngleAxisf(0.1, Vector3f::UnitX()));
+    B->getSceneGraphNode()->setTransform(transform);
 
+    auto icp = IterativeClosestPoint::create(IterativeClosestPoint::RIGID, 100, 1e-5, -1, 0, false)->connectFixed(B)->connectMoving(A);
+    icp->run();
+    auto icpKDTree = IterativeClosestPoint::create(IterativeClosestPoint::RIGID, 100, 1e-5, -1, 0, true)->connectFixed(B)->connectMoving(A);
+    icpKDTree->run();
+
+    CHECK(icpKDTree->getError() == Approx(icp->getError()));
+    CHECK(icpKDTree->getOutputTransformation()->get().matrix().isApprox(icp->getOutputTransformation()->get().matrix(), 1e-4));
+}
 
 } // end namespace fast
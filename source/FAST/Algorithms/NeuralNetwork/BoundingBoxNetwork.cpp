@@ -53,6 +53,8 @@ BoundingBoxNetwork::BoundingBoxNetwork(std::string modelFilename, float scaleFac
 
 void BoundingBoxNetwork::execute() {
     runNeuralNetwork();
+    if(m_processedOutputData.empty()) // Pipelined inference is filling up, no output yet
+        return;
 
     mRuntimeManager->startRegularTimer("output_processing");
     m_tensorToBoundingBoxSet->setNrOfInputNodes(m_processedOutputData.size());
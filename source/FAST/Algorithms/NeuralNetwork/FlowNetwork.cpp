@@ -26,6 +26,8 @@ FlowNetwork::FlowNetwork(std::string modelFilename, float scaleFactor, float mea
 void FlowNetwork::execute() {
     // Prepare input node: Should be two images in a sequence
     runNeuralNetwork();
+    if(m_processedOutputData.empty()) // Pipelined inference is filling up, no output yet
+        return;
 
     auto tensor = std::dynamic_pointer_cast<Tensor>(m_processedOutputData[0]);
     if(!tensor)
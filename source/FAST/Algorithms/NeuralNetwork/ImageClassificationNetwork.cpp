@@ -38,6 +38,8 @@ void ImageClassificationNetwork::setLabels(std::vector<std::string> labels) {
 void ImageClassificationNetwork::execute() {
 
     runNeuralNetwork();
+    if(m_processedOutputData.empty()) // Pipelined inference is filling up, no output yet
+        return;
 
     // TODO batch support
     auto tensor = std::dynamic_pointer_cast<Tensor>(m_processedOutputData[0]);
@@ -22,6 +22,28 @@ bool InferenceEngine::isLoaded() const {
 
 void InferenceEngine::setIsLoaded(bool loaded) {
     m_isLoaded = loaded;
+    if(loaded) {
+        m_modelOutputShapes.clear();
+        for(auto&& node : mOutputNodes)
+            m_modelOutputShapes[node.first] = node.second.shape;
+    }
+}
+
+TensorShape InferenceEngine::getOutputShapeForBatchSize(const std::string& name, int batchSize) const {
+    if(m_modelOutputShapes.count(name) == 0)
+        return TensorShape();
+    auto shape = m_modelOutputShapes.at(name);
+    if(shape.empty())
+        return TensorShape();
+    // First dimension is assumed to be the batch dimension only if it is unknown
+    if(shape[0] < 0) {
+        shape[0] = batchSize;
+    } else if(shape[0] != batchSize) {
+        return TensorShape();
+    }
+    if(shape.getUnknownDimensions() > 0)
+        return TensorShape();
+    return shape;
 }
 
 void InferenceEngine::addInputNode(NeuralNetworkNode node) {
@@ -186,6 +186,16 @@ class FAST_EXPORT InferenceEngine : public Object {
         static ImageOrdering detectImageOrdering(const TensorShape& shape, bool hasBatchDim = true);
     protected:
         virtual void setIsLoaded(bool loaded);
+        /**
+         * @brief Get the shape of an output node for a given batch size, before running the network
+         *
+         * This can be used to allocate output buffers which the engine can write directly to.
+         *
+         * @param name Name of output node
+         * @param batchSize
+         * @return shape, or an empty shape if it can't be determined before running the network
+         */
+        TensorShape getOutputShapeForBatchSize(const std::string& name, int batchSize) const;
 
         std::map<std::string, NeuralNetworkNode> mInputNodes;
         std::map<std::string, NeuralNetworkNode> mOutputNodes;
@@ -197,6 +207,8 @@ class FAST_EXPORT InferenceEngine : public Object {
         std::vector<uint8_t> m_model;
         std::vector<uint8_t> m_weights;
         ImageOrdering m_imageOrdering;
+        // Output shapes when the model was loaded, as the shape of the output nodes are replaced after each run
+        std::map<std::string, TensorShape> m_modelOutputShapes;
     private:
         std::string m_filename = "";
         bool m_isLoaded = false;
@@ -8,6 +8,7 @@
 #endif
 
 #include <FAST/Config.hpp>
+#include <FAST/Utility.hpp>
 
 namespace fast {
 
@@ -23,40 +24,56 @@ std::string print_shape(const std::vector<int64_t>& v) {
 
 void ONNXRuntimeEngine::run() {
 	//auto start = std::chrono::high_resolution_clock::now();
-    std::vector<const char*> inputNames;
-    std::vector<Ort::Value> inputTensors;
-	// Important to use reference here, as we are using c_str() which does not copy string, and will be deleted if std::string is deleted.
-    for (const auto& inputNode : mInputNodes) {
+    Ort::MemoryInfo info = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeCPU); // Must be TypeCPU to work on CPU
+    m_ioBinding->ClearBoundInputs();
+    m_ioBinding->ClearBoundOutputs();
+
+    // Bind input data directly, no copy. The accesses must be kept until the run is finished.
+    std::vector<TensorAccess::pointer> inputAccesses;
+    int batchSize = 1;
+    for(const auto& inputNode : mInputNodes) {
         auto tensor = inputNode.second.data;
         auto access = tensor->getAccess(ACCESS_READ);
-		inputNames.push_back(strdup(inputNode.first.c_str()));
-        float* tensorData = access->getRawData();
-        reportInfo() << "ONNXRuntime: Creating memory info.." << reportEnd();
-        Ort::MemoryInfo info = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeCPU); // Must be TypeCPU to work on CPU
         auto shape = tensor->getShape();
+        batchSize = shape[0];
 
         std::vector<int64_t> dims;
-        for (int x : shape.getAll())
+        for(int x : shape.getAll())
             dims.push_back(x);
-        inputTensors.emplace_back(Ort::Value::CreateTensor<float>(info, tensorData, shape.getTotalSize(), dims.data(), shape.getDimensions()));
+        auto value = Ort::Value::CreateTensor<float>(info, access->getRawData(), shape.getTotalSize(), dims.data(), shape.getDimensions());
+        m_ioBinding->BindInput(inputNode.first.c_str(), value);
+        inputAccesses.push_back(std::move(access));
     }
-    std::vector<const char*> outputNames;
-	// Important to use reference here, as we are using c_str() which does not copy string, and will be deleted if std::string is deleted.
-    for (const auto& outputNode : mOutputNodes) {
-        outputNames.push_back(outputNode.first.c_str());
+
+    // Bind outputs to new buffers which are given to the FAST output tensors, thus the output is not copied.
+    // If the output shape is not known before running, ONNX Runtime allocates the output instead.
+    std::map<std::string, std::unique_ptr<float[]>> outputBuffers;
+    for(const auto& outputNode : mOutputNodes) {
+        auto shape = getOutputShapeForBatchSize(outputNode.first, batchSize);
+        if(shape.empty()) {
+            m_ioBinding->BindOutput(outputNode.first.c_str(), info);
+        } else {
+            auto buffer = make_uninitialized_unique<float[]>(shape.getTotalSize());
+            std::vector<int64_t> dims;
+            for(int x : shape.getAll())
+                dims.push_back(x);
+            auto value = Ort::Value::CreateTensor<float>(info, buffer.get(), shape.getTotalSize(), dims.data(), shape.getDimensions());
+            m_ioBinding->BindOutput(outputNode.first.c_str(), value);
+            outputBuffers[outputNode.first] = std::move(buffer);
+        }
     }
-		
+
     Ort::RunOptions runOptions;
     reportInfo() << "Running ONNX runtime .." << reportEnd();
-    std::vector<Ort::Value> output = m_session->Run(runOptions, inputNames.data(), inputTensors.data(), inputNames.size(), outputNames.data(), outputNames.size());
+    m_session->Run(runOptions, *m_ioBinding);
     reportInfo() << "Finished run ONNX runtime" << reportEnd();
     //std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
     //std::cout << "Run: " << duration.count() << std::endl;
 
-    // Copy output data to FAST
+    // Output values are in the same order as they were bound
+    std::vector<Ort::Value> output = m_ioBinding->GetOutputValues();
     int counter = 0;
     for(auto& outputNode : mOutputNodes) {
-        const float* data = output[counter].GetTensorData<float>();
         // Get shape of output tensor
         auto shape = TensorShape();
         for(int x : output[counter].GetTensorTypeAndShapeInfo().GetShape()) {
@@ -64,8 +81,12 @@ void ONNXRuntimeEngine::run() {
         }
         const auto name = outputNode.first;
         outputNode.second.shape = shape;
-        auto outputTensor = Tensor::create(data, shape);
-        outputNode.second.data = outputTensor;
+        if(outputBuffers.count(name) > 0) {
+            outputNode.second.data = Tensor::create(std::move(outputBuffers[name]), shape);
+        } else {
+            // Copy output data to FAST
+            outputNode.second.data = Tensor::create(output[counter].GetTensorData<float>(), shape);
+        }
         ++counter;
     }
 }
@@ -75,6 +96,7 @@ void ONNXRuntimeEngine::load() {
     std::wstring wideStr(filename.begin(), filename.end());
 
 	reportInfo() << "Setting up ONNX Runtime" << reportEnd();
+	m_ioBinding.reset();
     //auto start = std::chrono::high_resolution_clock::now();
 	m_env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "ONNXRuntime");
     if(m_deviceType == InferenceDeviceType::CPU) {
@@ -120,6 +142,7 @@ void ONNXRuntimeEngine::load() {
     }
 	Ort::AllocatorWithDefaultOptions allocator;
 	reportInfo() << "ONNXRuntime Session created" << reportEnd();
+	m_ioBinding = std::make_unique<Ort::IoBinding>(*m_session);
 
     //std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
     //std::cout << "Setup: " << duration.count() << std::endl;
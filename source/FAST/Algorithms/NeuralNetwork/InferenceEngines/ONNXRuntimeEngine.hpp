@@ -6,6 +6,7 @@
 namespace Ort {
 	class Session;
 	class Env;
+	class IoBinding;
 	namespace detail {
 		class AllocatedFree;
 	}
@@ -46,6 +47,8 @@ public:
 private:
 	std::unique_ptr<Ort::Session> m_session;
 	std::unique_ptr<Ort::Env> m_env;
+	// Persistent binding of input and output buffers, must be destroyed before the session
+	std::unique_ptr<Ort::IoBinding> m_ioBinding;
 };
 
 DEFINE_INFERENCE_ENGINE(ONNXRuntimeEngine, INFERENCEENGINEONNXRUNTIME_EXPORT)
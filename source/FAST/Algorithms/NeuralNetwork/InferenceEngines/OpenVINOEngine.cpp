@@ -10,24 +10,51 @@ public:
 };
 
 
+static ov::Shape toOpenVINOShape(const TensorShape& shape) {
+    ov::Shape result;
+    for(int x : shape.getAll())
+        result.push_back(x);
+    return result;
+}
+
 void OpenVINOEngine::run() {
     std::lock_guard<std::mutex> lock(m_mutex);
 
-    // Copy input data
+    // Set input data, no copy. The accesses must be kept until inference is finished.
     reportInfo() << "OpenVINO processing input nodes." << reportEnd();
+    std::vector<TensorAccess::pointer> inputAccesses;
+    int batchSize = 1;
     for(auto inputNode : mInputNodes) {
         const auto index = m_inputIndices[inputNode.first];
         auto tensor = inputNode.second.data;
         auto access = tensor->getAccess(ACCESS_READ);
         float* tensorData = access->getRawData();
-        ov::Shape shape;
-        for(int x : tensor->getShape().getAll()) {
-            shape.push_back(x);
-        }
-        m_infer->request.set_input_tensor(index, ov::Tensor(ov::element::f32, shape, tensorData));
+        batchSize = tensor->getShape()[0];
+        m_infer->request.set_input_tensor(index, ov::Tensor(ov::element::f32, toOpenVINOShape(tensor->getShape()), tensorData));
+        inputAccesses.push_back(std::move(access));
     }
     reportInfo() << "OpenVINO input data added." << reportEnd();
 
+    // Set outputs to new buffers which are given to the FAST output tensors, thus the output is not copied.
+    std::map<std::string, std::unique_ptr<float[]>> outputBuffers;
+    std::set<std::string> boundOutputNodes;
+    for(auto& outputNode : mOutputNodes) {
+        const auto index = m_outputIndices[outputNode.first];
+        auto shape = getOutputShapeForBatchSize(outputNode.first, batchSize);
+        if(shape.empty()) {
+            // Output shape not known before inference. If the previous output was set to a buffer now owned by a
+            // FAST tensor, replace it so that OpenVINO doesn't write to it.
+            if(m_boundOutputNodes.count(outputNode.first) > 0)
+                m_infer->request.set_output_tensor(index, ov::Tensor(ov::element::f32, toOpenVINOShape(outputNode.second.shape)));
+            continue;
+        }
+        auto buffer = make_uninitialized_unique<float[]>(shape.getTotalSize());
+        m_infer->request.set_output_tensor(index, ov::Tensor(ov::element::f32, toOpenVINOShape(shape), buffer.get()));
+        outputBuffers[outputNode.first] = std::move(buffer);
+        boundOutputNodes.insert(outputNode.first);
+    }
+    m_boundOutputNodes = boundOutputNodes;
+
     // Run inference
     m_infer->request.infer();
     reportInfo() << "OpenVINO inference done." << reportEnd();
@@ -45,8 +72,11 @@ void OpenVINOEngine::run() {
         }
         const auto name = outputNode.first;
         outputNode.second.shape = shape;
-        auto outputTensor = Tensor::create(data, shape);
-        outputNode.second.data = outputTensor;
+        if(outputBuffers.count(name) > 0 && data == outputBuffers[name].get()) {
+            outputNode.second.data = Tensor::create(std::move(outputBuffers[name]), shape);
+        } else {
+            outputNode.second.data = Tensor::create(data, shape);
+        }
     }
     reportInfo() << "OpenVINO processing output nodes done." << reportEnd();
 }
@@ -2,6 +2,7 @@
 
 #include <FAST/Algorithms/NeuralNetwork/InferenceEngine.hpp>
 #include <OpenVINOExport.hpp>
+#include <set>
 
 namespace InferenceEngine {
 class InferRequest;
@@ -59,6 +60,8 @@ class INFERENCEENGINEOPENVINO_EXPORT OpenVINOEngine : public InferenceEngine {
 
         std::map<std::string, int> m_inputIndices;
         std::map<std::string, int> m_outputIndices;
+        // Output nodes which was set to a buffer owned by a FAST tensor in the last run
+        std::set<std::string> m_boundOutputNodes;
 };
 
 DEFINE_INFERENCE_ENGINE(OpenVINOEngine, INFERENCEENGINEOPENVINO_EXPORT)
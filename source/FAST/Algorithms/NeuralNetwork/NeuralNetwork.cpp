@@ -3,6 +3,7 @@
 #include "FAST/Data/Tensor.hpp"
 #include "FAST/Algorithms/ImageResizer/ImageResizer.hpp"
 #include "InferenceEngineManager.hpp"
+#include <cstring>
 
 
 namespace fast {
@@ -63,6 +64,7 @@ void NeuralNetwork::loadAttributes() {
     setScaleFactor(getFloatAttribute("scale-factor"));
     setSignedInputNormalization(getBooleanAttribute("signed-input-normalization"));
     setPreserveAspectRatio(getBooleanAttribute("preserve-aspect"));
+    setPipelineDepth(getIntegerAttribute("pipeline-depth"));
 
     // Load network here so that input and output nodes are readily defined after loadAttributes()
 	load(getStringAttribute("model"));
@@ -134,6 +136,7 @@ NeuralNetwork::NeuralNetwork() {
 	createStringAttribute("output-nodes", "Output node names, and shapes", "Example: input_node_1:256,256,1  input_node2:1", "");
 	createBooleanAttribute("signed-input-normalization", "Signed input normalization", "Normalize input to -1 and 1 instead of 0 to 1.", false);
     createBooleanAttribute("preserve-aspect", "Preserve aspect ratio of input images", "", mPreserveAspectRatio);
+    createIntegerAttribute("pipeline-depth", "Pipeline depth", "Max number of frames in flight. If > 1, preprocessing, inference and postprocessing of consecutive frames are overlapped.", m_pipelineDepth);
     createStringAttribute("dimension-ordering", "Dimension ordering", "Dimension ordering (channel-last or channel-first), will override auto detecting if set.", "");
 
 	m_engine = InferenceEngineManager::loadBestAvailableEngine();
@@ -372,12 +375,103 @@ Tensor::pointer NeuralNetwork::standardizeOutputTensorData(Tensor::pointer tenso
     return tensor;
 }
 
+/**
+ * State of one inference run in pipelined mode
+ */
+struct NeuralNetwork::PipelineJob {
+    std::unordered_map<std::string, std::vector<std::shared_ptr<Image>>> inputImages;
+    std::unordered_map<std::string, std::vector<std::shared_ptr<Tensor>>> inputTensors;
+    Vector3f newInputSpacing;
+    Vector3i newInputSize;
+    int batchSize;
+    std::unordered_map<std::string, std::string> frameData;
+    std::unordered_set<std::string> lastFrame;
+    std::future<std::map<std::string, Tensor::pointer>> outputTensors;
+};
+
+void NeuralNetwork::addPipelineJob() {
+    auto inputTensors = processInputData();
+
+    // Store state needed for processing the output of this job later
+    auto job = std::make_shared<PipelineJob>();
+    job->inputImages = mInputImages;
+    job->inputTensors = mInputTensors;
+    job->newInputSpacing = mNewInputSpacing;
+    job->newInputSize = m_newInputSize;
+    job->batchSize = m_batchSize;
+    job->frameData = m_frameData;
+    job->lastFrame = m_lastFrame;
+    for(auto&& input : mLastProcessed) {
+        if(input.second.first->isLastFrame())
+            m_pipelineInputFinished = true;
+    }
+
+    // All engine calls are done in the same thread, thus the engine input/output is not shared between jobs
+    job->outputTensors = m_inferenceThread->submit([this, inputTensors]() {
+        for(const auto &node : m_engine->getInputNodes())
+            m_engine->setInputData(node.first, inputTensors.at(node.first));
+        m_engine->run();
+        std::map<std::string, Tensor::pointer> outputTensors;
+        for(const auto &node : m_engine->getOutputNodes())
+            outputTensors[node.first] = m_engine->getOutputData(node.first);
+        return outputTensors;
+    });
+    m_pipelineJobs.push_back(job);
+}
+
+void NeuralNetwork::runPipelinedNeuralNetwork() {
+    if(!m_temporalStateLinks.empty())
+        throw Exception("Temporal states are not supported with pipelined inference in NeuralNetwork");
+    if(!m_inferenceThread)
+        m_inferenceThread = std::make_unique<ThreadPool>(1);
+
+    // One input is added to the pipeline per execute, until the last frame has been received
+    if(!m_pipelineInputFinished)
+        addPipelineJob();
+    // When streaming, the output is delayed by the pipeline depth, thus no output is added until the pipeline is full
+    if(!m_pipelineInputFinished && m_pipelineJobs.size() < m_pipelineDepth && hasStreamerParent()) {
+        m_processedOutputData.clear();
+        return;
+    }
+
+    auto job = m_pipelineJobs.front();
+    m_pipelineJobs.pop_front();
+    mRuntimeManager->startRegularTimer("inference");
+    auto outputTensors = job->outputTensors.get();
+    mRuntimeManager->stopRegularTimer("inference");
+
+    // Restore state of this job, so that output and frame data match the input of this job
+    mInputImages = job->inputImages;
+    mInputTensors = job->inputTensors;
+    mNewInputSpacing = job->newInputSpacing;
+    m_newInputSize = job->newInputSize;
+    m_batchSize = job->batchSize;
+    m_frameData = job->frameData;
+    m_lastFrame = job->lastFrame;
+    processOutputTensors(outputTensors);
+
+    if(m_pipelineInputFinished) {
+        if(m_pipelineJobs.empty()) {
+            m_pipelineInputFinished = false;
+        } else {
+            // Only one output can be added per execute. Thus mark this PO as modified, so that the remaining
+            // jobs are flushed one by one on the next updates, without any new input.
+            setModified(true);
+        }
+    }
+}
+
 void NeuralNetwork::runNeuralNetwork() {
     // TODO move load and input processing to execute? or a separate function?
     // Check if network is loaded, if not do it
     if(!m_engine->isLoaded())
         m_engine->load();
 
+    if(m_pipelineDepth > 1) {
+        runPipelinedNeuralNetwork();
+        return;
+    }
+
     // Prepare input data
 	auto inputTensors = processInputData();
 	// Give input tensors to inference engine
@@ -394,12 +488,19 @@ void NeuralNetwork::runNeuralNetwork() {
 }
 
 void NeuralNetwork::processOutputTensors() {
+    std::map<std::string, Tensor::pointer> outputTensors;
+    for(const auto &node : m_engine->getOutputNodes())
+        outputTensors[node.first] = m_engine->getOutputData(node.first);
+    processOutputTensors(outputTensors);
+}
+
+void NeuralNetwork::processOutputTensors(std::map<std::string, Tensor::pointer> outputTensors) {
     mRuntimeManager->startRegularTimer("output_processing");
     // Collect output data of network and add to output ports
     for(const auto &node : m_engine->getOutputNodes()) {
         // TODO if input was a batch, the output should be converted to a batch as well
         // TODO and any frame data (such as patch info should be transferred)
-        auto tensor = m_engine->getOutputData(node.first);
+        auto tensor = outputTensors.at(node.first);
 
         if(m_temporalStateNodes.count(node.first) > 0) {
             m_temporalStateNodes[node.first] = tensor;
@@ -407,10 +508,8 @@ void NeuralNetwork::processOutputTensors() {
         }
 
         if(m_batchSize > 1) {
-            // Create a batch of tensors
+            // Create a batch of tensors, each a view of the output tensor to avoid copying
             std::vector<Tensor::pointer> tensorList;
-            auto tensorAccess = tensor->getAccess(ACCESS_READ);
-            const float* rawTensorData = tensorAccess->getRawData();
             // Calculate sample size
             auto shape = tensor->getShape();
             int size = 1;
@@ -421,9 +520,7 @@ void NeuralNetwork::processOutputTensors() {
             }
 
             for(int i = 0; i < m_batchSize; ++i) {
-                auto newData = make_uninitialized_unique<float[]>(size);
-                std::memcpy(newData.get(), &(rawTensorData[i*size]), size*sizeof(float));
-                auto newTensor = Tensor::create(std::move(newData), newShape);
+                Tensor::pointer newTensor = TensorView::create(tensor, (std::size_t)i*size, newShape);
                 newTensor = standardizeOutputTensorData(newTensor, i);
                 tensorList.push_back(newTensor);
             }
@@ -499,6 +596,10 @@ Tensor::pointer NeuralNetwork::convertImagesToTensor(std::vector<Image::pointer>
     }
     cl::Kernel kernel(program, kernelName.c_str());
     const std::size_t size = width*height*depth*channels; // nr of elements per image
+    auto& stagingBuffers = getStagingBuffers(device, images.size(), sizeof(float) * size);
+    auto queue = device->getCommandQueue();
+    // Keep image accesses alive until all kernels have finished
+    std::vector<OpenCLImageAccess::pointer> accesses;
     for(int i = 0; i < images.size(); ++i) {
         auto image = images[i];
         if(image->getWidth() != width ||
@@ -512,12 +613,7 @@ Tensor::pointer NeuralNetwork::convertImagesToTensor(std::vector<Image::pointer>
             throw Exception("Input image sent to executeNetwork has incorrect nr of channels: " +
                     std::to_string(image->getNrOfChannels())+ ". Expected: " + std::to_string(channels) + ".");
         OpenCLImageAccess::pointer access = image->getOpenCLImageAccess(ACCESS_READ, device);
-        cl::Buffer buffer(
-                device->getContext(),
-                CL_MEM_WRITE_ONLY,
-                sizeof(float) * size
-        );
-        kernel.setArg(1, buffer);
+        kernel.setArg(1, stagingBuffers[i]);
         kernel.setArg(2, mScaleFactor);
         kernel.setArg(3, mMean);
         kernel.setArg(4, mStd);
@@ -537,22 +633,52 @@ Tensor::pointer NeuralNetwork::convertImagesToTensor(std::vector<Image::pointer>
             globalSize = cl::NDRange(width, height, depth);
         }
 
-        device->getCommandQueue().enqueueNDRangeKernel(
+        queue.enqueueNDRangeKernel(
                 kernel,
                 cl::NullRange,
                 globalSize,
                 cl::NullRange
         );
 
-        // Read data directly into slice
-        device->getCommandQueue().enqueueReadBuffer(buffer, CL_TRUE, 0, sizeof(float) * size,
-                                                    values.get() + i*size);
+        accesses.push_back(access);
+    }
+    // Map the pinned staging buffers after the kernels have written to them (a kernel may not write to a mapped
+    // buffer), and copy through the mapped pointers. Mapping is non-blocking, synchronization is done once for the
+    // entire batch.
+    std::vector<void*> mappedBuffers;
+    for(int i = 0; i < images.size(); ++i) {
+        mappedBuffers.push_back(queue.enqueueMapBuffer(stagingBuffers[i], CL_FALSE, CL_MAP_READ, 0, sizeof(float) * size));
+    }
+    queue.finish();
+    // No need to wait for the unmaps: the queue is in-order, thus they complete before the staging buffers are
+    // written to by the kernels of the next batch.
+    for(int i = 0; i < images.size(); ++i) {
+        std::memcpy(values.get() + i*size, mappedBuffers[i], sizeof(float) * size);
+        queue.enqueueUnmapMemObject(stagingBuffers[i], mappedBuffers[i]);
     }
 
     auto tensor = Tensor::create(std::move(values), shape);
     return tensor;
 }
 
+std::vector<cl::Buffer>& NeuralNetwork::getStagingBuffers(OpenCLDevice::pointer device, int count, std::size_t bytes) {
+    if(device != m_stagingBufferDevice || bytes != m_stagingBufferSize) {
+        m_stagingBuffers.clear();
+        m_stagingBufferDevice = device;
+        m_stagingBufferSize = bytes;
+    }
+    // Pinned (host accessible) memory which is mapped in convertImagesToTensor, this avoids an extra device to
+    // host copy on most platforms
+    while(m_stagingBuffers.size() < count) {
+        m_stagingBuffers.push_back(cl::Buffer(
+                device->getContext(),
+                CL_MEM_WRITE_ONLY | CL_MEM_ALLOC_HOST_PTR,
+                bytes
+        ));
+    }
+    return m_stagingBuffers;
+}
+
 std::vector<std::shared_ptr<Image>> NeuralNetwork::resizeImages(const std::vector<std::shared_ptr<Image>> &images, int width, int height, int depth) {
     m_newInputSize = Vector3i(width, height, depth);
     mRuntimeManager->startRegularTimer("image input resize");
@@ -592,7 +718,21 @@ void NeuralNetwork::setSignedInputNormalization(bool signedInputNormalization) {
 	mSignedInputNormalization = signedInputNormalization;
 }
 
+void NeuralNetwork::setPipelineDepth(int depth) {
+    if(depth < 1)
+        throw Exception("Pipeline depth in NeuralNetwork must be >= 1");
+    m_pipelineDepth = depth;
+    setModified(true);
+}
+
+int NeuralNetwork::getPipelineDepth() const {
+    return m_pipelineDepth;
+}
+
 NeuralNetwork::~NeuralNetwork() {
+    // Make sure no inference is running when the engine is destroyed
+    m_pipelineJobs.clear();
+    m_inferenceThread.reset();
 }
 
 void NeuralNetwork::setInputNode(NeuralNetworkNode node) {
@@ -4,6 +4,8 @@
 #include <FAST/Data/Tensor.hpp>
 #include <FAST/Data/SimpleDataObject.hpp>
 #include "InferenceEngine.hpp"
+#include <FAST/ThreadPool.hpp>
+#include <deque>
 
 namespace fast {
 
@@ -242,6 +244,22 @@ class FAST_EXPORT NeuralNetwork : public ProcessObject {
 
         virtual void setInputSize(std::string name, std::vector<int> size);
 
+        /**
+         * @brief Set the number of inference runs which can be in flight at the same time
+         *
+         * If depth > 1, inference is pipelined: While the inference engine runs on one frame in a separate thread,
+         * the next frames are preprocessed, and the output of the previous frame is post-processed and
+         * passed on in the pipeline. Output order and frame data are preserved, but the output is delayed
+         * with depth-1 frames: One input frame is consumed per execute, and no output is added until the pipeline
+         * is full. After the last frame, the remaining frames are output one per update.
+         * Pipelining is only done when the input comes from a streamer, and it
+         * is not supported together with temporal states. Default is 1, which disables pipelining.
+         *
+         * @param depth Max number of frames in flight
+         */
+        void setPipelineDepth(int depth);
+        int getPipelineDepth() const;
+
         void loadAttributes();
 
         virtual ~NeuralNetwork();
@@ -261,17 +279,39 @@ class FAST_EXPORT NeuralNetwork : public ProcessObject {
 
         virtual void runNeuralNetwork();
 
+        int m_pipelineDepth = 1;
+        struct PipelineJob;
+        std::deque<std::shared_ptr<PipelineJob>> m_pipelineJobs;
+        std::unique_ptr<ThreadPool> m_inferenceThread;
+        bool m_pipelineInputFinished = false;
+        void runPipelinedNeuralNetwork();
+        void addPipelineJob();
+
         std::shared_ptr<InferenceEngine> m_engine;
 
         std::unordered_map<std::string, std::vector<std::shared_ptr<Image>>> mInputImages;
         std::unordered_map<std::string, std::vector<std::shared_ptr<Tensor>>> mInputTensors;
 
+        std::vector<cl::Buffer> m_stagingBuffers;
+        std::size_t m_stagingBufferSize = 0;
+        OpenCLDevice::pointer m_stagingBufferDevice;
+
         std::map<std::string, Tensor::pointer> m_temporalStateNodes;
         std::vector<std::pair<std::string, std::string>> m_temporalStateLinks;
 
         std::unordered_map<std::string, Tensor::pointer> processInputData();
         std::vector<std::shared_ptr<Image>> resizeImages(const std::vector<std::shared_ptr<Image>>& images, int width, int height, int depth);
         Tensor::pointer convertImagesToTensor(std::vector<std::shared_ptr<Image>> image, const TensorShape& shape, bool temporal);
+        /**
+         * Get persistent staging buffers used by convertImagesToTensor, one per image in the batch.
+         * The buffers are allocated in host accessible memory and mapped to read the result, they are reused between
+         * executions, and only reallocated if the device or input size changes.
+         * @param device
+         * @param count Nr of buffers needed
+         * @param bytes Size in bytes of each buffer
+         * @return staging buffers
+         */
+        std::vector<cl::Buffer>& getStagingBuffers(OpenCLDevice::pointer device, int count, std::size_t bytes);
 
         /**
          * Converts a tensor to channel last image ordering and takes care of frame data and spacing
@@ -281,6 +321,7 @@ class FAST_EXPORT NeuralNetwork : public ProcessObject {
         Tensor::pointer standardizeOutputTensorData(Tensor::pointer tensor, int sample = 0);
 
         void processOutputTensors();
+        void processOutputTensors(std::map<std::string, Tensor::pointer> outputTensors);
     private:
         void execute();
 
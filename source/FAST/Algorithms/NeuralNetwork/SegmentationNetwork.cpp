@@ -74,6 +74,8 @@ void SegmentationNetwork::setResizeBackToOriginalSize(bool resize) {
 
 void SegmentationNetwork::execute() {
     runNeuralNetwork();
+    if(m_processedOutputData.empty()) // Pipelined inference is filling up, no output yet
+        return;
 
     auto data = m_processedOutputData[0];
     if(mHeatmapOutput) {
@@ -13,6 +13,7 @@
 #include <FAST/Algorithms/SurfaceExtraction/SurfaceExtraction.hpp>
 #include <FAST/Algorithms/GaussianSmoothing/GaussianSmoothing.hpp>
 #include <FAST/Streamers/ImageFileStreamer.hpp>
+#include <FAST/DataStream.hpp>
 #include <FAST/Visualization/HeatmapRenderer/HeatmapRenderer.hpp>
 #include <FAST/Visualization/Widgets/PlaybackWidget/PlaybackWidget.hpp>
 
@@ -322,6 +323,56 @@ TEST_CASE("Execute NN on batch of 2D images", "[fast][neuralnetwork][batch]") {
     }
 }
 
+class StagingBufferTestNetwork : public NeuralNetwork {
+    public:
+        static std::shared_ptr<StagingBufferTestNetwork> create() {
+            return std::shared_ptr<StagingBufferTestNetwork>(new StagingBufferTestNetwork());
+        }
+        using NeuralNetwork::convertImagesToTensor;
+        using NeuralNetwork::m_stagingBuffers;
+        using NeuralNetwork::m_engine;
+};
+
+TEST_CASE("NN: staging buffers are reused when converting images to tensor", "[fast][neuralnetwork]") {
+    const int width = 64;
+    const int height = 32;
+    auto network = StagingBufferTestNetwork::create();
+    // Single channel input, thus memory layout is the same for channel first and channel last
+    TensorShape shape({2, height, width, 1});
+    if(network->m_engine->getPreferredImageOrdering() == ImageOrdering::ChannelFirst)
+        shape = TensorShape({2, 1, height, width});
+
+    std::vector<cl_mem> previousBuffers;
+    for(int run = 0; run < 2; ++run) {
+        std::vector<Image::pointer> images;
+        std::vector<std::vector<float>> expected;
+        for(int i = 0; i < 2; ++i) {
+            std::vector<float> data(width*height);
+            for(int j = 0; j < width*height; ++j)
+                data[j] = (float)(j % 100) + i*1000.0f + run*10000.0f;
+            images.push_back(Image::create(width, height, TYPE_FLOAT, 1, data.data()));
+            expected.push_back(data);
+        }
+
+        auto tensor = network->convertImagesToTensor(images, shape, false);
+        auto access = tensor->getAccess(ACCESS_READ);
+        const float* values = access->getRawData();
+        for(int i = 0; i < 2; ++i) {
+            for(int j = 0; j < width*height; ++j) {
+                REQUIRE(values[i*width*height + j] == Approx(expected[i][j]));
+            }
+        }
+
+        REQUIRE(network->m_stagingBuffers.size() == 2);
+        std::vector<cl_mem> buffers;
+        for(auto& buffer : network->m_stagingBuffers)
+            buffers.push_back(buffer());
+        if(run > 0)
+            CHECK(buffers == previousBuffers);
+        previousBuffers = buffers;
+    }
+}
+
 TEST_CASE("NN: temporal input static output", "[fast][neuralnetwork][sequence]") {
     for(auto&& engine : InferenceEngineManager::getEngineList()) {
         std::vector<Image::pointer> images;
@@ -435,6 +486,44 @@ TEST_CASE("NN: temporal input temporal output, streaming mode", "[fast][neuralne
     }
 }
 
+TEST_CASE("Pipelined NN inference gives same output as sequential inference", "[fast][neuralnetwork][pipeline]") {
+    for(auto&& engine : InferenceEngineManager::getEngineList()) {
+        std::vector<std::vector<Tensor::pointer>> results;
+        for(int depth : {1, 3}) {
+            auto streamer = ImageFileStreamer::create(Config::getTestDataPath() + "US/JugularVein/US-2D_#.mhd", false, false);
+            streamer->setMaximumNumberOfFrames(10);
+
+            auto network = NeuralNetwork::New();
+            network->setInferenceEngine(engine);
+            network->load(join(Config::getTestDataPath(),
+                               "NeuralNetworkModels/jugular_vein_segmentation." +
+                               getModelFileExtension(network->getInferenceEngine()->getPreferredModelFormat())));
+            network->setScaleFactor(1.0f / 255.0f);
+            network->setPipelineDepth(depth);
+            network->setInputConnection(streamer->getOutputPort());
+
+            std::vector<Tensor::pointer> tensors;
+            auto stream = DataStream(network);
+            while(!stream.isDone())
+                tensors.push_back(stream.getNextFrame<Tensor>());
+            results.push_back(tensors);
+        }
+        REQUIRE(results[0].size() == 10);
+        REQUIRE(results[1].size() == results[0].size());
+        for(int i = 0; i < results[0].size(); ++i) {
+            // Only the final output should be marked as the last frame
+            CHECK(results[1][i]->isLastFrame() == (i == results[0].size() - 1));
+            auto access1 = results[0][i]->getAccess(ACCESS_READ);
+            auto access2 = results[1][i]->getAccess(ACCESS_READ);
+            REQUIRE(access1->getShape().getTotalSize() == access2->getShape().getTotalSize());
+            const float* data1 = access1->getRawData();
+            const float* data2 = access2->getRawData();
+            for(int j = 0; j < access1->getShape().getTotalSize(); ++j)
+                CHECK(data1[j] == Approx(data2[j]));
+        }
+    }
+}
+
 /*
 TEST_CASE("Dynamic input shapes", "[fast][dynamicshapes]") {
     auto network = NeuralNetwork::create("/home/smistad/workspace/adapt-ai-tuning/models/unet-adapt-rspace-full-res-ssim-1.5-dynamic.onnx",
@@ -1,74 +1,215 @@
 #include "NonMaximumSuppression.hpp"
 #include <FAST/Data/BoundingBox.hpp>
-#include <queue>
+#include <FAST/Data/BoundingBoxSpatialIndex.hpp>
+#include <FAST/ThreadPool.hpp>
+#include <algorithm>
 
 namespace fast {
 
-NonMaximumSuppression::NonMaximumSuppression(float threshold) {
+NonMaximumSuppression::NonMaximumSuppression(float threshold, bool perClass, bool mergePatches, int threads) {
 	createInputPort<BoundingBoxSet>(0);
 	createOutputPort<BoundingBoxSet>(0);
     setThreshold(threshold);
+    setPerClass(perClass);
+    setMergePatches(mergePatches);
+    setNumberOfThreads(threads);
 	createFloatAttribute("threshold", "Threshold", "Threshold", m_threshold);
+	createBooleanAttribute("per-class", "Per class", "Only suppress boxes with the same label", m_perClass);
+	createBooleanAttribute("merge-patches", "Merge patches", "Merge a stream of patch bounding box sets into one set", m_mergePatches);
+	createIntegerAttribute("threads", "Threads", "Number of threads to use. 0 means use all hardware threads.", m_threads);
 }
 
 void NonMaximumSuppression::loadAttributes() {
 	setThreshold(getFloatAttribute("threshold"));
+	setPerClass(getBooleanAttribute("per-class"));
+	setMergePatches(getBooleanAttribute("merge-patches"));
+	setNumberOfThreads(getIntegerAttribute("threads"));
 }
 
 void NonMaximumSuppression::setThreshold(float threshold) {
 	m_threshold = threshold;
+	setModified(true);
+}
+
+void NonMaximumSuppression::setPerClass(bool perClass) {
+	m_perClass = perClass;
+	setModified(true);
+}
+
+void NonMaximumSuppression::setMergePatches(bool mergePatches) {
+	m_mergePatches = mergePatches;
+	m_pendingPatches.clear();
+	m_mergedBoxes.reset();
+	setModified(true);
+}
+
+void NonMaximumSuppression::setNumberOfThreads(int threads) {
+	if(threads < 0)
+		throw Exception("Number of threads in NonMaximumSuppression must be >= 0");
+	m_threads = threads;
+	m_pool.reset();
+	setModified(true);
+}
+
+NonMaximumSuppression::~NonMaximumSuppression() = default;
+
+static float intersectionOverUnion(const Vector2f& min1, const Vector2f& max1, const Vector2f& min2, const Vector2f& max2) {
+	const Vector2f intersectionMin = min1.cwiseMax(min2);
+	const Vector2f intersectionMax = max1.cwiseMin(max2);
+	if(intersectionMax.x() < intersectionMin.x() || intersectionMax.y() < intersectionMin.y()) // There is no overlap
+		return 0.0f;
+	const float intersectionArea = (intersectionMax - intersectionMin).prod();
+	return intersectionArea / ((max1 - min1).prod() + (max2 - min2).prod() - intersectionArea);
+}
+
+void NonMaximumSuppression::suppress(std::vector<Box*>& boxes) {
+	// Group boxes by label
+	std::map<uchar, std::vector<Box*>> groups;
+	for(Box* box : boxes) {
+		if(!box->removed)
+			groups[m_perClass ? box->label : 0].push_back(box);
+	}
+
+	// Greedy suppression: Visit boxes with the highest score first, and keep a box if it does not overlap
+	// any of the boxes kept so far. Kept boxes are stored in a spatial index, so that each box is only compared
+	// with nearby boxes.
+	auto suppressGroup = [this](std::vector<Box*>& group) {
+		std::stable_sort(group.begin(), group.end(), [](const Box* a, const Box* b) {
+			return a->score > b->score;
+		});
+		BoundingBoxSpatialIndex index;
+		std::vector<Box*> kept;
+		for(Box* box : group) {
+			for(uint id : index.query(box->min, box->max)) {
+				if(intersectionOverUnion(box->min, box->max, kept[id]->min, kept[id]->max) > m_threshold) { // If large overlap
+					box->removed = true;
+					break;
+				}
+			}
+			if(!box->removed) {
+				index.insert(kept.size(), box->min, box->max);
+				kept.push_back(box);
+			}
+		}
+	};
+
+	// Small sets, like a single patch, are not worth the threading overhead
+	if(groups.size() == 1 || boxes.size() < 256 || m_threads == 1) {
+		for(auto&& group : groups)
+			suppressGroup(group.second);
+	} else {
+		if(!m_pool)
+			m_pool = std::make_unique<ThreadPool>(m_threads);
+		std::vector<std::future<void>> futures;
+		for(auto&& group : groups)
+			futures.push_back(m_pool->submit([&suppressGroup, &group]() { suppressGroup(group.second); }));
+		for(auto&& future : futures)
+			future.get();
+	}
 }
 
 void NonMaximumSuppression::execute() {
 	auto input = getInputData<BoundingBoxSet>();
-	auto output = BoundingBoxSet::create();
 
-	auto compare = [](BoundingBox::pointer a, BoundingBox::pointer b) {
-		return a->getScore() < b->getScore(); // if true, they swap place
-	};
-	std::priority_queue<BoundingBox::pointer, std::vector<BoundingBox::pointer>, decltype(compare)> queue(compare);
-	// Add bounding boxes to the queue
-	auto inputAccess = input->getAccess(ACCESS_READ);
-	auto outputAccess = output->getAccess(ACCESS_READ_WRITE);
-	auto coordinates = inputAccess->getCoordinates();
-	auto labels = inputAccess->getLabels();
-	auto scores = inputAccess->getScores();
-	for(int i = 0; i < coordinates.size(); i += 12) {
-		Vector2f position = Vector2f(coordinates[i], coordinates[i + 1]);
-		Vector2f size = Vector2f(coordinates[i + 6], coordinates[i + 7]) - position;
-		try {
-            auto bbox = BoundingBox::create(position, size, labels[i / 4], scores[i / 12]);
-            queue.push(bbox);
-        } catch(Exception &e) {
+	// Offset used to place the boxes of a patch in the coordinate system of the whole image
+	Vector2f offset = Vector2f::Zero();
+	std::pair<int, int> patchID;
+	if(m_mergePatches) {
+		patchID = std::make_pair(std::stoi(input->getFrameData("patchid-x")), std::stoi(input->getFrameData("patchid-y")));
+		int overlapX = 0;
+		int overlapY = 0;
+		if(input->hasFrameData("patch-overlap-x")) {
+			overlapX = std::stoi(input->getFrameData("patch-overlap-x"));
+			overlapY = std::stoi(input->getFrameData("patch-overlap-y"));
+		}
+		// Patches from PatchGenerator start at patchid*(size - 2*overlap) - overlap
+		offset.x() = (patchID.first * (std::stoi(input->getFrameData("patch-width")) - 2*overlapX) - overlapX) * std::stof(input->getFrameData("patch-spacing-x"));
+		offset.y() = (patchID.second * (std::stoi(input->getFrameData("patch-height")) - 2*overlapY) - overlapY) * std::stof(input->getFrameData("patch-spacing-y"));
+	}
 
+	std::vector<Box> boxes;
+	{
+		auto inputAccess = input->getAccess(ACCESS_READ);
+		auto coordinates = inputAccess->getCoordinates();
+		auto labels = inputAccess->getLabels();
+		auto scores = inputAccess->getScores();
+		boxes.reserve(scores.size());
+		for(int i = 0; i < coordinates.size(); i += 12) {
+			Box box;
+			box.min = Vector2f(coordinates[i], coordinates[i + 1]) + offset;
+			box.max = Vector2f(coordinates[i + 6], coordinates[i + 7]) + offset;
+			if(box.max.x() <= box.min.x() || box.max.y() <= box.min.y()) // Skip invalid boxes
+				continue;
+			box.label = labels[i / 4];
+			box.score = scores[i / 12];
+			box.removed = false;
+			boxes.push_back(box);
 		}
 	}
 
-	std::unordered_set<BoundingBox::pointer> erased;
-	while(!queue.empty()) {
-		BoundingBox::pointer b_m;
-		do {
-			b_m = queue.top();
-			queue.pop();
-		} while(erased.count(b_m) > 0 && !queue.empty());
-		if(!b_m)
-			break;
-		
-		outputAccess->addBoundingBox(b_m);
-		auto iterateQueue = queue; // Create new queue for iterating
-
-		// Remove overlapping bounding boxes
-		while(!iterateQueue.empty()) {
-			auto b = iterateQueue.top();
-			iterateQueue.pop();
-
-			if(b_m->intersectionOverUnion(b) > m_threshold) { // If large overlap
-				erased.insert(b);
-			}
+	if(!m_mergePatches) {
+		std::vector<Box*> candidates;
+		for(auto&& box : boxes)
+			candidates.push_back(&box);
+		suppress(candidates);
+
+		auto output = BoundingBoxSet::create();
+		auto outputAccess = output->getAccess(ACCESS_READ_WRITE);
+		// Add in order of decreasing score, as the previous implementation did
+		std::stable_sort(boxes.begin(), boxes.end(), [](const Box& a, const Box& b) {
+			return a.score > b.score;
+		});
+		for(auto&& box : boxes) {
+			if(!box.removed)
+				outputAccess->addBoundingBox(box.min, box.max - box.min, box.label, box.score);
+		}
+		addOutputData(0, output);
+		return;
+	}
+
+	// Suppress the new boxes together with the remaining boxes of the neighbouring patches.
+	// Boxes already removed stay removed, even if the box which suppressed them is removed later.
+	m_pendingPatches[patchID] = std::move(boxes);
+	std::vector<Box*> candidates;
+	for(int y = patchID.second - 1; y <= patchID.second + 1; ++y) {
+		for(int x = patchID.first - 1; x <= patchID.first + 1; ++x) {
+			auto patch = m_pendingPatches.find(std::make_pair(x, y));
+			if(patch == m_pendingPatches.end())
+				continue;
+			for(auto&& box : patch->second)
+				candidates.push_back(&box);
 		}
 	}
+	suppress(candidates);
 
+	// Move boxes of patches which can no longer be affected to the output.
+	// Patches arrive in row-major order, thus a patch is done when the patch below and to the right has been passed.
+	if(!m_mergedBoxes)
+		m_mergedBoxes = BoundingBoxSet::create();
+	{
+		auto outputAccess = m_mergedBoxes->getAccess(ACCESS_READ_WRITE);
+		for(auto it = m_pendingPatches.begin(); it != m_pendingPatches.end();) {
+			const int x = it->first.first;
+			const int y = it->first.second;
+			const bool done = patchID.second > y + 1 || (patchID.second == y + 1 && patchID.first > x);
+			if(!done && !input->isLastFrame()) {
+				++it;
+				continue;
+			}
+			for(auto&& box : it->second) {
+				if(!box.removed)
+					outputAccess->addBoundingBox(box.min, box.max - box.min, box.label, box.score);
+			}
+			it = m_pendingPatches.erase(it);
+		}
+	}
+	auto output = m_mergedBoxes;
+	if(input->isLastFrame()) {
+		// Start a new set for the next stream
+		m_pendingPatches.clear();
+		m_mergedBoxes.reset();
+	}
 	addOutputData(0, output);
 }
 
-}
\ No newline at end of file
+}
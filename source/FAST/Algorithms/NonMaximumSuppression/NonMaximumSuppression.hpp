@@ -1,13 +1,25 @@
 #pragma once
 
 #include <FAST/ProcessObject.hpp>
+#include <map>
 
 namespace fast {
 
+class BoundingBoxSet;
+class ThreadPool;
+
 /**
  * @brief Non-maximum suppression of bounding box sets
  *
  * Removes overlapping bounding boxes in a BoundingBoxSet if intersection over union is above a provided threshold.
+ * Boxes are only compared with nearby boxes found using a BoundingBoxSpatialIndex, and
+ * each class (label) is processed in parallel.
+ *
+ * If patch merging is enabled, a stream of bounding box sets from patches created by PatchGenerator
+ * is merged into a single bounding box set, and boxes which overlap patch borders are suppressed across patches.
+ * The patch position is found using the frame data patchid-x/y, patch-width/height, patch-overlap-x/y and
+ * patch-spacing-x/y. Patches are assumed to arrive in row-major order, as from PatchGenerator. A box is added to the
+ * output when all neighbouring patches have been processed, or when the last frame arrives.
  *
  * Inputs:
  * - 0: BoundingBoxSet
@@ -23,15 +35,61 @@ class FAST_EXPORT NonMaximumSuppression : public ProcessObject {
         /**
          * @brief Create instance
          * @param threshold Minimum intersection over union to remove overlapping bounding box.
+         * @param perClass Only suppress boxes with the same label. Default is false, i.e. boxes of all labels
+         *      suppress each other.
+         * @param mergePatches Merge a stream of patch bounding box sets into one set, and suppress boxes across patches
+         * @param threads Number of threads to use. 0 means use all hardware threads.
          * @return instance
          */
-        FAST_CONSTRUCTOR(NonMaximumSuppression, float, threshold, = 0.5f);
+        FAST_CONSTRUCTOR(NonMaximumSuppression,
+                         float, threshold, = 0.5f,
+                         bool, perClass, = false,
+                         bool, mergePatches, = false,
+                         int, threads, = 0
+        );
 		void setThreshold(float threshold);
+		/**
+		 * @brief Set whether boxes should only suppress boxes with the same label
+		 * @param perClass
+		 */
+		void setPerClass(bool perClass);
+		/**
+		 * @brief Set whether a stream of bounding box sets from patches should be merged into one set.
+		 * @param mergePatches
+		 */
+		void setMergePatches(bool mergePatches);
+		/**
+		 * @brief Set number of threads to use
+		 * @param threads 0 means use all hardware threads.
+		 */
+		void setNumberOfThreads(int threads);
 		void loadAttributes();
+		~NonMaximumSuppression();
 	protected:
+		struct Box {
+			Vector2f min;
+			Vector2f max;
+			uchar label;
+			float score;
+			bool removed;
+		};
 		void execute() override;
+		/**
+		 * @brief Suppress boxes in parallel, grouped by label if perClass is enabled.
+		 * Suppressed boxes are marked as removed.
+		 * @param boxes Boxes to suppress. Boxes already marked as removed are ignored.
+		 */
+		void suppress(std::vector<Box*>& boxes);
 
 		float m_threshold = 0.5f;
+		bool m_perClass = false;
+		bool m_mergePatches = false;
+		int m_threads = 0;
+		std::unique_ptr<ThreadPool> m_pool;
+
+		// Patch merging state
+		std::map<std::pair<int, int>, std::vector<Box>> m_pendingPatches;
+		std::shared_ptr<BoundingBoxSet> m_mergedBoxes;
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,62 @@
+#include "NonMaximumSuppression.hpp"
+#include <FAST/Testing.hpp>
+#include <FAST/Data/BoundingBox.hpp>
+#include <algorithm>
+
+using namespace fast;
+
+TEST_CASE("Non-maximum suppression removes overlapping boxes", "[fast][NonMaximumSuppression]") {
+    auto boxes = BoundingBoxSet::create();
+    {
+        auto access = boxes->getAccess(ACCESS_READ_WRITE);
+        access->addBoundingBox(Vector2f(0, 0), Vector2f(10, 10), 1, 0.5f);
+        access->addBoundingBox(Vector2f(1, 1), Vector2f(10, 10), 1, 0.9f);
+        access->addBoundingBox(Vector2f(1, 0), Vector2f(10, 10), 2, 0.8f); // Other class
+        access->addBoundingBox(Vector2f(100, 100), Vector2f(10, 10), 1, 0.3f);
+    }
+    auto nms = NonMaximumSuppression::create(0.5f)->connect(boxes);
+    auto output = nms->runAndGetOutputData<BoundingBoxSet>();
+    auto scores = output->getAccess(ACCESS_READ)->getScores();
+    CHECK(scores == std::vector<float>{0.9f, 0.3f});
+
+    nms->setPerClass(true);
+    output = nms->runAndGetOutputData<BoundingBoxSet>();
+    scores = output->getAccess(ACCESS_READ)->getScores();
+    CHECK(scores == std::vector<float>{0.9f, 0.8f, 0.3f});
+}
+
+TEST_CASE("Non-maximum suppression merges boxes across patches", "[fast][NonMaximumSuppression]") {
+    auto nms = NonMaximumSuppression::create(0.5f, true, true);
+    // Two neighbouring patches of size 100 with a detection of the same object on the border
+    for(int patchX = 0; patchX < 2; ++patchX) {
+        auto boxes = BoundingBoxSet::create();
+        {
+            auto access = boxes->getAccess(ACCESS_READ_WRITE);
+            if(patchX == 0) {
+                access->addBoundingBox(Vector2f(90, 40), Vector2f(10, 10), 1, 0.7f);
+                access->addBoundingBox(Vector2f(10, 10), Vector2f(10, 10), 1, 0.6f);
+            } else {
+                access->addBoundingBox(Vector2f(-9, 40), Vector2f(10, 10), 1, 0.8f);
+            }
+        }
+        boxes->setFrameData("patchid-x", std::to_string(patchX));
+        boxes->setFrameData("patchid-y", "0");
+        boxes->setFrameData("patch-width", "100");
+        boxes->setFrameData("patch-height", "100");
+        boxes->setFrameData("patch-spacing-x", "1");
+        boxes->setFrameData("patch-spacing-y", "1");
+        if(patchX == 1)
+            boxes->setLastFrame("test");
+        nms->connect(boxes);
+        auto output = nms->runAndGetOutputData<BoundingBoxSet>();
+        if(patchX == 1) {
+            auto access = output->getAccess(ACCESS_READ);
+            auto scores = access->getScores();
+            std::sort(scores.begin(), scores.end());
+            CHECK(scores == std::vector<float>{0.6f, 0.8f});
+            auto box = access->getBoundingBoxesInRegion(Vector2f(91, 41), Vector2f(92, 42));
+            REQUIRE(box.size() == 1);
+            CHECK(access->getCoordinates()[box[0]*12] == Approx(91));
+        }
+    }
+}
@@ -0,0 +1,47 @@
+__constant sampler_t sampler = CLK_NORMALIZED_COORDS_FALSE | CLK_FILTER_NEAREST | CLK_ADDRESS_CLAMP;
+
+__kernel void initialize(
+        __read_only image2d_t segmentation,
+        __global uint* labels
+        ) {
+    const int2 pos = {get_global_id(0), get_global_id(1)};
+    const uint index = pos.x + pos.y*get_global_size(0);
+    labels[index] = read_imageui(segmentation, sampler, pos).x == 0 ? 0 : index + 1;
+}
+
+/**
+ * Set label of each pixel to the smallest label among its neighbours with the same segmentation value.
+ * Labels point to a pixel, thus the label of that pixel is also used to speed up convergence.
+ */
+__kernel void propagate(
+        __read_only image2d_t segmentation,
+        __global uint* labels,
+        __global char* changed,
+        __private int fullConnectivity
+        ) {
+    const int2 pos = {get_global_id(0), get_global_id(1)};
+    const int2 size = {get_global_size(0), get_global_size(1)};
+    const uint index = pos.x + pos.y*size.x;
+    const uint value = read_imageui(segmentation, sampler, pos).x;
+    if(value == 0)
+        return;
+
+    const uint label = labels[index];
+    uint newLabel = min(label, labels[label - 1]);
+    for(int a = -1; a <= 1; ++a) {
+        for(int b = -1; b <= 1; ++b) {
+            if((a == 0 && b == 0) || (fullConnectivity == 0 && a != 0 && b != 0))
+                continue;
+            const int2 neighbour = pos + (int2)(a, b);
+            if(neighbour.x < 0 || neighbour.y < 0 || neighbour.x >= size.x || neighbour.y >= size.y)
+                continue;
+            if(read_imageui(segmentation, sampler, neighbour).x != value)
+                continue;
+            newLabel = min(newLabel, labels[neighbour.x + neighbour.y*size.x]);
+        }
+    }
+    if(newLabel < label) {
+        labels[index] = newLabel;
+        changed[0] = 1;
+    }
+}
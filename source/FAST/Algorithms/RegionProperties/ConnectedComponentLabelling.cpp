@@ -0,0 +1,279 @@
+#include "ConnectedComponentLabelling.hpp"
+#include <FAST/Data/Image.hpp>
+#include <FAST/ThreadPool.hpp>
+#include <FAST/Utility.hpp>
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace fast {
+
+ConnectedComponentLabelling::ConnectedComponentLabelling(bool fullConnectivity, int threads, bool useOpenCL) {
+    createInputPort<Image>(0);
+    createOutputPort<Image>(0);
+    createOutputPort<RegionList>(1);
+    createOpenCLProgram(Config::getKernelSourcePath() + "Algorithms/RegionProperties/ConnectedComponentLabelling.cl");
+    setFullConnectivity(fullConnectivity);
+    setNumberOfThreads(threads);
+    setUseOpenCL(useOpenCL);
+    createBooleanAttribute("full-connectivity", "Full connectivity", "Use 8-connectivity if true, and 4-connectivity if false", m_fullConnectivity);
+    createIntegerAttribute("threads", "Threads", "Number of threads to use on the host. 0 means use all hardware threads.", m_threads);
+    createBooleanAttribute("use-opencl", "Use OpenCL", "Label components using OpenCL instead of on the host", m_useOpenCL);
+}
+
+void ConnectedComponentLabelling::loadAttributes() {
+    setFullConnectivity(getBooleanAttribute("full-connectivity"));
+    setNumberOfThreads(getIntegerAttribute("threads"));
+    setUseOpenCL(getBooleanAttribute("use-opencl"));
+}
+
+void ConnectedComponentLabelling::setFullConnectivity(bool fullConnectivity) {
+    m_fullConnectivity = fullConnectivity;
+    setModified(true);
+}
+
+void ConnectedComponentLabelling::setNumberOfThreads(int threads) {
+    if(threads < 0)
+        throw Exception("Number of threads in ConnectedComponentLabelling must be >= 0");
+    m_threads = threads;
+    setModified(true);
+}
+
+void ConnectedComponentLabelling::setUseOpenCL(bool useOpenCL) {
+    m_useOpenCL = useOpenCL;
+    setModified(true);
+}
+
+/**
+ * Split the rows of an image into strips, and run a function on each strip in parallel.
+ */
+static void forEachStrip(ThreadPool& pool, const std::vector<int>& stripStart, std::function<void(int, int, int)> function) {
+    std::vector<std::future<void>> futures;
+    for(int strip = 0; strip < (int)stripStart.size() - 1; ++strip)
+        futures.push_back(pool.submit([&function, &stripStart, strip]() { function(strip, stripStart[strip], stripStart[strip + 1]); }));
+    for(auto&& future : futures)
+        future.get();
+}
+
+static std::vector<int> getStrips(int height, int threads) {
+    // At least 32 rows per strip, to avoid merging too many strip borders
+    const int nrOfStrips = std::max(1, std::min(threads, height / 32));
+    std::vector<int> stripStart;
+    for(int strip = 0; strip <= nrOfStrips; ++strip)
+        stripStart.push_back(strip * height / nrOfStrips);
+    return stripStart;
+}
+
+void ConnectedComponentLabelling::findRootsOnHost(const uchar* pixels, int width, int height, uint* roots) {
+    ThreadPool pool(m_threads);
+    const auto stripStart = getStrips(height, pool.getNumberOfThreads());
+
+    // Union-find where the root of a tree is always the pixel with the smallest index
+    std::vector<uint> parent(width*height);
+    auto find = [&parent](uint i) {
+        while(parent[i] != i) {
+            parent[i] = parent[parent[i]]; // Path halving
+            i = parent[i];
+        }
+        return i;
+    };
+    auto unite = [&parent, &find](uint a, uint b) {
+        a = find(a);
+        b = find(b);
+        if(a < b) {
+            parent[b] = a;
+        } else if(b < a) {
+            parent[a] = b;
+        }
+    };
+    // Merge pixel with the previously visited neighbours in the row above
+    auto uniteWithRowAbove = [&](int x, int y) {
+        const uint index = x + y*width;
+        const uchar label = pixels[index];
+        for(int a = (m_fullConnectivity ? -1 : 0); a <= (m_fullConnectivity ? 1 : 0); ++a) {
+            if(x + a < 0 || x + a >= width)
+                continue;
+            if(pixels[index - width + a] == label)
+                unite(index, index - width + a);
+        }
+    };
+
+    // Label each strip. All trees are within a strip, thus the strips can be processed in parallel.
+    forEachStrip(pool, stripStart, [&](int strip, int startY, int endY) {
+        for(int y = startY; y < endY; ++y) {
+            for(int x = 0; x < width; ++x) {
+                const uint index = x + y*width;
+                parent[index] = index;
+                if(pixels[index] == 0)
+                    continue;
+                if(x > 0 && pixels[index - 1] == pixels[index])
+                    unite(index, index - 1);
+                if(y > startY)
+                    uniteWithRowAbove(x, y);
+            }
+        }
+    });
+
+    // Merge strip borders
+    for(int strip = 1; strip < (int)stripStart.size() - 1; ++strip) {
+        const int y = stripStart[strip];
+        for(int x = 0; x < width; ++x) {
+            if(pixels[x + y*width] != 0)
+                uniteWithRowAbove(x, y);
+        }
+    }
+
+    // Find the root of each pixel. The trees are not modified anymore, thus this can be done in parallel.
+    forEachStrip(pool, stripStart, [&](int strip, int startY, int endY) {
+        for(uint index = startY*width; index < endY*width; ++index) {
+            if(pixels[index] == 0) {
+                roots[index] = 0;
+                continue;
+            }
+            uint root = index;
+            while(parent[root] != root)
+                root = parent[root];
+            roots[index] = root + 1;
+        }
+    });
+}
+
+void ConnectedComponentLabelling::findRootsWithOpenCL(std::shared_ptr<Image> input, uint* roots) {
+    auto device = std::dynamic_pointer_cast<OpenCLDevice>(getMainDevice());
+    auto queue = device->getCommandQueue();
+    const int width = input->getWidth();
+    const int height = input->getHeight();
+    cl::Program program = getOpenCLProgram(device);
+    cl::Kernel initializeKernel(program, "initialize");
+    cl::Kernel propagateKernel(program, "propagate");
+
+    auto inputAccess = input->getOpenCLImageAccess(ACCESS_READ, device);
+    cl::Buffer labels(device->getContext(), CL_MEM_READ_WRITE, width*height*sizeof(uint));
+    cl::Buffer changedBuffer(device->getContext(), CL_MEM_READ_WRITE, sizeof(char));
+
+    initializeKernel.setArg(0, *inputAccess->get2DImage());
+    initializeKernel.setArg(1, labels);
+    queue.enqueueNDRangeKernel(initializeKernel, cl::NullRange, cl::NDRange(width, height), cl::NullRange);
+
+    // Propagate the smallest label in each component until nothing changes
+    propagateKernel.setArg(0, *inputAccess->get2DImage());
+    propagateKernel.setArg(1, labels);
+    propagateKernel.setArg(2, changedBuffer);
+    propagateKernel.setArg(3, (int)(m_fullConnectivity ? 1 : 0));
+    char changed;
+    do {
+        const char changedInit = 0;
+        queue.enqueueWriteBuffer(changedBuffer, CL_FALSE, 0, sizeof(char), &changedInit);
+        queue.enqueueNDRangeKernel(propagateKernel, cl::NullRange, cl::NDRange(width, height), cl::NullRange);
+        queue.enqueueReadBuffer(changedBuffer, CL_TRUE, 0, sizeof(char), &changed);
+    } while(changed == 1);
+
+    queue.enqueueReadBuffer(labels, CL_TRUE, 0, width*height*sizeof(uint), roots);
+}
+
+void ConnectedComponentLabelling::execute() {
+    auto input = getInputData<Image>(0);
+    if(input->getDataType() != TYPE_UINT8)
+        throw Exception("Wrong input data type to ConnectedComponentLabelling");
+    if(input->getDimensions() != 2)
+        throw Exception("ConnectedComponentLabelling is only implemented for 2D segmentations");
+
+    const int width = input->getWidth();
+    const int height = input->getHeight();
+    const Vector3f spacing = input->getSpacing();
+    auto labels = make_uninitialized_unique<uint[]>(width*height);
+
+    auto access = input->getImageAccess(ACCESS_READ);
+    auto pixels = (const uchar*)access->get();
+    if(m_useOpenCL && !getMainDevice()->isHost()) {
+        findRootsWithOpenCL(input, labels.get());
+    } else {
+        findRootsOnHost(pixels, width, height, labels.get());
+    }
+
+    ThreadPool pool(m_threads);
+    const auto stripStart = getStrips(height, pool.getNumberOfThreads());
+
+    // The roots of the components are the pixels which point to themselves. Component ids are assigned in raster order.
+    std::vector<std::vector<uint>> stripRoots(stripStart.size() - 1);
+    forEachStrip(pool, stripStart, [&](int strip, int startY, int endY) {
+        for(uint index = startY*width; index < endY*width; ++index) {
+            if(labels[index] == index + 1)
+                stripRoots[strip].push_back(index);
+        }
+    });
+    std::vector<uint> roots;
+    for(auto&& rootsInStrip : stripRoots)
+        roots.insert(roots.end(), rootsInStrip.begin(), rootsInStrip.end());
+
+    // Relabel, and calculate statistics of each component in each strip
+    struct Statistics {
+        int64_t pixelCount = 0;
+        Eigen::Vector2d sum = Eigen::Vector2d::Zero();
+        Vector2i min = Vector2i::Constant(std::numeric_limits<int>::max());
+        Vector2i max = Vector2i::Constant(std::numeric_limits<int>::min());
+        int64_t verticalEdges = 0;
+        int64_t horizontalEdges = 0;
+    };
+    std::vector<std::unordered_map<uint, Statistics>> stripStatistics(stripStart.size() - 1);
+    forEachStrip(pool, stripStart, [&](int strip, int startY, int endY) {
+        uint previousRoot = 0;
+        uint id = 0;
+        Statistics* statistics = nullptr;
+        for(int y = startY; y < endY; ++y) {
+            for(int x = 0; x < width; ++x) {
+                const uint index = x + y*width;
+                if(labels[index] == 0)
+                    continue;
+                // Neighbouring pixels usually belong to the same component, thus only search when the root changes
+                if(labels[index] != previousRoot) {
+                    previousRoot = labels[index];
+                    id = std::lower_bound(roots.begin(), roots.end(), previousRoot - 1) - roots.begin();
+                    statistics = &stripStatistics[strip][id];
+                }
+                labels[index] = id + 1;
+                statistics->pixelCount += 1;
+                statistics->sum += Eigen::Vector2d(x, y);
+                statistics->min = statistics->min.cwiseMin(Vector2i(x, y));
+                statistics->max = statistics->max.cwiseMax(Vector2i(x, y));
+                // Count pixel edges on the border of the component
+                const uchar label = pixels[index];
+                statistics->verticalEdges += (x == 0 || pixels[index - 1] != label) + (x == width - 1 || pixels[index + 1] != label);
+                statistics->horizontalEdges += (y == 0 || pixels[index - width] != label) + (y == height - 1 || pixels[index + width] != label);
+            }
+        }
+    });
+
+    std::vector<Statistics> statistics(roots.size());
+    for(auto&& statisticsInStrip : stripStatistics) {
+        for(auto&& item : statisticsInStrip) {
+            auto& total = statistics[item.first];
+            total.pixelCount += item.second.pixelCount;
+            total.sum += item.second.sum;
+            total.min = total.min.cwiseMin(item.second.min);
+            total.max = total.max.cwiseMax(item.second.max);
+            total.verticalEdges += item.second.verticalEdges;
+            total.horizontalEdges += item.second.horizontalEdges;
+        }
+    }
+    std::vector<Region> regions(roots.size());
+    for(int i = 0; i < roots.size(); ++i) {
+        Region& region = regions[i];
+        region.label = pixels[roots[i]];
+        region.pixelCount = statistics[i].pixelCount;
+        region.area = statistics[i].pixelCount*spacing.x()*spacing.y();
+        region.centroid = (statistics[i].sum / (double)statistics[i].pixelCount).cast<float>().cwiseProduct(spacing.head(2));
+        region.minPixelPosition = statistics[i].min;
+        region.maxPixelPosition = statistics[i].max;
+        region.perimiterLength = statistics[i].verticalEdges*spacing.y() + statistics[i].horizontalEdges*spacing.x();
+        region.averageRadius = 0.0f;
+    }
+
+    auto output = Image::create(width, height, TYPE_UINT32, 1, std::move(labels));
+    output->setSpacing(spacing);
+    SceneGraph::setParentNode(output, input);
+    addOutputData(0, output);
+    addOutputData(1, RegionList::create(regions));
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <FAST/ProcessObject.hpp>
+#include <FAST/Algorithms/RegionProperties/RegionProperties.hpp>
+
+namespace fast {
+
+class Image;
+
+/**
+ * @brief Label connected components of a 2D segmentation, and calculate statistics for each component
+ *
+ * Pixels which are connected and have the same segmentation label belong to the same component.
+ * On the host, the image is split into strips of rows which are labelled in parallel using union-find.
+ * The strips are then merged along their borders.
+ * Alternatively, labels can be propagated with OpenCL until convergence.
+ *
+ * Components are numbered in raster order of their first pixel, starting at 1. The output label image has
+ * the type TYPE_UINT32, where 0 is background.
+ * For each component, the output RegionList contains the label, pixel count, area, centroid, bounding box
+ * (min/max pixel position) and perimeter, calculated as the length of the pixel edges on the border of the component.
+ * The contour and pixel list of each Region is not filled in, use RegionProperties for this.
+ *
+ * Inputs:
+ * - 0: Image 2D segmentation of type TYPE_UINT8
+ *
+ * Outputs:
+ * - 0: Image 2D label image of type TYPE_UINT32
+ * - 1: RegionList
+ *
+ * @ingroup segmentation
+ */
+class FAST_EXPORT ConnectedComponentLabelling : public ProcessObject {
+    FAST_PROCESS_OBJECT(ConnectedComponentLabelling)
+    public:
+        /**
+         * @brief Create instance
+         * @param fullConnectivity Use 8-connectivity if true, and 4-connectivity if false.
+         * @param threads Number of threads to use on the host. 0 means use all hardware threads.
+         * @param useOpenCL Label components using OpenCL on the main device instead of on the host.
+         * @return instance
+         */
+        FAST_CONSTRUCTOR(ConnectedComponentLabelling,
+                         bool, fullConnectivity, = true,
+                         int, threads, = 0,
+                         bool, useOpenCL, = false
+        );
+        void setFullConnectivity(bool fullConnectivity);
+        void setNumberOfThreads(int threads);
+        void setUseOpenCL(bool useOpenCL);
+        void loadAttributes() override;
+    protected:
+        void execute() override;
+        /**
+         * @brief Find the components on the host.
+         * @param pixels Segmentation
+         * @param roots Is set to 1 + index of the first pixel of the component of each pixel, and 0 for background.
+         */
+        void findRootsOnHost(const uchar* pixels, int width, int height, uint* roots);
+        /**
+         * @brief Find the components using OpenCL. Same output as findRootsOnHost.
+         */
+        void findRootsWithOpenCL(std::shared_ptr<Image> input, uint* roots);
+
+        bool m_fullConnectivity = true;
+        int m_threads = 0;
+        bool m_useOpenCL = false;
+};
+
+}
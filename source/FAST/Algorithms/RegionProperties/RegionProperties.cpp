@@ -1,7 +1,7 @@
 #include <FAST/Data/Image.hpp>
 #include "RegionProperties.hpp"
+#include "ConnectedComponentLabelling.hpp"
 #include <unordered_set>
-#include <queue>
 #include <FAST/Data/Mesh.hpp>
 
 namespace fast {
@@ -18,81 +18,32 @@ void RegionProperties::execute() {
     if(input->getDimensions() != 2)
         throw Exception("Region properties is only implemented for 2D segmentations");
 
-    std::vector<Region> regions;
-
     const int width = input->getWidth();
     const int height = input->getHeight();
     const Vector3f spacing = input->getSpacing();
-    const float pixelSize = spacing.x()*spacing.y();
-
-    std::unordered_set<uint> visited;
-    auto access = input->getImageAccess(ACCESS_READ);
-    auto pixels = (uchar*)access->get();
-
-    // Get regions by flood fill first
-    std::queue<Vector2i> queue;
-    for(int y = 0; y < height; ++y) {
-        for(int x = 0; x < width; ++x) {
-            uchar currentLabel = pixels[x + y*width];
-            if(currentLabel == 0 || visited.count(x+y*width) > 0)
-                continue;
-
-            // Start flood fill
-
-            // Create region
-            Region region;
-            region.label = currentLabel;
-            region.pixelCount = 0;
-            region.area = 0.0f;
-            region.centroid = Vector2f::Zero();
-
-            int minX = std::numeric_limits<int>::max();
-            int maxX = 0;
-            int minY = std::numeric_limits<int>::max();
-            int maxY = 0;
-
-            queue.push(Vector2i(x,y));
-            visited.insert(x + y*width);
-            while(!queue.empty()) {
-                Vector2i current = queue.front();
-                queue.pop();
 
-                region.centroid += current.cast<float>();
-                region.pixels.push_back(current);
-                minX = std::min(minX, current.x());
-                maxX = std::max(maxX, current.x());
-                minY = std::min(minY, current.y());
-                maxY = std::max(maxY, current.y());
-
-                ++region.pixelCount;
-                region.area += pixelSize;
-
-                // Check neighbors
-                for(int a = -1; a <= 1; ++a) {
-                    for(int b = -1; b <= 1; ++b) {
-                        Vector2i next = current + Vector2i(a,b);
-                        // Out of bounds check
-                        if(next.x() < 0 || next.y() < 0 || next.x() >= width || next.y() >= height)
-                            continue;
-                        uchar label = pixels[next.x() + next.y() * width];
-                        if(label == currentLabel && visited.count(next.x() + next.y() * width) == 0) {
-                            queue.push(next);
-                            visited.insert(next.x() + next.y()*width);
-                        }
-                    }
-                }
+    // Find regions and their area, centroid and bounding box
+    auto labelling = ConnectedComponentLabelling::create()->connect(input);
+    auto labelImage = labelling->runAndGetOutputData<Image>(0);
+    std::vector<Region> regions = labelling->getOutputData<RegionList>(1)->get();
+
+    {
+        auto labelAccess = labelImage->getImageAccess(ACCESS_READ);
+        auto labels = (const uint*)labelAccess->get();
+        for(auto& region : regions)
+            region.pixels.reserve(region.pixelCount);
+        for(int y = 0; y < height; ++y) {
+            for(int x = 0; x < width; ++x) {
+                const uint label = labels[x + y*width];
+                if(label > 0)
+                    regions[label - 1].pixels.push_back(Vector2i(x, y));
             }
-
-            region.centroid /= region.pixelCount;
-            region.centroid.x() *= spacing.x();
-            region.centroid.y() *= spacing.y();
-            region.minPixelPosition = Vector2i(minX, minY);
-            region.maxPixelPosition = Vector2i(maxX, maxY);
-
-            regions.push_back(region);
         }
     }
 
+    std::unordered_set<uint> visited;
+    auto access = input->getImageAccess(ACCESS_READ);
+    auto pixels = (uchar*)access->get();
 
     // TODO do contour tracing for each region if enabled
     // TODO handle holes
@@ -1,5 +1,7 @@
 #include "RegionProperties.hpp"
+#include "ConnectedComponentLabelling.hpp"
 #include <FAST/Testing.hpp>
+#include <FAST/Data/Image.hpp>
 #include <FAST/Importers/ImageFileImporter.hpp>
 #include <FAST/Algorithms/BinaryThresholding/BinaryThresholding.hpp>
 
@@ -24,4 +26,50 @@ TEST_CASE("Region properties", "[regionproperties][fast]") {
         //std::cout << "Area: " << region.area << std::endl;
         //std::cout << "Label: " << (int)region.label << std::endl;
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Connected component labelling", "[regionproperties][ConnectedComponentLabelling][fast]") {
+    // Two diagonal pixels which are only connected with 8-connectivity, a rectangle spanning many rows
+    // (and thus several strips), and a region with another label next to the rectangle
+    const int width = 64;
+    const int height = 256;
+    std::vector<uchar> data(width*height, 0);
+    data[1 + 1*width] = 1;
+    data[2 + 2*width] = 1;
+    for(int y = 10; y < 250; ++y) {
+        for(int x = 10; x < 20; ++x) {
+            data[x + y*width] = 1;
+            data[x + 10 + y*width] = 2;
+        }
+    }
+    auto image = Image::create(width, height, TYPE_UINT8, 1, data.data());
+    image->setSpacing(Vector3f(0.5f, 2.0f, 1.0f));
+
+    for(bool useOpenCL : {false, true}) {
+        auto labelling = ConnectedComponentLabelling::create(true, 4, useOpenCL)->connect(image);
+        if(useOpenCL) // Make sure the OpenCL implementation is actually tested
+            REQUIRE(!labelling->getMainDevice()->isHost());
+        auto labelImage = labelling->runAndGetOutputData<Image>(0);
+        auto regions = labelling->getOutputData<RegionList>(1)->get();
+        REQUIRE(regions.size() == 3);
+        CHECK(regions[0].pixelCount == 2);
+        CHECK(regions[1].label == 1);
+        CHECK(regions[1].pixelCount == 240*10);
+        CHECK(regions[1].area == Approx(240*10*0.5f*2.0f));
+        CHECK(regions[1].minPixelPosition == Vector2i(10, 10));
+        CHECK(regions[1].maxPixelPosition == Vector2i(19, 249));
+        CHECK(regions[1].centroid.x() == Approx(14.5f*0.5f));
+        CHECK(regions[1].centroid.y() == Approx(129.5f*2.0f));
+        CHECK(regions[1].perimiterLength == Approx(2*240*2.0f + 2*10*0.5f));
+        CHECK(regions[2].label == 2);
+        auto access = labelImage->getImageAccess(ACCESS_READ);
+        CHECK(access->getScalar(Vector2i(2, 2)) == 1);
+        CHECK(access->getScalar(Vector2i(15, 200)) == 2);
+        CHECK(access->getScalar(Vector2i(25, 200)) == 3);
+        CHECK(access->getScalar(Vector2i(40, 200)) == 0);
+    }
+
+    // With 4-connectivity the diagonal pixels are separate regions
+    auto regions = ConnectedComponentLabelling::create(false)->connect(image)->runAndGetOutputData<RegionList>(1)->get();
+    CHECK(regions.size() == 4);
+}
@@ -1,7 +1,7 @@
 #include <FAST/Data/ImagePyramid.hpp>
 #include <FAST/Data/Image.hpp>
 #include <FAST/Algorithms/TissueSegmentation/TissueSegmentation.hpp>
-#include <FAST/Algorithms/RegionProperties/RegionProperties.hpp>
+#include <FAST/Algorithms/RegionProperties/ConnectedComponentLabelling.hpp>
 #include "TissueMicroArrayExtractor.hpp"
 #include <FAST/Data/Mesh.hpp>
 #include <FAST/Data/BoundingBox.hpp>
@@ -25,7 +25,10 @@ void TissueMicroArrayExtractor::execute() {
     if(!m_streamIsStarted) {
         m_streamIsStarted = true;
         m_tissue = TissueSegmentation::create(m_tissueThreshold, m_dilationSize, m_erosionSize)->connect(m_input)->runAndGetOutputData<Image>();
-        m_regions = RegionProperties::create()->connect(m_tissue)->runAndGetOutputData<RegionList>();
+        // Contours are not needed, thus only the connected component statistics are calculated
+        auto labelling = ConnectedComponentLabelling::create()->connect(m_tissue);
+        labelling->run();
+        m_regions = labelling->getOutputData<RegionList>(1);
         m_thread = std::make_unique<std::thread>(std::bind(&TissueMicroArrayExtractor::generateStream, this));
     }
     waitForFirstFrame();
@@ -10,8 +10,9 @@ BoundingBoxSetAccess::BoundingBoxSetAccess(
 	std::vector<uchar>* labels,
 	std::vector<float>* scores,
 	float* minimumSize,
+	BoundingBoxSpatialIndex* spatialIndex,
 	std::shared_ptr<BoundingBoxSet> bbset
-	) : m_coordinates(coordinates), m_lines(lines), m_labels(labels), m_scores(scores), m_bbset(bbset), m_minimumSize(minimumSize) {
+	) : m_coordinates(coordinates), m_lines(lines), m_labels(labels), m_scores(scores), m_bbset(bbset), m_minimumSize(minimumSize), m_spatialIndex(spatialIndex) {
 
 }
 
@@ -61,6 +62,8 @@ void BoundingBoxSetAccess::addBoundingBox(Vector2f position, Vector2f size, ucha
 		m_labels->push_back(label);
 
 		m_scores->push_back(score);
+
+		m_spatialIndex->insert(count / 4, position.cwiseMin(position + size), position.cwiseMax(position + size));
 	} else {
 		Reporter::warning() << "Bounding box set access was released, but was accessed." << Reporter::end();
 	}
@@ -86,6 +89,7 @@ std::vector<float> BoundingBoxSetAccess::getScores() const {
 void BoundingBoxSetAccess::addBoundingBoxes(std::vector<float> coordinates, std::vector<uint> lines, std::vector<uchar> labels, std::vector<float> scores, float minimumSize) {
 	const int size = m_coordinates->size() / 3;
 	m_coordinates->insert(m_coordinates->end(), coordinates.begin(), coordinates.end());
+	m_spatialIndex->insert(coordinates, size / 4);
 	// Have to update indexes of new lines:
 	std::transform(lines.begin(), lines.end(), lines.begin(), [size](uint index) -> uint {
 		return index + size;
@@ -96,6 +100,9 @@ void BoundingBoxSetAccess::addBoundingBoxes(std::vector<float> coordinates, std:
 	m_scores->insert(m_scores->end(), scores.begin(), scores.end());
 }
 
+std::vector<uint> BoundingBoxSetAccess::getBoundingBoxesInRegion(Vector2f min, Vector2f max) const {
+	return m_spatialIndex->query(min, max);
+}
 
 void BoundingBoxSetAccess::release() {
 	m_bbset->accessFinished();
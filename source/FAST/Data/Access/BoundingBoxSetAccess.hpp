@@ -4,6 +4,7 @@
 #include <FAST/Object.hpp>
 #include <vector>
 #include <FAST/Data/DataTypes.hpp>
+#include <FAST/Data/BoundingBoxSpatialIndex.hpp>
 
 #if defined(__APPLE__) || defined(__MACOSX)
 #include <OpenGL/OpenGL.h>
@@ -25,6 +26,7 @@ class FAST_EXPORT BoundingBoxSetAccess {
 			std::vector<uchar>* labels,
 			std::vector<float>* scores,
 			float* m_minimumSize,
+			BoundingBoxSpatialIndex* spatialIndex,
 			std::shared_ptr<BoundingBoxSet> bbset
 		);
 		void addBoundingBox(std::shared_ptr<BoundingBox> box);
@@ -34,6 +36,17 @@ class FAST_EXPORT BoundingBoxSetAccess {
 		std::vector<uchar> getLabels() const;
 		std::vector<float> getScores() const;
 		void addBoundingBoxes(std::vector<float> coordinates, std::vector<uint> lines, std::vector<uchar> labels, std::vector<float> scores, float minimumSize);
+		/**
+		 * @brief Get all bounding boxes which overlap a 2D region
+		 *
+		 * Box i consists of the vertices 4*i to 4*i+3, the lines 8*i to 8*i+7 in the line index list,
+		 * has the label at index 4*i and the score at index i.
+		 *
+		 * @param min Smallest corner of the region
+		 * @param max Largest corner of the region
+		 * @return sorted list of box indices
+		 */
+		std::vector<uint> getBoundingBoxesInRegion(Vector2f min, Vector2f max) const;
         void release();
         ~BoundingBoxSetAccess();
 		typedef std::unique_ptr<BoundingBoxSetAccess> pointer;
@@ -44,6 +57,7 @@ class FAST_EXPORT BoundingBoxSetAccess {
 		std::vector<uchar>* m_labels;
 		std::vector<float>* m_scores;
 		float* m_minimumSize;
+		BoundingBoxSpatialIndex* m_spatialIndex;
 		std::shared_ptr<BoundingBoxSet> m_bbset;
 		bool m_released = false;
 };
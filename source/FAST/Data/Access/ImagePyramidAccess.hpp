@@ -3,6 +3,7 @@
 #include <FAST/Object.hpp>
 #include <FAST/Data/DataTypes.hpp>
 #include <unordered_set>
+#include <functional>
 
 // Forward declare
 typedef struct _openslide openslide_t;
@@ -78,6 +79,14 @@ public:
 	 * @param y
 	 */
 	void setBlankPatch(int level, int x, int y);
+	/**
+	 * @brief Build the lower resolution levels from all tiles written since the last finalize
+	 *
+	 * Only needed when deferred level construction is enabled, see ImagePyramid::setDeferredLevelConstruction.
+	 * The levels are built bottom-up, and the tiles of each level are downsampled and written in parallel.
+	 * Blocks until all tiles have been written.
+	 */
+	void finalize();
 	bool isPatchInitialized(int level, int x, int y);
 	template <class T>
 	std::unique_ptr<T[]> getPatchData(int level, int x, int y, int width, int height);
@@ -112,9 +121,13 @@ private:
     uint32_t writeTileToTIFF(int level, int x, int y, uchar* data);
     uint32_t writeTileToTIFFJPEGXL(int level, int x, int y, uchar *data);
     uint32_t writeTileToTIFFJPEG(int level, int x, int y, uchar *data);
+    uint32_t writeTileToTIFFCompressed(int level, int x, int y, uchar *data, std::function<void(uchar*, int, int, std::vector<uchar>*)> compress);
     uint32_t writeTileToTIFFNeuralNetwork(int level, int x, int y, std::shared_ptr<Image> image);
-    int readTileFromTIFF(void* data, int x, int y, int level);
+    int readTileFromTIFF(TIFF* tiff, void* data, int x, int y, int level);
     void propagatePatch(std::shared_ptr<Image> patch, int level, int x, int y);
+    void downsampleTile(const uchar* previousData, int previousTileWidth, uchar* newData, int tileWidth, int tileHeight, int offsetX, int offsetY);
+    static std::string getTileCacheKey(int level, int tileX, int tileY);
+    void addTileToCache(const std::string& key, const void* data, std::size_t bytes);
 };
 
 template <class T>
@@ -9,11 +9,24 @@ cl::Buffer* OpenCLBufferAccess::get() const {
     return mBuffer;
 }
 
-OpenCLBufferAccess::OpenCLBufferAccess(cl::Buffer* buffer,  std::shared_ptr<DataObject> dataObject) {
+OpenCLBufferAccess::OpenCLBufferAccess(cl::Buffer* buffer,  std::shared_ptr<DataObject> dataObject, std::shared_ptr<OpenCLDevice> device, std::vector<cl::Event> events) {
     // Copy the image
     mBuffer = new cl::Buffer(*buffer);
     mIsDeleted = false;
     mDataObject = dataObject;
+    mDevice = device;
+    mEvents = std::move(events);
+}
+
+std::vector<cl::Event> OpenCLBufferAccess::getEvents() const {
+    return mEvents;
+}
+
+void OpenCLBufferAccess::setWriteEvent(cl::Event event) {
+    auto image = std::dynamic_pointer_cast<Image>(mDataObject);
+    if(!image || !mDevice)
+        return;
+    image->setOpenCLWriteEvent(mDevice, event);
 }
 
 void OpenCLBufferAccess::release() {
@@ -13,7 +13,21 @@ class DataObject;
 class FAST_EXPORT OpenCLBufferAccess {
     public:
         cl::Buffer* get() const;
-        OpenCLBufferAccess(cl::Buffer* buffer,  std::shared_ptr<DataObject> dataObject);
+        OpenCLBufferAccess(cl::Buffer* buffer,  std::shared_ptr<DataObject> dataObject, std::shared_ptr<OpenCLDevice> device = nullptr, std::vector<cl::Event> events = {});
+        /**
+         * @brief Get events which must complete before the buffer can be used.
+         *
+         * The main command queue of the device already waits for these events,
+         * thus this is only needed when using other command queues.
+         */
+        std::vector<cl::Event> getEvents() const;
+        /**
+         * @brief Set event which completes when all writes to the buffer are done.
+         *
+         * Transfers of the buffer back to the host will then wait only for this event,
+         * instead of all work on the main command queue. Only used for Image data.
+         */
+        void setWriteEvent(cl::Event event);
         void release();
         ~OpenCLBufferAccess();
 		typedef std::unique_ptr<OpenCLBufferAccess> pointer;
@@ -23,6 +37,8 @@ class FAST_EXPORT OpenCLBufferAccess {
         cl::Buffer* mBuffer;
         bool mIsDeleted;
         std::shared_ptr<DataObject> mDataObject;
+        std::shared_ptr<OpenCLDevice> mDevice;
+        std::vector<cl::Event> mEvents;
 };
 
 } // end namespace fast
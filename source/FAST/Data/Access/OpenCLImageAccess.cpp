@@ -16,18 +16,32 @@ cl::Image3D* OpenCLImageAccess::get3DImage() const {
 }
 
 
-OpenCLImageAccess::OpenCLImageAccess(cl::Image3D* image, std::shared_ptr<Image> object) {
+OpenCLImageAccess::OpenCLImageAccess(cl::Image3D* image, std::shared_ptr<Image> object, std::shared_ptr<OpenCLDevice> device, std::vector<cl::Event> events) {
     // Copy the image
     mImage = new cl::Image3D(*image);
     mIsDeleted = false;
     mImageObject = object;
+    mDevice = device;
+    mEvents = std::move(events);
 }
 
-OpenCLImageAccess::OpenCLImageAccess(cl::Image2D* image, std::shared_ptr<Image> object) {
+OpenCLImageAccess::OpenCLImageAccess(cl::Image2D* image, std::shared_ptr<Image> object, std::shared_ptr<OpenCLDevice> device, std::vector<cl::Event> events) {
     // Copy the image
     mImage = new cl::Image2D(*image);
     mIsDeleted = false;
     mImageObject = object;
+    mDevice = device;
+    mEvents = std::move(events);
+}
+
+std::vector<cl::Event> OpenCLImageAccess::getEvents() const {
+    return mEvents;
+}
+
+void OpenCLImageAccess::setWriteEvent(cl::Event event) {
+    if(!mDevice)
+        throw Exception("OpenCLImageAccess has no device, unable to set write event");
+    mImageObject->setOpenCLWriteEvent(mDevice, event);
 }
 
 void OpenCLImageAccess::release() {
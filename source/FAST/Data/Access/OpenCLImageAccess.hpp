@@ -16,8 +16,22 @@ class FAST_EXPORT  OpenCLImageAccess {
         cl::Image* get() const;
         cl::Image2D* get2DImage() const;
         cl::Image3D* get3DImage() const;
-        OpenCLImageAccess(cl::Image2D* image, std::shared_ptr<Image> object);
-        OpenCLImageAccess(cl::Image3D* image, std::shared_ptr<Image> object);
+        OpenCLImageAccess(cl::Image2D* image, std::shared_ptr<Image> object, std::shared_ptr<OpenCLDevice> device = nullptr, std::vector<cl::Event> events = {});
+        OpenCLImageAccess(cl::Image3D* image, std::shared_ptr<Image> object, std::shared_ptr<OpenCLDevice> device = nullptr, std::vector<cl::Event> events = {});
+        /**
+         * @brief Get events which must complete before the image can be used.
+         *
+         * The main command queue of the device already waits for these events,
+         * thus this is only needed when using other command queues.
+         */
+        std::vector<cl::Event> getEvents() const;
+        /**
+         * @brief Set event which completes when all writes to the image are done.
+         *
+         * Transfers of the image back to the host will then wait only for this event,
+         * instead of all work on the main command queue.
+         */
+        void setWriteEvent(cl::Event event);
         void release();
         ~OpenCLImageAccess();
 		typedef std::unique_ptr<OpenCLImageAccess> pointer;
@@ -27,6 +41,8 @@ class FAST_EXPORT  OpenCLImageAccess {
         cl::Image* mImage;
         bool mIsDeleted;
         std::shared_ptr<Image> mImageObject;
+        std::shared_ptr<OpenCLDevice> mDevice;
+        std::vector<cl::Event> mEvents;
 
 };
 
@@ -3,10 +3,11 @@
 
 namespace fast {
 
-TensorAccess::TensorAccess(float *data, TensorShape shape, std::shared_ptr<Tensor> tensor) {
+TensorAccess::TensorAccess(float *data, TensorShape shape, std::shared_ptr<Tensor> tensor, std::shared_ptr<float[]> storage) {
     m_data = data;
     m_shape = shape;
     m_tensor = tensor;
+    m_storage = std::move(storage);
 }
 
 TensorShape TensorAccess::getShape() const {
@@ -19,6 +20,7 @@ TensorAccess::~TensorAccess() {
 
 void TensorAccess::release() {
     m_tensor->accessFinished();
+    m_storage.reset();
 }
 
 float* TensorAccess::getRawData() {
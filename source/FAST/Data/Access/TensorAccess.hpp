@@ -15,7 +15,13 @@ class Tensor;
 class FAST_EXPORT TensorAccess {
     public:
         typedef std::unique_ptr<TensorAccess> pointer;
-        TensorAccess(float* data, TensorShape shape, std::shared_ptr<Tensor> tensor);
+        /**
+         * @param data
+         * @param shape
+         * @param tensor
+         * @param storage Optional shared storage of the data, kept alive until this access is released
+         */
+        TensorAccess(float* data, TensorShape shape, std::shared_ptr<Tensor> tensor, std::shared_ptr<float[]> storage = nullptr);
         float * getRawData();
         TensorShape getShape() const;
         ~TensorAccess();
@@ -26,6 +32,7 @@ class FAST_EXPORT TensorAccess {
         std::shared_ptr<Tensor> m_tensor;
         TensorShape m_shape;
         float* m_data;
+        std::shared_ptr<float[]> m_storage;
 };
 
 
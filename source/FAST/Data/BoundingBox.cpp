@@ -158,6 +158,8 @@ BoundingBoxSetAccess::pointer BoundingBoxSet::getAccess(accessType type) {
 		fun->glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, mNrOfLines/4*sizeof(uchar), m_labels.data());
 		fun->glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+        m_spatialIndex.clear();
+        m_spatialIndex.insert(mCoordinates, 0);
 
         mHostHasData = true;
         mHostDataIsUpToDate = true;
@@ -179,7 +181,7 @@ BoundingBoxSetAccess::pointer BoundingBoxSet::getAccess(accessType type) {
         mDataIsBeingAccessed = true;
     }
 
-    BoundingBoxSetAccess::pointer accessObject(new BoundingBoxSetAccess(&mCoordinates, &mLines, &m_labels, &m_scores, &m_minimumSize, std::static_pointer_cast<BoundingBoxSet>(mPtr.lock())));
+    BoundingBoxSetAccess::pointer accessObject(new BoundingBoxSetAccess(&mCoordinates, &mLines, &m_labels, &m_scores, &m_minimumSize, &m_spatialIndex, std::static_pointer_cast<BoundingBoxSet>(mPtr.lock())));
 	return std::move(accessObject);
 }
 
@@ -324,6 +326,7 @@ void BoundingBoxSet::freeAll() {
 
     mCoordinates.clear();
     mLines.clear();
+    m_spatialIndex.clear();
     mHostHasData = false;
 }
 
@@ -332,6 +335,7 @@ void BoundingBoxSet::free(ExecutionDevice::pointer device) {
     if(device->isHost()) {
         mCoordinates.clear();
         mLines.clear();
+        m_spatialIndex.clear();
         mHostHasData = false;
     } else {
     }
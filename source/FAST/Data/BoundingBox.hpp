@@ -95,6 +95,9 @@ class FAST_EXPORT BoundingBoxSet : public SpatialDataObject {
         bool mIsInitialized;
 
         float m_minimumSize;
+
+        // Spatial index of the boxes in host data, used for region queries
+        BoundingBoxSpatialIndex m_spatialIndex;
 };
 
 /**
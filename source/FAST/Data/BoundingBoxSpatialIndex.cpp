@@ -0,0 +1,122 @@
+#include "BoundingBoxSpatialIndex.hpp"
+#include <algorithm>
+
+namespace fast {
+
+// Boxes which overlap more cells than this in any direction, are not stored in the grid
+static const int maxCellsPerBox = 64;
+
+BoundingBoxSpatialIndex::BoundingBoxSpatialIndex(float cellSize) {
+    m_autoCellSize = cellSize <= 0.0f;
+    m_cellSize = cellSize;
+}
+
+void BoundingBoxSpatialIndex::setCellSize(float cellSize) {
+    m_autoCellSize = cellSize <= 0.0f;
+    m_cellSize = cellSize;
+    auto boxes = std::move(m_boxes);
+    clear();
+    for(auto&& box : boxes)
+        insert(box.id, box.min, box.max);
+}
+
+float BoundingBoxSpatialIndex::getCellSize() const {
+    return m_cellSize;
+}
+
+Vector2i BoundingBoxSpatialIndex::getCell(Vector2f position) const {
+    return Vector2i((int)std::floor(position.x() / m_cellSize), (int)std::floor(position.y() / m_cellSize));
+}
+
+int64_t BoundingBoxSpatialIndex::getCellKey(int x, int y) {
+    return ((int64_t)x << 32) | (uint32_t)y;
+}
+
+void BoundingBoxSpatialIndex::insert(uint id, Vector2f min, Vector2f max) {
+    if(m_cellSize <= 0.0f) {
+        // Select cell size from the first box
+        m_cellSize = std::max(16.0f*(max - min).maxCoeff(), 1.0f);
+    }
+    const uint index = m_boxes.size();
+    m_boxes.push_back({id, min, max});
+    const Vector2i first = getCell(min);
+    const Vector2i last = getCell(max);
+    if(last.x() - first.x() >= maxCellsPerBox || last.y() - first.y() >= maxCellsPerBox) {
+        m_largeBoxes.push_back(index);
+        return;
+    }
+    for(int y = first.y(); y <= last.y(); ++y) {
+        for(int x = first.x(); x <= last.x(); ++x) {
+            m_cells[getCellKey(x, y)].push_back(index);
+        }
+    }
+}
+
+void BoundingBoxSpatialIndex::insert(const std::vector<float>& coordinates, uint firstBox) {
+    for(std::size_t i = 0; i + 12 <= coordinates.size(); i += 12) {
+        Vector2f min(coordinates[i], coordinates[i + 1]);
+        Vector2f max = min;
+        for(int j = 1; j < 4; ++j) {
+            const Vector2f vertex(coordinates[i + j*3], coordinates[i + j*3 + 1]);
+            min = min.cwiseMin(vertex);
+            max = max.cwiseMax(vertex);
+        }
+        insert(firstBox + i/12, min, max);
+    }
+}
+
+std::vector<uint> BoundingBoxSpatialIndex::query(Vector2f min, Vector2f max) const {
+    std::vector<uint> result;
+    if(m_boxes.empty())
+        return result;
+    auto overlaps = [&min, &max](const Box& box) {
+        return box.min.x() <= max.x() && box.max.x() >= min.x() && box.min.y() <= max.y() && box.max.y() >= min.y();
+    };
+    const Vector2i first = getCell(min);
+    const Vector2i last = getCell(max);
+    if((int64_t)(last.x() - first.x() + 1)*(last.y() - first.y() + 1) >= (int64_t)m_cells.size()) {
+        // Region covers more cells than there are non-empty cells, thus check all boxes
+        for(auto&& box : m_boxes) {
+            if(overlaps(box))
+                result.push_back(box.id);
+        }
+    } else {
+        for(int y = first.y(); y <= last.y(); ++y) {
+            for(int x = first.x(); x <= last.x(); ++x) {
+                auto cell = m_cells.find(getCellKey(x, y));
+                if(cell == m_cells.end())
+                    continue;
+                for(uint index : cell->second) {
+                    const Box& box = m_boxes[index];
+                    if(!overlaps(box))
+                        continue;
+                    // A box may be in several cells. Only report it from the cell where
+                    // the overlap between the box and the region starts, to avoid duplicates.
+                    const Vector2i start = getCell(box.min.cwiseMax(min));
+                    if(start.x() == x && start.y() == y)
+                        result.push_back(box.id);
+                }
+            }
+        }
+        for(uint index : m_largeBoxes) {
+            if(overlaps(m_boxes[index]))
+                result.push_back(m_boxes[index].id);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void BoundingBoxSpatialIndex::clear() {
+    m_cells.clear();
+    m_largeBoxes.clear();
+    m_boxes.clear();
+    if(m_autoCellSize)
+        m_cellSize = 0.0f;
+}
+
+std::size_t BoundingBoxSpatialIndex::getNrOfBoxes() const {
+    return m_boxes.size();
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <FAST/Data/DataTypes.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace fast {
+
+/**
+ * @brief A grid based spatial index for 2D bounding boxes
+ *
+ * Each box is stored in all the grid cells it overlaps. The cells are kept in a hash map, thus the index can grow
+ * without bounds as boxes are added, e.g. when accumulating detections over a whole slide image.
+ * Boxes which overlap very many cells are kept in a separate list which is checked by every query.
+ *
+ * @sa BoundingBoxSet
+ */
+class FAST_EXPORT BoundingBoxSpatialIndex {
+    public:
+        /**
+         * @brief Create index
+         * @param cellSize Size of each grid cell. If <= 0, it is set to 16 times the size of the first box inserted.
+         */
+        explicit BoundingBoxSpatialIndex(float cellSize = 0.0f);
+        /**
+         * @brief Set size of each grid cell. Any existing boxes are reinserted.
+         * @param cellSize If <= 0, it is set to 16 times the size of the first box inserted.
+         */
+        void setCellSize(float cellSize);
+        float getCellSize() const;
+        /**
+         * @brief Add a box to the index
+         * @param id Identifier of the box, usually the index of the box in the BoundingBoxSet
+         * @param min Smallest corner of the box
+         * @param max Largest corner of the box
+         */
+        void insert(uint id, Vector2f min, Vector2f max);
+        /**
+         * @brief Add boxes stored as four 3D vertices per box, as in BoundingBoxSet
+         * @param coordinates Vertex coordinates (x, y, z) of each box
+         * @param firstBox Identifier of the first box in coordinates. The following boxes get consecutive identifiers.
+         */
+        void insert(const std::vector<float>& coordinates, uint firstBox);
+        /**
+         * @brief Find all boxes which overlap a region
+         * @param min Smallest corner of the region
+         * @param max Largest corner of the region
+         * @return sorted list of box identifiers
+         */
+        std::vector<uint> query(Vector2f min, Vector2f max) const;
+        void clear();
+        std::size_t getNrOfBoxes() const;
+    private:
+        struct Box {
+            uint id;
+            Vector2f min;
+            Vector2f max;
+        };
+        Vector2i getCell(Vector2f position) const;
+        static int64_t getCellKey(int x, int y);
+
+        float m_cellSize;
+        bool m_autoCellSize;
+        std::unordered_map<int64_t, std::vector<uint>> m_cells; // Indices into m_boxes
+        std::vector<uint> m_largeBoxes; // Indices into m_boxes
+        std::vector<Box> m_boxes;
+};
+
+}
@@ -100,32 +100,45 @@ unique_pixel_ptr adaptImageDataToHostData(unique_pixel_ptr data, cl_channel_orde
 
 
 void Image::transferCLImageFromHost(OpenCLDevice::pointer device) {
+    // The upload is done on a transfer queue without blocking. The main command queue is made to wait for it
+    // when an OpenCL access is requested, see getUploadEvents.
+    auto queue = device->getTransferQueue();
+    cl::Event event;
+    std::shared_ptr<void> tempDataHolder;
 
     // Special treatment for images with 3 channels because an OpenCL image can only have 1, 2 or 4 channels
 	// And if the device does not support 1 or 2 channels
     cl::ImageFormat format = getOpenCLImageFormat(device, mDimensions == 2 ? CL_MEM_OBJECT_IMAGE2D : CL_MEM_OBJECT_IMAGE3D, mType, mChannels);
     if(format.image_channel_order == CL_RGBA && mChannels != 4) {
         auto tempData = adaptDataToImage(mHostData.get(), CL_RGBA, mWidth*mHeight*mDepth, mType, mChannels);
-        device->getCommandQueue().enqueueWriteImage(*(cl::Image*)mCLImages[device],
-        CL_TRUE, createOrigoRegion(), createRegion(mWidth, mHeight, mDepth), 0,
-                0, (void*)tempData);
-        deleteArray((void*)tempData, mType);
+        const DataType type = mType;
+        tempDataHolder = std::shared_ptr<void>((void*)tempData, [type](void* data) { deleteArray(data, type); });
+        queue.enqueueWriteImage(*(cl::Image*)mCLImages[device],
+        CL_FALSE, createOrigoRegion(), createRegion(mWidth, mHeight, mDepth), 0,
+                0, (void*)tempData, nullptr, &event);
     } else {
-        device->getCommandQueue().enqueueWriteImage(*(cl::Image*)mCLImages[device],
-        CL_TRUE, createOrigoRegion(), createRegion(mWidth, mHeight, mDepth), 0,
-                0, mHostData.get());
+        queue.enqueueWriteImage(*(cl::Image*)mCLImages[device],
+        CL_FALSE, createOrigoRegion(), createRegion(mWidth, mHeight, mDepth), 0,
+                0, mHostData.get(), nullptr, &event);
     }
+    queue.flush();
+    mCLUploadEvents[device] = event;
+    mCLPendingUploads.push_back({event, tempDataHolder});
+    mCLWriteEvents.erase(device);
 }
 
 void Image::transferCLImageToHost(OpenCLDevice::pointer device) {
+    // Read on a transfer queue, after the writes to the image are done
+    auto queue = device->getTransferQueue();
+    std::vector<cl::Event> events = getWriteEvents(device);
     // Special treatment for images with 3 channels because an OpenCL image can only have 1, 2 or 4 channels
 	// And if the device does not support 1 or 2 channels
     cl::ImageFormat format = getOpenCLImageFormat(device, mDimensions == 2 ? CL_MEM_OBJECT_IMAGE2D : CL_MEM_OBJECT_IMAGE3D, mType, mChannels);
     if(format.image_channel_order == CL_RGBA && mChannels != 4) {
         auto tempData = allocatePixelArray(mWidth*mHeight*mDepth*4, mType);
-        device->getCommandQueue().enqueueReadImage(*(cl::Image*)mCLImages[device],
+        queue.enqueueReadImage(*(cl::Image*)mCLImages[device],
         CL_TRUE, createOrigoRegion(), createRegion(mWidth, mHeight, mDepth), 0,
-                0, tempData.get());
+                0, tempData.get(), &events);
         mHostData = adaptImageDataToHostData(std::move(tempData), CL_RGBA, mWidth*mHeight*mDepth,mType,mChannels);
     } else {
         if(!mHostHasData) {
@@ -133,10 +146,47 @@ void Image::transferCLImageToHost(OpenCLDevice::pointer device) {
             mHostData = allocatePixelArray(mWidth*mHeight*mDepth*mChannels,mType);
 			mHostHasData = true;
         }
-        device->getCommandQueue().enqueueReadImage(*(cl::Image*)mCLImages[device],
+        queue.enqueueReadImage(*(cl::Image*)mCLImages[device],
         CL_TRUE, createOrigoRegion(), createRegion(mWidth, mHeight, mDepth), 0,
-                0, mHostData.get());
+                0, mHostData.get(), &events);
+    }
+}
+
+void Image::finishUploads() {
+    for(auto&& upload : mCLPendingUploads)
+        upload.first.wait();
+    mCLPendingUploads.clear();
+    mCLUploadEvents.clear();
+}
+
+std::vector<cl::Event> Image::getUploadEvents(OpenCLDevice::pointer device) {
+    std::vector<cl::Event> events;
+    auto it = mCLUploadEvents.find(device);
+    if(it == mCLUploadEvents.end())
+        return events;
+    if(it->second.getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>() == CL_COMPLETE) {
+        mCLUploadEvents.erase(it);
+        return events;
     }
+    events.push_back(it->second);
+    // Make the main command queue wait for the upload, without blocking the host
+    device->getCommandQueue().enqueueBarrierWithWaitList(&events);
+    return events;
+}
+
+std::vector<cl::Event> Image::getWriteEvents(OpenCLDevice::pointer device) {
+    auto it = mCLWriteEvents.find(device);
+    if(it != mCLWriteEvents.end())
+        return {it->second};
+    // No write event was given, thus wait for all work enqueued so far on the main command queue
+    cl::Event marker;
+    device->getCommandQueue().enqueueMarkerWithWaitList(nullptr, &marker);
+    device->getCommandQueue().flush();
+    return {marker};
+}
+
+void Image::setOpenCLWriteEvent(OpenCLDevice::pointer device, cl::Event event) {
+    mCLWriteEvents[device] = event;
 }
 
 bool Image::hasAnyData() {
@@ -226,9 +276,11 @@ OpenCLBufferAccess::pointer Image::getOpenCLBufferAccess(
         mDataIsBeingWrittenTo = true;
     }
     updateOpenCLBufferData(device);
+    auto events = getUploadEvents(device);
     if(type == ACCESS_READ_WRITE) {
         setAllDataToOutOfDate();
         updateModifiedTimestamp();
+        mCLWriteEvents.erase(device);
     }
     mCLBuffersIsUpToDate[device] = true;
     {
@@ -236,8 +288,8 @@ OpenCLBufferAccess::pointer Image::getOpenCLBufferAccess(
         mDataIsBeingAccessed = true;
     }
 
-    // Now it is guaranteed that the data is on the device and that it is up to date
-	OpenCLBufferAccess::pointer accessObject(new OpenCLBufferAccess(mCLBuffers[device],  std::static_pointer_cast<Image>(mPtr.lock())));
+    // Now it is guaranteed that the data is on the device, and that the main command queue waits for any upload
+	OpenCLBufferAccess::pointer accessObject(new OpenCLBufferAccess(mCLBuffers[device],  std::static_pointer_cast<Image>(mPtr.lock()), device, events));
 	return std::move(accessObject);
 }
 
@@ -317,8 +369,14 @@ void Image::updateOpenCLBufferData(OpenCLDevice::pointer device) {
 
 void Image::transferCLBufferFromHost(OpenCLDevice::pointer device) {
     unsigned int bufferSize = getBufferSize();
-    device->getCommandQueue().enqueueWriteBuffer(*mCLBuffers[device],
-        CL_TRUE, 0, bufferSize, mHostData.get());
+    auto queue = device->getTransferQueue();
+    cl::Event event;
+    queue.enqueueWriteBuffer(*mCLBuffers[device],
+        CL_FALSE, 0, bufferSize, mHostData.get(), nullptr, &event);
+    queue.flush();
+    mCLUploadEvents[device] = event;
+    mCLPendingUploads.push_back({event, nullptr});
+    mCLWriteEvents.erase(device);
 }
 
 void Image::transferCLBufferToHost(OpenCLDevice::pointer device) {
@@ -328,14 +386,16 @@ void Image::transferCLBufferToHost(OpenCLDevice::pointer device) {
 		mHostHasData = true;
 	}
     unsigned int bufferSize = getBufferSize();
-    device->getCommandQueue().enqueueReadBuffer(*mCLBuffers[device],
-        CL_TRUE, 0, bufferSize, mHostData.get());
+    std::vector<cl::Event> events = getWriteEvents(device);
+    device->getTransferQueue().enqueueReadBuffer(*mCLBuffers[device],
+        CL_TRUE, 0, bufferSize, mHostData.get(), &events);
 }
 
 void Image::updateHostData() {
     // It is the host data that has been modified, no need to update
     if (mHostDataIsUpToDate)
         return;
+    finishUploads();
 
     bool updated = false;
     if (!mHostHasData) {
@@ -408,9 +468,11 @@ OpenCLImageAccess::pointer Image::getOpenCLImageAccess(
         mDataIsBeingWrittenTo = true;
     }
     updateOpenCLImageData(device);
+    auto events = getUploadEvents(device);
     if (type == ACCESS_READ_WRITE) {
         setAllDataToOutOfDate();
         updateModifiedTimestamp();
+        mCLWriteEvents.erase(device);
     }
     {
         std::lock_guard<std::mutex> lock(mDataIsBeingAccessedMutex);
@@ -418,12 +480,12 @@ OpenCLImageAccess::pointer Image::getOpenCLImageAccess(
     }
     mCLImagesIsUpToDate[device] = true;
 
-    // Now it is guaranteed that the data is on the device and that it is up to date
+    // Now it is guaranteed that the data is on the device, and that the main command queue waits for any upload
     if(mDimensions == 2) {
-        OpenCLImageAccess::pointer accessObject(new OpenCLImageAccess((cl::Image2D*)mCLImages[device], std::static_pointer_cast<Image>(mPtr.lock())));
+        OpenCLImageAccess::pointer accessObject(new OpenCLImageAccess((cl::Image2D*)mCLImages[device], std::static_pointer_cast<Image>(mPtr.lock()), device, events));
         return accessObject;
     } else {
-        OpenCLImageAccess::pointer accessObject(new OpenCLImageAccess((cl::Image3D*)mCLImages[device], std::static_pointer_cast<Image>(mPtr.lock())));
+        OpenCLImageAccess::pointer accessObject(new OpenCLImageAccess((cl::Image3D*)mCLImages[device], std::static_pointer_cast<Image>(mPtr.lock()), device, events));
         return accessObject;
     }
 }
@@ -450,6 +512,8 @@ ImageAccess::pointer Image::getImageAccess(accessType type) {
     }
     updateHostData();
     if(type == ACCESS_READ_WRITE) {
+        // Uploads from the host data must be done before it is changed
+        finishUploads();
         setAllDataToOutOfDate();
         updateModifiedTimestamp();
     }
@@ -694,6 +758,16 @@ void Image::setData(ExecutionDevice::pointer device, void* data) {
     mIsInitialized = true;
 }
 
+Image::pointer Image::create(VectorXui size, DataType type, uint nrOfChannels, unique_pixel_ptr data) {
+    auto resPtr = std::shared_ptr<Image>(new Image());
+    resPtr->setPtr(resPtr);
+    resPtr->init(size, type, nrOfChannels);
+    resPtr->mHostData = std::move(data);
+    resPtr->mHostHasData = true;
+    resPtr->mHostDataIsUpToDate = true;
+    return resPtr;
+}
+
 bool Image::isInitialized() const {
     return mIsInitialized;
 }
@@ -701,6 +775,7 @@ bool Image::isInitialized() const {
 void Image::free(ExecutionDevice::pointer device) {
     // Delete data on a specific device
     if(device->isHost()) {
+        finishUploads();
         mHostData.reset();
         mHostHasData = false;
     } else {
@@ -713,10 +788,13 @@ void Image::free(ExecutionDevice::pointer device) {
         delete mCLBuffers[clDevice];
         mCLBuffers.erase(clDevice);
         mCLBuffersIsUpToDate.erase(clDevice);
+        mCLWriteEvents.erase(clDevice);
     }
 }
 
 void Image::freeAll() {
+    finishUploads();
+    mCLWriteEvents.clear();
     // Delete OpenCL Images
     std::unordered_map<OpenCLDevice::pointer, cl::Image*>::iterator it;
     for (it = mCLImages.begin(); it != mCLImages.end(); it++) {
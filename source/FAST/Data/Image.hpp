@@ -232,11 +232,34 @@ class FAST_EXPORT Image : public SpatialDataObject {
          */
         template <class T>
         static Image::pointer create(VectorXui, DataType type, uint nrOfChannels, std::unique_ptr<T> ptr);
+#ifndef SWIG
+        /**
+         * Moves the 2D/3D host data pointer to the image without copying it.
+         * The deleter of the pointer is called when the host data is freed, this enables
+         * host data which is not allocated with new[], e.g. a memory mapped file.
+         *
+         * @param size
+         * @param type
+         * @param nrOfChannels
+         * @param data
+         */
+        static Image::pointer create(VectorXui size, DataType type, uint nrOfChannels, unique_pixel_ptr data);
+#endif
 
         OpenCLImageAccess::pointer getOpenCLImageAccess(accessType type, OpenCLDevice::pointer);
         OpenCLBufferAccess::pointer getOpenCLBufferAccess(accessType type, OpenCLDevice::pointer);
         ImageAccess::pointer getImageAccess(accessType type);
         OpenGLTextureAccess::pointer getOpenGLTextureAccess(accessType type, OpenCLDevice::pointer, bool compress = false, bool getOwnership = false);
+        /**
+         * @brief Set event which completes when all writes to the OpenCL data on the given device are done.
+         *
+         * Transfers back to the host will wait for this event instead of all work on the main command queue.
+         * Is normally set through OpenCLImageAccess::setWriteEvent or OpenCLBufferAccess::setWriteEvent.
+         * The event is cleared when new write access is requested.
+         * @param device
+         * @param event
+         */
+        void setOpenCLWriteEvent(OpenCLDevice::pointer device, cl::Event event);
 
         ~Image();
 
@@ -328,6 +351,16 @@ class FAST_EXPORT Image : public SpatialDataObject {
         bool mHostHasData;
         bool mHostDataIsUpToDate;
 
+        // Uploads from host to OpenCL devices are non-blocking. The host data, and any temporary data,
+        // must be kept until they are done.
+        std::unordered_map<OpenCLDevice::pointer, cl::Event> mCLUploadEvents;
+        std::vector<std::pair<cl::Event, std::shared_ptr<void>>> mCLPendingUploads;
+        // Events which complete when all writes to the OpenCL data on a device are done
+        std::unordered_map<OpenCLDevice::pointer, cl::Event> mCLWriteEvents;
+        void finishUploads();
+        std::vector<cl::Event> getUploadEvents(OpenCLDevice::pointer device);
+        std::vector<cl::Event> getWriteEvents(OpenCLDevice::pointer device);
+
         // OpenGL data
         uint m_GLtextureID = 0;
         bool m_GLtextureUpToDate = false;
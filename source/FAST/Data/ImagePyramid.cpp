@@ -8,6 +8,7 @@
 #include <FAST/Utility.hpp>
 #include <FAST/Data/Image.hpp>
 #include <FAST/Data/Access/ImagePyramidAccess.hpp>
+#include <algorithm>
 #include <utility>
 #ifdef WIN32
 #include <winbase.h>
@@ -267,7 +268,14 @@ void ImagePyramid::freeAll() {
         m_levels.clear();
         openslide_close(m_fileHandle);
     } else if(m_tiffHandle != nullptr) {
+        try {
+            waitForPendingTileWrites();
+        } catch(std::exception &e) {
+            reportWarning() << "Failed to write tile to TIFF image pyramid: " << e.what() << reportEnd();
+        }
+        m_tileEncodingPool.reset();
         m_levels.clear();
+        closeFreeTIFFHandles();
         TIFFClose(m_tiffHandle);
         if(m_tempFile) {
             // If this is a temp file created by FAST. Delete it.
@@ -290,8 +298,10 @@ void ImagePyramid::freeAll() {
         m_levels.clear();
     }
 
+	m_tileCache.clear();
 	m_initialized = false;
 	m_fileHandle = nullptr;
+	m_tiffHandle = nullptr;
 }
 
 ImagePyramid::~ImagePyramid() {
@@ -354,6 +364,7 @@ void ImagePyramid::setSpacing(Vector3f spacing) {
         // Write spacing to TIFF file
 		if(spacing.x() != 1 && spacing.y() != 1) { // Spacing == 1 means not set.
             auto access = getAccess(ACCESS_READ_WRITE); // Ensure we have exclusive access to TIFF
+            waitForPendingTileWrites();
             for(int level = 0; level < getNrOfLevels(); ++level) {
                 TIFFSetDirectory(m_tiffHandle, level);
                 TIFFSetField(m_tiffHandle, TIFFTAG_RESOLUTIONUNIT, RESUNIT_CENTIMETER);
@@ -378,6 +389,7 @@ ImagePyramid::ImagePyramid(TIFF *fileHandle, std::vector<ImagePyramidLevel> leve
     if(channels <= 0 || channels > 4)
         throw Exception("Nr of channels must be between 1 and 4 in ImagePyramid when importing from TIFF");
     m_tiffHandle = fileHandle;
+    m_tiffPath = TIFFFileName(fileHandle);
     m_levels = levels;
     m_channels = channels;
     for(int i = 0; i < m_levels.size(); ++i) {
@@ -474,6 +486,210 @@ ImagePyramid::ImagePyramid(TIFF *fileHandle, std::vector<ImagePyramidLevel> leve
     m_initialized = true;
     m_pyramidFullyInitialized = true;
     m_counter += 1;
+    // File is read only, and thus each thread can safely open its own handle
+    if(m_compressionFormat != ImageCompression::NEURAL_NETWORK)
+        m_multiThreadedTIFFReading = true;
+}
+
+void ImagePyramid::setMultiThreadedTIFFReading(bool enable) {
+    if(enable) {
+        if(!usesTIFF() || !m_pyramidFullyInitialized)
+            throw Exception("Multi-threaded TIFF reading is only available for TIFF image pyramids which are not being written to");
+        if(m_compressionFormat == ImageCompression::NEURAL_NETWORK)
+            throw Exception("Multi-threaded TIFF reading is not supported with neural network compression");
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_tiffHandlesMutex);
+        m_multiThreadedTIFFReading = enable;
+    }
+    if(!enable) {
+        closeFreeTIFFHandles();
+        m_tiffHandleReturned.notify_all();
+    }
+}
+
+bool ImagePyramid::isMultiThreadedTIFFReading() const {
+    return m_multiThreadedTIFFReading;
+}
+
+TIFF* ImagePyramid::checkoutTIFFHandle() {
+    std::unique_lock<std::mutex> lock(m_tiffHandlesMutex);
+    // Limit nr of open file handles, as threads may be short lived
+    const int maxHandles = std::max(1, (int)std::thread::hardware_concurrency());
+    m_tiffHandleReturned.wait(lock, [this, maxHandles]() {
+        return !m_multiThreadedTIFFReading || !m_freeTIFFHandles.empty() || m_openTIFFHandles < maxHandles;
+    });
+    if(!m_multiThreadedTIFFReading)
+        return nullptr;
+    if(!m_freeTIFFHandles.empty()) {
+        TIFF* tiff = m_freeTIFFHandles.back();
+        m_freeTIFFHandles.pop_back();
+        return tiff;
+    }
+    TIFF* tiff = TIFFOpen(m_tiffPath.c_str(), "rm");
+    if(tiff == nullptr)
+        throw Exception("Failed to open TIFF file " + m_tiffPath + " for reading");
+    ++m_openTIFFHandles;
+    return tiff;
+}
+
+void ImagePyramid::returnTIFFHandle(TIFF* tiff) {
+    {
+        std::lock_guard<std::mutex> lock(m_tiffHandlesMutex);
+        if(m_multiThreadedTIFFReading) {
+            m_freeTIFFHandles.push_back(tiff);
+        } else {
+            TIFFClose(tiff);
+            --m_openTIFFHandles;
+        }
+    }
+    m_tiffHandleReturned.notify_one();
+}
+
+void ImagePyramid::setTileEncodingThreads(int threads) {
+    if(threads < 0)
+        throw Exception("Number of tile encoding threads must be >= 0");
+    waitForPendingTileWrites();
+    std::lock_guard<std::mutex> lock(m_pendingTileWritesMutex);
+    m_tileEncodingThreads = threads;
+    m_tileEncodingPool.reset();
+}
+
+int ImagePyramid::getTileEncodingThreads() const {
+    return m_tileEncodingThreads;
+}
+
+void ImagePyramid::addPendingTileWrite(int level, int tileX, int tileY, std::function<void()> write) {
+    const std::string tileString = std::to_string(level) + "_" + std::to_string(tileX) + "_" + std::to_string(tileY);
+    // Writes to the same tile must happen in order. Thus each write is registered under the lock, together with
+    // the previous write of the same tile, but the write itself, and waiting for the previous write, is done
+    // without holding the lock, so that writes of other tiles are not blocked.
+    std::shared_future<void> previous;
+    std::promise<void> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingTileWritesMutex);
+        if(m_pendingTileWrites.size() > 1024) {
+            // Remove writes which have finished successfully. Failed writes are kept, so that the error is reported
+            // to the next reader or writer of that tile, or by waitForPendingTileWrites.
+            for(auto it = m_pendingTileWrites.begin(); it != m_pendingTileWrites.end();) {
+                bool remove = false;
+                if(it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                    try {
+                        it->second.get();
+                        remove = true;
+                    } catch(...) {
+                    }
+                }
+                if(remove) {
+                    it = m_pendingTileWrites.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        auto it = m_pendingTileWrites.find(tileString);
+        if(it != m_pendingTileWrites.end())
+            previous = it->second;
+        if(m_tileEncodingThreads > 0) {
+            if(!m_tileEncodingPool)
+                m_tileEncodingPool = std::make_unique<ThreadPool>(m_tileEncodingThreads);
+            // Tasks are started in the order they are submitted, thus the previous write has already started
+            m_pendingTileWrites[tileString] = m_tileEncodingPool->submit([previous, write]() {
+                if(previous.valid())
+                    previous.get(); // Throws if the previous write of this tile failed
+                write();
+            }).share();
+            return;
+        }
+        m_pendingTileWrites[tileString] = finished.get_future().share();
+    }
+    // Synchronous write in the calling thread. Any error is thrown to the caller, thus readers of this tile
+    // only need to wait for it to finish.
+    try {
+        if(previous.valid())
+            previous.get(); // Throws if the previous write of this tile failed
+        write();
+    } catch(...) {
+        finished.set_value();
+        throw;
+    }
+    finished.set_value();
+}
+
+void ImagePyramid::waitForPendingTileWrite(int level, int tileX, int tileY) {
+    const std::string tileString = std::to_string(level) + "_" + std::to_string(tileX) + "_" + std::to_string(tileY);
+    std::shared_future<void> future;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingTileWritesMutex);
+        auto it = m_pendingTileWrites.find(tileString);
+        if(it == m_pendingTileWrites.end())
+            return;
+        future = it->second;
+        m_pendingTileWrites.erase(it);
+    }
+    future.get();
+}
+
+void ImagePyramid::waitForPendingTileWrites() {
+    std::unordered_map<std::string, std::shared_future<void>> pendingTileWrites;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingTileWritesMutex);
+        pendingTileWrites.swap(m_pendingTileWrites);
+    }
+    for(auto&& item : pendingTileWrites)
+        item.second.get();
+}
+
+void ImagePyramid::setDeferredLevelConstruction(bool deferred) {
+    m_deferredLevelConstruction = deferred;
+}
+
+bool ImagePyramid::isDeferredLevelConstruction() const {
+    return m_deferredLevelConstruction;
+}
+
+void ImagePyramid::addPendingLevelConstructionTile(int level, int tileX, int tileY) {
+    std::lock_guard<std::mutex> lock(m_pendingLevelConstructionMutex);
+    m_pendingLevelConstructionTiles[level].insert({tileX, tileY});
+}
+
+std::map<int, std::set<std::pair<int, int>>> ImagePyramid::takePendingLevelConstructionTiles() {
+    std::map<int, std::set<std::pair<int, int>>> tiles;
+    std::lock_guard<std::mutex> lock(m_pendingLevelConstructionMutex);
+    tiles.swap(m_pendingLevelConstructionTiles);
+    return tiles;
+}
+
+LRUCache<std::string, std::shared_ptr<uchar[]>>& ImagePyramid::getTileCache() {
+    return m_tileCache;
+}
+
+void ImagePyramid::setTileCacheSize(std::size_t bytes) {
+    m_tileCache.setMaxSize(bytes);
+}
+
+std::size_t ImagePyramid::getTileCacheSize() const {
+    return m_tileCache.getMaxSize();
+}
+
+uint64_t ImagePyramid::getTileCacheHits() const {
+    return m_tileCache.getHits();
+}
+
+uint64_t ImagePyramid::getTileCacheMisses() const {
+    return m_tileCache.getMisses();
+}
+
+void ImagePyramid::clearTileCache() {
+    m_tileCache.clear();
+}
+
+void ImagePyramid::closeFreeTIFFHandles() {
+    std::lock_guard<std::mutex> lock(m_tiffHandlesMutex);
+    for(auto tiff : m_freeTIFFHandles)
+        TIFFClose(tiff);
+    m_openTIFFHandles -= (int)m_freeTIFFHandles.size();
+    m_freeTIFFHandles.clear();
 }
 
 bool ImagePyramid::isBGRA() const {
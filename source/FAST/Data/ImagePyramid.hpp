@@ -3,7 +3,12 @@
 #include <FAST/Data/SpatialDataObject.hpp>
 #include <FAST/Data/Access/Access.hpp>
 #include <FAST/Data/Access/ImagePyramidAccess.hpp>
+#include <FAST/ThreadPool.hpp>
+#include <FAST/LRUCache.hpp>
+#include <condition_variable>
+#include <map>
 #include <set>
+#include <thread>
 
 
 namespace fast {
@@ -103,6 +108,113 @@ class FAST_EXPORT ImagePyramid : public SpatialDataObject {
         DataType getDataType() const;
         float getMagnification() const;
         void setMagnification(float magnification);
+        /**
+         * @brief Use a pool of read-only TIFF handles when reading tiles
+         *
+         * With this mode enabled, tiles are read and decompressed without holding the lock which is shared
+         * by all accesses of this pyramid, thus decoding can run in parallel in multiple threads.
+         * A thread checks out a handle from the pool for each read, and returns it afterwards.
+         * At most one handle per hardware thread is opened. If all are in use, readers wait for one to be returned.
+         * The handles are closed when this mode is disabled, or the pyramid is freed.
+         * Only available for TIFF files which are fully initialized, i.e. not being written to.
+         * This is enabled by default for TIFF image pyramids imported from disk.
+         *
+         * @param enable
+         */
+        void setMultiThreadedTIFFReading(bool enable);
+        bool isMultiThreadedTIFFReading() const;
+#ifndef SWIG
+        /**
+         * @brief Check out a read-only TIFF handle from the pool. It must be given back with returnTIFFHandle.
+         * @return TIFF handle, or nullptr if multi-threaded TIFF reading is disabled
+         */
+        TIFF* checkoutTIFFHandle();
+        /**
+         * @brief Give back a TIFF handle from checkoutTIFFHandle to the pool
+         * @param tiff
+         */
+        void returnTIFFHandle(TIFF* tiff);
+#endif
+        /**
+         * @brief Set number of threads used to encode JPEG and JPEG XL tiles when writing to this pyramid
+         *
+         * Tiles are compressed in parallel in a thread pool, and only the final write of the compressed tile
+         * to the TIFF file is serialized. Reading a tile which is being encoded will block until it is written.
+         *
+         * @param threads Number of threads. If 0, tiles are encoded synchronously in the thread calling setPatch,
+         *      tiles set from different threads are then still compressed in parallel. Default is 0.
+         */
+        void setTileEncodingThreads(int threads);
+        int getTileEncodingThreads() const;
+        /**
+         * @brief Block until all tiles queued for encoding have been written to the TIFF file
+         */
+        void waitForPendingTileWrites();
+#ifndef SWIG
+        /**
+         * @brief Queue a write of a tile to the TIFF file
+         *
+         * The write is run in the tile encoding thread pool, or directly if encoding threads is 0.
+         * Writes to the same tile are done in order, a write waits for the previous write of the same tile
+         * to finish and fails if it failed. No lock is held during the write.
+         */
+        void addPendingTileWrite(int level, int tileX, int tileY, std::function<void()> write);
+        /**
+         * @brief Block until any queued write to the given tile has been written to the TIFF file
+         */
+        void waitForPendingTileWrite(int level, int tileX, int tileY);
+        /**
+         * @brief Get cache of decoded tiles, shared by all accesses of this pyramid
+         *
+         * Keys are level_tileX_tileY
+         */
+        LRUCache<std::string, std::shared_ptr<uchar[]>>& getTileCache();
+#endif
+        /**
+         * @brief Set maximum memory used to cache decoded tiles
+         *
+         * Decoded TIFF tiles, and tile aligned OpenSlide regions, are kept in a least recently used cache, so that
+         * multiple consumers of the same region, such as renderers and patch generators, don't have to decode it again.
+         *
+         * The cache is disabled by default, and is enabled by setting a size larger than 0.
+         * Pyramids opened by WholeSlideImageImporter and TIFFImagePyramidImporter use a 64 MB cache.
+         *
+         * @param bytes Maximum size of cache in bytes. If 0, tiles are not cached. Default is 0.
+         */
+        void setTileCacheSize(std::size_t bytes);
+        std::size_t getTileCacheSize() const;
+        /**
+         * @brief Get number of tile reads which were found in the tile cache
+         */
+        uint64_t getTileCacheHits() const;
+        /**
+         * @brief Get number of tile reads which were not found in the tile cache
+         */
+        uint64_t getTileCacheMisses() const;
+        void clearTileCache();
+        /**
+         * @brief Defer construction of the lower resolution levels when writing patches
+         *
+         * Normally, ImagePyramidAccess::setPatch downsamples the patch and rewrites one tile on every
+         * lower resolution level. With deferred level construction, setPatch only writes the given level and records
+         * which tiles have changed. All lower resolution levels are then built in one parallel pass,
+         * level by level, when ImagePyramidAccess::finalize is called.
+         *
+         * @param deferred
+         */
+        void setDeferredLevelConstruction(bool deferred);
+        bool isDeferredLevelConstruction() const;
+#ifndef SWIG
+        /**
+         * @brief Mark a tile as changed, so that the tiles covering it on lower resolution levels are rebuilt on finalize
+         */
+        void addPendingLevelConstructionTile(int level, int tileX, int tileY);
+        /**
+         * @brief Get and clear all tiles which have changed since last finalize
+         * @return map of level -> set of tile x, y
+         */
+        std::map<int, std::set<std::pair<int, int>>> takePendingLevelConstructionTiles();
+#endif
     private:
         ImagePyramid();
         std::vector<ImagePyramidLevel> m_levels;
@@ -134,6 +246,24 @@ class FAST_EXPORT ImagePyramid : public SpatialDataObject {
         // A mutex needed to control multi-threaded reading of TIFF files
         std::mutex m_readMutex;
 
+        bool m_multiThreadedTIFFReading = false;
+        std::mutex m_tiffHandlesMutex;
+        std::condition_variable m_tiffHandleReturned;
+        std::vector<TIFF*> m_freeTIFFHandles;
+        int m_openTIFFHandles = 0;
+        void closeFreeTIFFHandles();
+
+        int m_tileEncodingThreads = 0;
+        std::unique_ptr<ThreadPool> m_tileEncodingPool;
+        std::mutex m_pendingTileWritesMutex;
+        std::unordered_map<std::string, std::shared_future<void>> m_pendingTileWrites;
+
+        LRUCache<std::string, std::shared_ptr<uchar[]>> m_tileCache{0};
+
+        bool m_deferredLevelConstruction = false;
+        std::mutex m_pendingLevelConstructionMutex;
+        std::map<int, std::set<std::pair<int, int>>> m_pendingLevelConstructionTiles;
+
         std::shared_ptr<NeuralNetwork> m_compressionModel;
         std::shared_ptr<NeuralNetwork> m_decompressionModel;
         float m_decompressionOutputScaleFactor = 1.0f;
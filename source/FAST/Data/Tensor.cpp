@@ -72,6 +72,10 @@ TensorShape Tensor::getShape() const {
 }
 
 TensorAccess::pointer Tensor::getAccess(accessType type) {
+    return getAccess(type, nullptr);
+}
+
+TensorAccess::pointer Tensor::getAccess(accessType type, std::shared_ptr<float[]> storage) {
     if(!isInitialized())
         throw Exception("Tensor has not been initialized.");
 
@@ -92,7 +96,7 @@ TensorAccess::pointer Tensor::getAccess(accessType type) {
         std::unique_lock<std::mutex> lock(mDataIsBeingAccessedMutex);
         mDataIsBeingAccessed = true;
     }
-    return std::make_unique<TensorAccess>(getHostDataPointer(), m_shape, std::static_pointer_cast<Tensor>(mPtr.lock()));
+    return std::make_unique<TensorAccess>(getHostDataPointer(), m_shape, std::static_pointer_cast<Tensor>(mPtr.lock()), std::move(storage));
 }
 
 void Tensor::free(ExecutionDevice::pointer device) {
@@ -286,8 +290,61 @@ float* Tensor::getHostDataPointer() {
     return m_data.get();
 }
 
+std::shared_ptr<float[]> Tensor::getHostDataStorage() {
+    // Subclasses may store the host data elsewhere, in that case the storage is owned by the tensor itself
+    return std::shared_ptr<float[]>(m_data, getHostDataPointer());
+}
+
 Tensor::~Tensor() {
 	freeAll();
 }
 
+TensorView::TensorView(std::shared_ptr<Tensor> parent, std::size_t offset, TensorShape shape) {
+    if(offset + shape.getTotalSize() > parent->getShape().getTotalSize())
+        throw Exception("Tensor view is outside of the parent tensor");
+    init(nullptr, shape);
+    m_parent = parent;
+    m_offset = offset;
+}
+
+void TensorView::updateParentData(bool writeBack) {
+    // A short access to the parent makes sure its host data is up to date, and if data is written back, that its
+    // device data is marked as out of date. The parent access is not held while the view is accessed, instead the
+    // host data storage is shared, so that it stays valid even if the parent frees or reallocates it.
+    const bool parentModified = m_parent->getTimestamp() != m_parentTimestamp;
+    {
+        auto parentAccess = m_parent->getAccess(writeBack ? ACCESS_READ_WRITE : ACCESS_READ);
+        // The host data of the view is shared with the parent
+        m_data = m_parent->getHostDataStorage();
+    }
+    m_parentTimestamp = m_parent->getTimestamp();
+    if(parentModified && !writeBack) {
+        // The parent host data is newer than any device data of this view
+        mHostDataIsUpToDate = true;
+        for(auto& it : mCLBuffersIsUpToDate)
+            it.second = false;
+    }
+}
+
+TensorAccess::pointer TensorView::getAccess(accessType type) {
+    std::lock_guard<std::mutex> lock(m_parentDataMutex);
+    updateParentData(type == ACCESS_READ_WRITE || !mHostDataIsUpToDate);
+    return Tensor::getAccess(type, m_data);
+}
+
+std::unique_ptr<OpenCLBufferAccess> TensorView::getOpenCLBufferAccess(accessType type, OpenCLDevice::pointer device) {
+    std::lock_guard<std::mutex> lock(m_parentDataMutex);
+    // Device data of the view is copied from the parent host data
+    updateParentData(!mHostDataIsUpToDate);
+    return Tensor::getOpenCLBufferAccess(type, device);
+}
+
+float* TensorView::getHostDataPointer() {
+    return m_data.get() + m_offset;
+}
+
+bool TensorView::hasAnyData() {
+    return true;
+}
+
 }
\ No newline at end of file
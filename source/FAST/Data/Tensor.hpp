@@ -5,6 +5,7 @@
 #include <FAST/Data/Access/Access.hpp>
 #include <FAST/Data/TensorShape.hpp>
 #include <unordered_map>
+#include <mutex>
 
 namespace fast {
 
@@ -67,6 +68,7 @@ class FAST_EXPORT Tensor : public SpatialDataObject {
     protected:
         void init(std::unique_ptr<float[]> data, TensorShape shape);
         Tensor() = default;
+        TensorAccess::pointer getAccess(accessType type, std::shared_ptr<float[]> storage);
         virtual bool isInitialized();
         virtual void transferCLBufferFromHost(OpenCLDevice::pointer device);
         void transferCLBufferToHost(OpenCLDevice::pointer device);
@@ -75,8 +77,13 @@ class FAST_EXPORT Tensor : public SpatialDataObject {
         virtual bool hasAnyData();
         void updateHostData();
         virtual float* getHostDataPointer();
+        /**
+         * Get the host data as shared storage, which stays valid even if the host data of this tensor is
+         * freed or reallocated. Host data must be up to date.
+         */
+        std::shared_ptr<float[]> getHostDataStorage();
 
-        std::unique_ptr<float[]> m_data;
+        std::shared_ptr<float[]> m_data;
         std::unordered_map<std::shared_ptr<OpenCLDevice>, cl::Buffer*> mCLBuffers;
         std::unordered_map<std::shared_ptr<OpenCLDevice>, bool> mCLBuffersIsUpToDate;
         TensorShape m_shape;
@@ -86,6 +93,52 @@ class FAST_EXPORT Tensor : public SpatialDataObject {
 
         friend TensorAccess;
         friend OpenCLBufferAccess;
+        friend class TensorView;
+};
+
+#ifndef SWIG
+/**
+ * @brief A tensor which refers to a contiguous part of the host data of another tensor
+ *
+ * No data is copied, and the parent tensor is kept alive as long as the view exists.
+ * This is used to split the output of a batch into one tensor per sample.
+ * Writing to a view will modify the parent tensor.
+ * The host data of the parent is looked up on each access of the view, but the parent is not accessed while the
+ * view is accessed, thus several views of the same parent can be accessed at the same time.
+ * Writing to a view while the parent is accessed is not safe.
+ *
+ * @ingroup data neural-network
+ */
+class FAST_EXPORT TensorView : public Tensor {
+    // Reports its class name as Tensor, as TensorView is not exposed to Python, where data objects
+    // are converted to their class using getNameOfClass
+    FAST_DATA_OBJECT(Tensor)
+    public:
+        /**
+         * Create a view of a tensor
+         * @param parent Tensor to view
+         * @param offset Offset in number of elements from the start of the parent data
+         * @param shape Shape of the view
+         */
+        FAST_CONSTRUCTOR(TensorView, std::shared_ptr<Tensor>, parent,, std::size_t, offset,, TensorShape, shape,)
+        TensorAccess::pointer getAccess(accessType type) override;
+        std::unique_ptr<OpenCLBufferAccess> getOpenCLBufferAccess(accessType type, OpenCLDevice::pointer device) override;
+    protected:
+        float* getHostDataPointer() override;
+        bool hasAnyData() override;
+
+        /**
+         * Look up the current host data of the parent and store it in m_data, and mark the data of this view as out of date if the
+         * parent has been modified since last time. Must be called with m_parentDataMutex locked.
+         * @param writeBack Whether data of this view modified on a device should be written to the parent
+         */
+        void updateParentData(bool writeBack);
+
+        std::shared_ptr<Tensor> m_parent;
+        std::size_t m_offset;
+        std::mutex m_parentDataMutex;
+        uint64_t m_parentTimestamp = 0;
 };
+#endif
 
 }
\ No newline at end of file
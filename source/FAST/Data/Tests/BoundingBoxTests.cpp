@@ -0,0 +1,70 @@
+#include <FAST/Testing.hpp>
+#include <FAST/Data/BoundingBox.hpp>
+#include <FAST/Data/BoundingBoxSpatialIndex.hpp>
+
+using namespace fast;
+
+TEST_CASE("BoundingBoxSpatialIndex region query", "[fast][BoundingBox][BoundingBoxSpatialIndex]") {
+    BoundingBoxSpatialIndex index(10.0f);
+    // A grid of 100x100 boxes of size 4x4 with spacing 5
+    for(int y = 0; y < 100; ++y) {
+        for(int x = 0; x < 100; ++x) {
+            index.insert(x + y*100, Vector2f(x*5, y*5), Vector2f(x*5 + 4, y*5 + 4));
+        }
+    }
+    // A box covering everything
+    index.insert(10000, Vector2f(-1000, -1000), Vector2f(1000, 1000));
+    CHECK(index.getNrOfBoxes() == 10001);
+
+    auto result = index.query(Vector2f(12, 12), Vector2f(23, 17));
+    // Columns 2-4, rows 2-3 and the large box
+    std::vector<uint> expected = {202, 203, 204, 302, 303, 304, 10000};
+    CHECK(result == expected);
+
+    // Result should equal a brute force search, and have no duplicates
+    for(auto region : std::vector<std::pair<Vector2f, Vector2f>>{
+            {Vector2f(-5, -5), Vector2f(3, 3)},
+            {Vector2f(101.5, 33.3), Vector2f(255.2, 199.9)},
+            {Vector2f(0, 0), Vector2f(500, 500)},
+    }) {
+        std::vector<uint> bruteForce;
+        for(int y = 0; y < 100; ++y) {
+            for(int x = 0; x < 100; ++x) {
+                if(x*5 <= region.second.x() && x*5 + 4 >= region.first.x() && y*5 <= region.second.y() && y*5 + 4 >= region.first.y())
+                    bruteForce.push_back(x + y*100);
+            }
+        }
+        bruteForce.push_back(10000);
+        CHECK(index.query(region.first, region.second) == bruteForce);
+    }
+
+    CHECK(index.query(Vector2f(2000, 2000), Vector2f(3000, 3000)).empty());
+    index.clear();
+    CHECK(index.getNrOfBoxes() == 0);
+    CHECK(index.query(Vector2f(0, 0), Vector2f(100, 100)).empty());
+}
+
+TEST_CASE("BoundingBoxSet region query", "[fast][BoundingBox][BoundingBoxSpatialIndex]") {
+    auto boxes = BoundingBoxSet::create();
+    {
+        auto access = boxes->getAccess(ACCESS_READ_WRITE);
+        access->addBoundingBox(Vector2f(0, 0), Vector2f(10, 10), 1, 0.5f);
+        access->addBoundingBox(Vector2f(100, 100), Vector2f(10, 10), 2, 0.6f);
+        // Add a set of boxes, as done by BoundingBoxSetAccumulator
+        access->addBoundingBoxes(
+                {200, 200, 0, 210, 200, 0, 210, 210, 0, 200, 210, 0},
+                {0, 1, 1, 2, 2, 3, 3, 0},
+                {3, 3, 3, 3},
+                {0.7f},
+                10
+        );
+    }
+    auto access = boxes->getAccess(ACCESS_READ);
+    CHECK(access->getBoundingBoxesInRegion(Vector2f(-10, -10), Vector2f(5, 5)) == std::vector<uint>{0});
+    CHECK(access->getBoundingBoxesInRegion(Vector2f(105, 105), Vector2f(205, 205)) == std::vector<uint>{1, 2});
+    CHECK(access->getBoundingBoxesInRegion(Vector2f(20, 20), Vector2f(90, 90)).empty());
+    auto box = access->getBoundingBoxesInRegion(Vector2f(205, 205), Vector2f(300, 300));
+    REQUIRE(box.size() == 1);
+    CHECK(access->getLabels()[box[0]*4] == 3);
+    CHECK(access->getScores()[box[0]] == Approx(0.7f));
+}
@@ -15,3 +15,104 @@ TEST_CASE("Update timestamp on DataObject", "[fast][DataObject]") {
 
 
 };
+
+#include <FAST/Data/Tensor.hpp>
+#include <FAST/Data/Access/OpenCLBufferAccess.hpp>
+
+TEST_CASE("Tensor view refers to data of parent tensor", "[fast][Tensor]") {
+    auto tensor = Tensor::create(TensorShape({2, 3}));
+    {
+        auto access = tensor->getAccess(ACCESS_READ_WRITE);
+        float* data = access->getRawData();
+        for(int i = 0; i < 6; ++i)
+            data[i] = i;
+    }
+    auto view = TensorView::create(tensor, 3, TensorShape({3}));
+    REQUIRE(view->getShape().getDimensions() == 1);
+    CHECK(view->getShape()[0] == 3);
+    {
+        auto access = view->getAccess(ACCESS_READ);
+        float* data = access->getRawData();
+        CHECK(data[0] == 3);
+        CHECK(data[1] == 4);
+        CHECK(data[2] == 5);
+    }
+    CHECK_THROWS(TensorView::create(tensor, 4, TensorShape({3})));
+}
+
+TEST_CASE("Tensor view sees parent data updated after the view was created", "[fast][Tensor]") {
+    auto tensor = Tensor::create(TensorShape({2, 3}));
+    {
+        auto access = tensor->getAccess(ACCESS_READ_WRITE);
+        float* data = access->getRawData();
+        for(int i = 0; i < 6; ++i)
+            data[i] = i;
+    }
+    auto view = TensorView::create(tensor, 3, TensorShape({3}));
+    {
+        // Modify parent on device, and remove its host data
+        auto device = std::dynamic_pointer_cast<OpenCLDevice>(DeviceManager::getInstance()->getDefaultDevice());
+        auto access = tensor->getOpenCLBufferAccess(ACCESS_READ_WRITE, device);
+        float newData[6] = {10, 11, 12, 13, 14, 15};
+        device->getCommandQueue().enqueueWriteBuffer(*access->get(), CL_TRUE, 0, sizeof(float)*6, newData);
+    }
+    tensor->free(Host::getInstance());
+    {
+        auto access = view->getAccess(ACCESS_READ);
+        float* data = access->getRawData();
+        CHECK(data[0] == 13);
+        CHECK(data[1] == 14);
+        CHECK(data[2] == 15);
+    }
+    {
+        auto access = view->getAccess(ACCESS_READ_WRITE);
+        access->getRawData()[0] = 20;
+    }
+    auto access = tensor->getAccess(ACCESS_READ);
+    CHECK(access->getRawData()[3] == 20);
+}
+
+TEST_CASE("Tensor views of the same parent can be accessed at the same time", "[fast][Tensor]") {
+    auto tensor = Tensor::create(TensorShape({2, 3}));
+    auto view1 = TensorView::create(tensor, 0, TensorShape({3}));
+    auto view2 = TensorView::create(tensor, 3, TensorShape({3}));
+    {
+        auto access1 = view1->getAccess(ACCESS_READ_WRITE);
+        auto access2 = view2->getAccess(ACCESS_READ_WRITE);
+        for(int i = 0; i < 3; ++i) {
+            access1->getRawData()[i] = i;
+            access2->getRawData()[i] = i + 3;
+        }
+    }
+    auto access = tensor->getAccess(ACCESS_READ);
+    for(int i = 0; i < 6; ++i)
+        CHECK(access->getRawData()[i] == i);
+}
+
+TEST_CASE("Tensor view device data is updated when parent is modified", "[fast][Tensor]") {
+    auto device = std::dynamic_pointer_cast<OpenCLDevice>(DeviceManager::getInstance()->getDefaultDevice());
+    auto tensor = Tensor::create(TensorShape({2, 3}));
+    {
+        auto access = tensor->getAccess(ACCESS_READ_WRITE);
+        for(int i = 0; i < 6; ++i)
+            access->getRawData()[i] = i;
+    }
+    auto view = TensorView::create(tensor, 3, TensorShape({3}));
+    float result[3];
+    {
+        auto access = view->getOpenCLBufferAccess(ACCESS_READ, device);
+        device->getCommandQueue().enqueueReadBuffer(*access->get(), CL_TRUE, 0, sizeof(float)*3, result);
+    }
+    CHECK(result[0] == 3);
+    {
+        auto access = tensor->getAccess(ACCESS_READ_WRITE);
+        access->getRawData()[3] = 30;
+    }
+    {
+        auto access = view->getOpenCLBufferAccess(ACCESS_READ, device);
+        device->getCommandQueue().enqueueReadBuffer(*access->get(), CL_TRUE, 0, sizeof(float)*3, result);
+    }
+    CHECK(result[0] == 30);
+    CHECK(result[1] == 4);
+    CHECK(result[2] == 5);
+}
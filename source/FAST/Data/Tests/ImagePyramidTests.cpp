@@ -7,6 +7,7 @@
 #include <FAST/Visualization/ImagePyramidRenderer/ImagePyramidRenderer.hpp>
 #include <FAST/Exporters/TIFFImagePyramidExporter.hpp>
 #include <FAST/Importers/TIFFImagePyramidImporter.hpp>
+#include <atomic>
 
 using namespace fast;
 
@@ -108,3 +109,168 @@ TEST_CASE("getClosestLevelForMagnification()", "[fast][ImagePyramid]") {
     }
      */
 }
+
+TEST_CASE("Multi-threaded TIFF reading gives same tiles as single threaded", "[fast][ImagePyramid][TIFF]") {
+    auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
+    TIFFImagePyramidExporter::create("multi-threaded-read-test.tiff")->connect(importer)->run();
+
+    auto imagePyramid = TIFFImagePyramidImporter::create("multi-threaded-read-test.tiff")->runAndGetOutputData<ImagePyramid>();
+    REQUIRE(imagePyramid->isMultiThreadedTIFFReading());
+    const int level = imagePyramid->getNrOfLevels() - 1;
+    const int tilesX = imagePyramid->getLevelTilesX(level);
+    const int tilesY = imagePyramid->getLevelTilesY(level);
+
+    // Read all tiles in parallel, one thread per row
+    std::vector<std::vector<Image::pointer>> parallelTiles(tilesY);
+    {
+        std::vector<std::thread> threads;
+        for(int tileY = 0; tileY < tilesY; ++tileY) {
+            threads.emplace_back([&, tileY]() {
+                auto access = imagePyramid->getAccess(ACCESS_READ);
+                for(int tileX = 0; tileX < tilesX; ++tileX)
+                    parallelTiles[tileY].push_back(access->getPatchAsImage(level, tileX, tileY));
+            });
+        }
+        for(auto& thread : threads)
+            thread.join();
+    }
+
+    imagePyramid->setMultiThreadedTIFFReading(false);
+    auto access = imagePyramid->getAccess(ACCESS_READ);
+    for(int tileY = 0; tileY < tilesY; ++tileY) {
+        for(int tileX = 0; tileX < tilesX; ++tileX) {
+            auto tile = access->getPatchAsImage(level, tileX, tileY);
+            auto tileAccess = tile->getImageAccess(ACCESS_READ);
+            auto parallelAccess = parallelTiles[tileY][tileX]->getImageAccess(ACCESS_READ);
+            REQUIRE(std::memcmp(tileAccess->get(), parallelAccess->get(), tile->getNrOfVoxels()*tile->getNrOfChannels()) == 0);
+        }
+    }
+}
+
+TEST_CASE("Multi-threaded TIFF reading with many short lived threads", "[fast][ImagePyramid][TIFF]") {
+    auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
+    TIFFImagePyramidExporter::create("multi-threaded-read-test2.tiff")->connect(importer)->run();
+
+    auto imagePyramid = TIFFImagePyramidImporter::create("multi-threaded-read-test2.tiff")->runAndGetOutputData<ImagePyramid>();
+    REQUIRE(imagePyramid->isMultiThreadedTIFFReading());
+    const int level = imagePyramid->getNrOfLevels() - 1;
+    auto expected = imagePyramid->getAccess(ACCESS_READ)->getPatchAsImage(level, 0, 0);
+    auto expectedAccess = expected->getImageAccess(ACCESS_READ);
+
+    // More threads than TIFF handles in the pool, thus threads have to wait for handles to be returned
+    const int nrOfThreads = std::max(1, (int)std::thread::hardware_concurrency())*4;
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for(int i = 0; i < nrOfThreads; ++i) {
+        threads.emplace_back([&]() {
+            auto tile = imagePyramid->getAccess(ACCESS_READ)->getPatchAsImage(level, 0, 0);
+            auto tileAccess = tile->getImageAccess(ACCESS_READ);
+            if(std::memcmp(tileAccess->get(), expectedAccess->get(), tile->getNrOfVoxels()*tile->getNrOfChannels()) != 0)
+                ++mismatches;
+        });
+    }
+    for(auto& thread : threads)
+        thread.join();
+    CHECK(mismatches == 0);
+}
+
+TEST_CASE("Parallel tile encoding gives same result as synchronous encoding", "[fast][ImagePyramid][JPEG]") {
+    auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
+    auto imagePyramid = importer->runAndGetOutputData<ImagePyramid>();
+    const int level = 2;
+    const int tileSize = 256;
+    const int tilesX = 8;
+    const int tilesY = 8;
+
+    std::vector<ImagePyramid::pointer> results;
+    for(int threads : {0, 4}) {
+        auto newImagePyramid = ImagePyramid::create(tilesX*tileSize, tilesY*tileSize, 3, tileSize, tileSize, ImageCompression::JPEG);
+        newImagePyramid->setTileEncodingThreads(threads);
+        auto accessRead = imagePyramid->getAccess(ACCESS_READ);
+        auto accessWrite = newImagePyramid->getAccess(ACCESS_READ_WRITE);
+        for(int tileY = 0; tileY < tilesY; ++tileY) {
+            for(int tileX = 0; tileX < tilesX; ++tileX) {
+                auto patch = accessRead->getPatchAsImage(level, tileX*tileSize, tileY*tileSize, tileSize, tileSize);
+                accessWrite->setPatch(0, tileX*tileSize, tileY*tileSize, patch);
+            }
+        }
+        results.push_back(newImagePyramid);
+    }
+
+    for(int level = 0; level < results[0]->getNrOfLevels(); ++level) {
+        auto access0 = results[0]->getAccess(ACCESS_READ);
+        auto access1 = results[1]->getAccess(ACCESS_READ);
+        for(int tileY = 0; tileY < results[0]->getLevelTilesY(level); ++tileY) {
+            for(int tileX = 0; tileX < results[0]->getLevelTilesX(level); ++tileX) {
+                auto tile0 = access0->getPatchAsImage(level, tileX, tileY);
+                auto tile1 = access1->getPatchAsImage(level, tileX, tileY);
+                auto tileAccess0 = tile0->getImageAccess(ACCESS_READ);
+                auto tileAccess1 = tile1->getImageAccess(ACCESS_READ);
+                REQUIRE(std::memcmp(tileAccess0->get(), tileAccess1->get(), tile0->getNrOfVoxels()*tile0->getNrOfChannels()) == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("Deferred level construction gives same result as propagating each patch", "[fast][ImagePyramid]") {
+    auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
+    auto imagePyramid = importer->runAndGetOutputData<ImagePyramid>();
+    const int level = 2;
+    const int tileSize = 256;
+    const int tilesX = 7;
+    const int tilesY = 5;
+
+    std::vector<ImagePyramid::pointer> results;
+    for(bool deferred : {false, true}) {
+        auto newImagePyramid = ImagePyramid::create(tilesX*tileSize, tilesY*tileSize, 3, tileSize, tileSize, ImageCompression::RAW);
+        newImagePyramid->setDeferredLevelConstruction(deferred);
+        auto accessRead = imagePyramid->getAccess(ACCESS_READ);
+        auto accessWrite = newImagePyramid->getAccess(ACCESS_READ_WRITE);
+        for(int tileY = 0; tileY < tilesY; ++tileY) {
+            for(int tileX = 0; tileX < tilesX; ++tileX) {
+                auto patch = accessRead->getPatchAsImage(level, tileX*tileSize, tileY*tileSize, tileSize, tileSize);
+                accessWrite->setPatch(0, tileX*tileSize, tileY*tileSize, patch);
+            }
+        }
+        accessWrite->finalize();
+        results.push_back(newImagePyramid);
+    }
+
+    REQUIRE(results[0]->getNrOfLevels() > 1);
+    for(int level = 0; level < results[0]->getNrOfLevels(); ++level) {
+        auto access0 = results[0]->getAccess(ACCESS_READ);
+        auto access1 = results[1]->getAccess(ACCESS_READ);
+        for(int tileY = 0; tileY < results[0]->getLevelTilesY(level); ++tileY) {
+            for(int tileX = 0; tileX < results[0]->getLevelTilesX(level); ++tileX) {
+                auto tile0 = access0->getPatchAsImage(level, tileX, tileY);
+                auto tile1 = access1->getPatchAsImage(level, tileX, tileY);
+                auto tileAccess0 = tile0->getImageAccess(ACCESS_READ);
+                auto tileAccess1 = tile1->getImageAccess(ACCESS_READ);
+                REQUIRE(std::memcmp(tileAccess0->get(), tileAccess1->get(), tile0->getNrOfVoxels()*tile0->getNrOfChannels()) == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("Tile cache of image pyramid", "[fast][ImagePyramid]") {
+    auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
+    auto imagePyramid = importer->runAndGetOutputData<ImagePyramid>();
+    const int level = imagePyramid->getNrOfLevels() - 1;
+    CHECK(imagePyramid->getTileCacheSize() == 64*1024*1024); // Cache is enabled by default for imported pyramids
+    const uint64_t misses = imagePyramid->getTileCacheMisses();
+    const uint64_t hits = imagePyramid->getTileCacheHits();
+
+    auto access = imagePyramid->getAccess(ACCESS_READ);
+    auto tile = access->getPatchAsImage(level, 0, 0);
+    CHECK(imagePyramid->getTileCacheMisses() == misses + 1);
+    auto tile2 = access->getPatchAsImage(level, 0, 0);
+    CHECK(imagePyramid->getTileCacheHits() == hits + 1);
+    auto tileAccess = tile->getImageAccess(ACCESS_READ);
+    auto tileAccess2 = tile2->getImageAccess(ACCESS_READ);
+    CHECK(std::memcmp(tileAccess->get(), tileAccess2->get(), tile->getNrOfVoxels()*tile->getNrOfChannels()) == 0);
+
+    // Disabling the cache should not count any hits
+    imagePyramid->setTileCacheSize(0);
+    access->getPatchAsImage(level, 0, 0);
+    CHECK(imagePyramid->getTileCacheHits() == hits + 1);
+}
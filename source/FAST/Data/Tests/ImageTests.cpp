@@ -1520,3 +1520,39 @@ TEST_CASE("createFromImage on 3D image", "[fast][image]") {
 }
 
 
+
+TEST_CASE("Use OpenCL access events with a transfer queue", "[fast][image]") {
+    OpenCLDevice::pointer device = DeviceManager::getInstance()->getOneOpenCLDevice();
+    const unsigned int width = 256;
+    const unsigned int height = 512;
+    const DataType type = TYPE_FLOAT;
+    float* data = (float*)allocateRandomData(width*height, type);
+    auto image = Image::create(width, height, type, 1, Host::getInstance(), data);
+
+    // Upload is non-blocking, use the events of the access object to read the buffer on another queue
+    auto access = image->getOpenCLBufferAccess(ACCESS_READ, device);
+    std::vector<cl::Event> events = access->getEvents();
+    std::vector<float> result(width*height);
+    device->getTransferQueue().enqueueReadBuffer(*access->get(), CL_TRUE, 0, width*height*sizeof(float), result.data(), &events);
+    CHECK(compareDataArrays(result.data(), data, width*height, type) == true);
+    access->release();
+
+    // Change data in a kernel, and give the event of the kernel to the access object
+    auto writeAccess = image->getOpenCLBufferAccess(ACCESS_READ_WRITE, device);
+    int i = device->createProgramFromString("__kernel void changeData(__global float* buffer) {"
+            "buffer[get_global_id(0)] = buffer[get_global_id(0)]*2; "
+            "}");
+    cl::Kernel kernel(device->getProgram(i), "changeData");
+    kernel.setArg(0, *writeAccess->get());
+    cl::Event kernelEvent;
+    device->getCommandQueue().enqueueNDRangeKernel(kernel, cl::NullRange, cl::NDRange(width*height), cl::NullRange, nullptr, &kernelEvent);
+    device->getCommandQueue().flush();
+    writeAccess->setWriteEvent(kernelEvent);
+    writeAccess->release();
+    for(unsigned int j = 0; j < width*height; j++)
+        data[j] = data[j]*2;
+
+    auto hostAccess = image->getImageAccess(ACCESS_READ);
+    CHECK(compareDataArrays(hostAccess->get(), data, width*height, type) == true);
+    deleteArray(data, type);
+}
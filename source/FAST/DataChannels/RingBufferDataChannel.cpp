@@ -0,0 +1,85 @@
+#include "RingBufferDataChannel.hpp"
+
+namespace fast {
+
+void RingBufferDataChannel::addFrame(DataObject::pointer data) {
+    // Decrement semaphore by one, wait if buffer is full
+    m_emptyCount->wait();
+
+    // If stop is signaled, throw an exception to stop the entire computation thread
+    if(m_stopped.load(std::memory_order_acquire))
+        throw ThreadStopped(m_errorMessage);
+
+    const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    m_buffer[tail % m_buffer.size()] = std::move(data);
+    m_tail.store(tail + 1, std::memory_order_release);
+
+    // Increment semaphore by one, signal any waiting due to empty buffer
+    m_fillCount->signal();
+}
+
+DataObject::pointer RingBufferDataChannel::getNextDataFrame() {
+    // Decrement semaphore by one, and wait if buffer is empty
+    m_fillCount->wait();
+
+    // If stop is signaled, throw an exception to stop the entire computation thread
+    if(m_stopped.load(std::memory_order_acquire))
+        throw ThreadStopped(m_errorMessage);
+
+    // Get next frame and remove it from the buffer
+    const uint64_t head = m_head.load(std::memory_order_relaxed);
+    DataObject::pointer data = std::move(m_buffer[head % m_buffer.size()]);
+    m_head.store(head + 1, std::memory_order_release);
+
+    // Increment semaphore by one and signal any waiting for next frame due to full buffer
+    m_emptyCount->signal();
+
+    return data;
+}
+
+int RingBufferDataChannel::getSize() {
+    return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+}
+
+void RingBufferDataChannel::setMaximumNumberOfFrames(uint frames) {
+    if(getSize() > 0)
+        throw Exception("Have to call setMaximumNumberOfFrames before executing pipeline");
+    if(frames == 0)
+        throw Exception("Maximum number of frames in RingBufferDataChannel must be > 0");
+    m_buffer = std::vector<std::shared_ptr<DataObject>>(frames);
+    m_head = 0;
+    m_tail = 0;
+    m_fillCount = std::make_unique<LightweightSemaphore>(0);
+    m_emptyCount = std::make_unique<LightweightSemaphore>(frames);
+}
+
+int RingBufferDataChannel::getMaximumNumberOfFrames() const {
+    return m_buffer.size();
+}
+
+void RingBufferDataChannel::stop(std::string errorMessage) {
+    DataChannel::stop(errorMessage);
+    m_stopped.store(true, std::memory_order_release);
+    Reporter::info() << "SIGNALING SEMAPHORES in RingBufferDataChannel" << Reporter::end();
+
+    // Since getNextFrame or addFrame might be waiting for data, we need to signal the semaphore to stop them blocking
+    m_fillCount->signal();
+    m_emptyCount->signal();
+}
+
+bool RingBufferDataChannel::hasCurrentData() {
+    return getSize() > 0;
+}
+
+DataObject::pointer RingBufferDataChannel::getFrame() {
+    // Only called from the consumer thread, thus the frame at head can't be removed while reading it
+    if(getSize() == 0)
+        throw Exception("No frames available in getFrame");
+    return m_buffer[m_head.load(std::memory_order_acquire) % m_buffer.size()];
+}
+
+RingBufferDataChannel::RingBufferDataChannel() {
+    setMaximumNumberOfFrames(50);
+}
+
+}
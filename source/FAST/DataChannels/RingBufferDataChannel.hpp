@@ -0,0 +1,64 @@
+#pragma once
+
+#include <FAST/DataChannels/DataChannel.hpp>
+#include <FAST/Semaphore.hpp>
+#include <atomic>
+#include <vector>
+
+namespace fast {
+
+/**
+ * This data channel implements the producer-consumer task using a fixed size lock-free ring buffer.
+ * It has the same blocking behaviour as QueuedDataChannel, but there is no mutex and no memory allocation
+ * per frame. It only supports ONE producer thread and ONE consumer thread.
+ * It can be used on the output data channels of streamers when streaming mode is PROCESS_ALL_FRAMES,
+ * see Streamer::setLockFreeOutputPort.
+ */
+class FAST_EXPORT RingBufferDataChannel : public DataChannel {
+    FAST_OBJECT(RingBufferDataChannel)
+    public:
+        /**
+         * Add frame to the data channel. This call may block
+         * if the buffer is full.
+         */
+        void addFrame(DataObject::pointer data) override;
+
+        /**
+         * @return the number of frames stored in this DataChannel
+         */
+        int getSize() override;
+
+        /**
+         * Set the maximum nr of frames that can be stored in this data channel
+         */
+        void setMaximumNumberOfFrames(uint frames) override;
+
+        int getMaximumNumberOfFrames() const override;
+
+        /**
+         * @brief This will unblock if this DataChannel is currently blocking. Used to stop a pipeline.
+         * @param Error message to supply.
+         */
+        void stop(std::string errorMessage) override;
+
+        bool hasCurrentData() override;
+
+        /**
+         * Get current frame, throws if current frame is not available.
+         */
+        DataObject::pointer getFrame() override;
+    protected:
+        std::vector<std::shared_ptr<DataObject>> m_buffer;
+        // Total number of frames read (head) and written (tail). Only the consumer writes to head, and only the producer to tail.
+        std::atomic<uint64_t> m_head{0};
+        std::atomic<uint64_t> m_tail{0};
+        std::atomic<bool> m_stopped{false};
+        std::unique_ptr<LightweightSemaphore> m_fillCount;
+        std::unique_ptr<LightweightSemaphore> m_emptyCount;
+
+        DataObject::pointer getNextDataFrame() override;
+        RingBufferDataChannel();
+
+};
+
+}
@@ -1,5 +1,6 @@
 #include "DataStream.hpp"
 #include "ProcessObject.hpp"
+#include <FAST/DataChannels/StaticDataChannel.hpp>
 
 namespace fast {
 
@@ -24,7 +25,16 @@ std::shared_ptr<DataObject> DataStream::getNextDataObject(uint portID) {
     if(m_nextDataObjects.count(portID) == 0) {
         // Run all POs
         for(int i = 0; i < m_outputPorts.size(); ++i) {
-            m_outputPorts[i]->getProcessObject()->run(m_executeToken);
+            auto po = m_outputPorts[i]->getProcessObject();
+            po->run(m_executeToken);
+            // A process object may execute without producing any output yet, e.g. a NeuralNetwork filling its
+            // inference pipeline. In that case it is run again with a new execute token.
+            while(std::dynamic_pointer_cast<StaticDataChannel>(m_outputPorts[i]) &&
+                    !m_outputPorts[i]->hasCurrentData() &&
+                    po->getLastExecuteToken() == (int)m_executeToken) {
+                ++m_executeToken;
+                po->run(m_executeToken);
+            }
             m_nextDataObjects[i] = m_outputPorts[i]->getNextFrame();
             if(m_nextDataObjects[i]->isLastFrame()) {
                 m_done = true;
@@ -73,6 +73,16 @@ cl::CommandQueue OpenCLDevice::getCommandQueue() {
     return getQueue(0);
 }
 
+cl::CommandQueue OpenCLDevice::getTransferQueue() {
+    if(transferQueues.empty())
+        return getCommandQueue();
+    return transferQueues[nextTransferQueue++ % transferQueues.size()];
+}
+
+int OpenCLDevice::getNrOfTransferQueues() const {
+    return transferQueues.size();
+}
+
 cl::Device OpenCLDevice::getDevice() {
     return OpenCLDevice::getDevice(0);
 }
@@ -115,6 +125,8 @@ OpenCLDevice::~OpenCLDevice() {
      //reportInfo() << "DESTROYING opencl device object..." << Reporter::end();
      // Make sure that all queues are finished
      getQueue(0).finish();
+     for(auto&& queue : transferQueues)
+         queue.finish();
 }
 
 OpenCLDevice::OpenCLDevice() {
@@ -221,6 +233,16 @@ OpenCLDevice::OpenCLDevice(std::vector<cl::Device> devices, unsigned long* OpenG
             this->queues.push_back(cl::CommandQueue(context, devices[i]));
         }
     }
+    // Separate queues for host/device transfers, handed out round robin by getTransferQueue regardless of direction,
+    // so that transfers from different threads can overlap with each other and with kernels on the main queue
+    const int nrOfTransferQueues = 2;
+    for(int i = 0; i < nrOfTransferQueues; i++) {
+        if(profilingEnabled) {
+            this->transferQueues.push_back(cl::CommandQueue(context, devices[0], CL_QUEUE_PROFILING_ENABLE));
+        } else {
+            this->transferQueues.push_back(cl::CommandQueue(context, devices[0]));
+        }
+    }
 }
 
 int OpenCLDevice::createProgramFromSource(std::string filename, std::string buildOptions, bool useCaching) {
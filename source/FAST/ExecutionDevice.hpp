@@ -2,6 +2,7 @@
 
 #include "FAST/Object.hpp"
 #include "RuntimeMeasurementManager.hpp"
+#include <atomic>
 
 namespace fast {
 
@@ -69,6 +70,16 @@ class FAST_EXPORT  OpenCLDevice : public ExecutionDevice {
     FAST_OBJECT(OpenCLDevice)
     public:
         cl::CommandQueue getCommandQueue();
+        /**
+         * @brief Get a command queue for transfers between host and device
+         *
+         * The transfer queues are separate in-order queues on the same device as getCommandQueue(),
+         * thus uploads and readbacks on them can overlap with kernels on the main command queue.
+         * Events must be used to synchronize with the main command queue.
+         * The transfer queues are handed out round robin.
+         */
+        cl::CommandQueue getTransferQueue();
+        int getNrOfTransferQueues() const;
         cl::Device getDevice();
 
         int createProgramFromSource(std::string filename, std::string buildOptions = "", bool caching = true);
@@ -112,6 +123,8 @@ class FAST_EXPORT  OpenCLDevice : public ExecutionDevice {
 
         cl::Context context;
         std::vector<cl::CommandQueue> queues;
+        std::vector<cl::CommandQueue> transferQueues;
+        std::atomic<unsigned int> nextTransferQueue{0};
         std::map<std::string, int> programNames;
         std::vector<cl::Program> programs;
         std::vector<cl::Device> devices;
@@ -1,6 +1,7 @@
 #include "HDF5TensorExporter.hpp"
 #include <FAST/Data/Tensor.hpp>
 #include <H5Cpp.h>
+#include <algorithm>
 
 namespace fast {
 
@@ -9,9 +10,41 @@ void HDF5TensorExporter::setDatasetName(std::string name) {
 	setModified(true);
 }
 
+void HDF5TensorExporter::setStreaming(bool streaming) {
+    m_streaming = streaming;
+    setModified(true);
+}
+
+bool HDF5TensorExporter::getStreaming() const {
+    return m_streaming;
+}
+
+void HDF5TensorExporter::setCompressionLevel(int level) {
+    if(level < 0 || level > 9)
+        throw Exception("Compression level in HDF5TensorExporter must be between 0 and 9");
+    m_compressionLevel = level;
+    setModified(true);
+}
+
+int HDF5TensorExporter::getCompressionLevel() const {
+    return m_compressionLevel;
+}
+
+void HDF5TensorExporter::setMaximumQueueSize(int frames) {
+    if(frames <= 0)
+        throw Exception("Maximum queue size in HDF5TensorExporter must be > 0");
+    m_maximumQueueSize = frames;
+}
+
+uint64_t HDF5TensorExporter::getNrOfFramesWritten() const {
+    return m_framesWritten;
+}
+
 void HDF5TensorExporter::loadAttributes() {
 	setFilename(getStringAttribute("filename"));
 	setDatasetName(getStringAttribute("name"));
+	setStreaming(getBooleanAttribute("streaming"));
+	setCompressionLevel(getIntegerAttribute("compression"));
 }
 
 
@@ -19,10 +52,22 @@ void HDF5TensorExporter::loadAttributes() {
 HDF5TensorExporter::HDF5TensorExporter() : HDF5TensorExporter("", "tensor") {
 }
 
-HDF5TensorExporter::HDF5TensorExporter(std::string filename, std::string datasetName) : FileExporter(filename) {
+HDF5TensorExporter::HDF5TensorExporter(std::string filename, std::string datasetName, bool streaming, int compressionLevel) : FileExporter(filename) {
     createInputPort(0, "Tensor");
     createStringAttribute("name", "Dataset name", "Name of dataset tensor to write", datasetName);
+    createBooleanAttribute("streaming", "Streaming", "Append each tensor of a stream as a frame to the dataset", streaming);
+    createIntegerAttribute("compression", "Compression level", "Deflate compression level (0-9) in streaming mode", compressionLevel);
     setDatasetName(datasetName);
+    setStreaming(streaming);
+    setCompressionLevel(compressionLevel);
+}
+
+HDF5TensorExporter::~HDF5TensorExporter() {
+    try {
+        finish();
+    } catch(std::exception &e) {
+        reportError() << "Error occured while writing frames in HDF5TensorExporter: " << e.what() << reportEnd();
+    }
 }
 
 void HDF5TensorExporter::execute() {
@@ -35,7 +80,31 @@ void HDF5TensorExporter::execute() {
 	if(shape.getUnknownDimensions() > 0)
 		throw Exception("Tensor has unknown dimensions");
 
+	if(m_streaming) {
+	    if(!m_writerThread) {
+	        m_frameShape = shape.getAll();
+	        m_framesWritten = 0;
+	        m_writerThread = std::make_unique<std::thread>(&HDF5TensorExporter::writeFrames, this, m_filename, m_datasetName, m_compressionLevel, m_frameShape);
+	    } else if(shape.getAll() != m_frameShape) {
+	        throw Exception("All tensors streamed to HDF5TensorExporter must have the same shape");
+	    }
+	    bool error;
+	    {
+	        // Block if writer thread is falling behind
+	        std::unique_lock<std::mutex> lock(m_queueMutex);
+	        m_queueNotFull.wait(lock, [this]() { return (int)m_queue.size() < m_maximumQueueSize || m_writerError; });
+	        error = (bool)m_writerError;
+	        if(!error)
+	            m_queue.push_back(tensor);
+	    }
+	    m_queueNotEmpty.notify_one();
+	    if(error || tensor->isLastFrame())
+	        finish();
+	    return;
+	}
+
 	// Open file
+	std::lock_guard<std::mutex> hdf5Lock(getHDF5Mutex());
 	H5::H5File file(m_filename.c_str(), H5F_ACC_TRUNC);
 
 	std::vector<hsize_t> h5shape;
@@ -55,4 +124,110 @@ void HDF5TensorExporter::execute() {
 	file.close();
 }
 
-}
\ No newline at end of file
+void HDF5TensorExporter::writeFrames(std::string filename, std::string datasetName, int compressionLevel, std::vector<int> shape) {
+    try {
+        // HDF5 is not thread-safe, thus the HDF5 lock is held by this thread, except when waiting for frames.
+        // It is created before the HDF5 objects, so that it is held when they are destroyed.
+        std::unique_lock<std::mutex> hdf5Lock(getHDF5Mutex());
+        H5::H5File file(filename.c_str(), H5F_ACC_TRUNC);
+
+        // Dataset has shape (frames, tensor shape...) and can be extended along the frame axis
+        const int rank = shape.size() + 1;
+        std::vector<hsize_t> dims = {0};
+        std::vector<hsize_t> maxDims = {H5S_UNLIMITED};
+        hsize_t frameSize = 1;
+        for(int size : shape) {
+            dims.push_back(size);
+            maxDims.push_back(size);
+            frameSize *= size;
+        }
+        // Group small frames in chunks of about 64 KB
+        std::vector<hsize_t> chunkDims = dims;
+        chunkDims[0] = std::max<hsize_t>(1, std::min<hsize_t>(1024, 64*1024 / (frameSize*sizeof(float))));
+        H5::DSetCreatPropList properties;
+        properties.setChunk(rank, chunkDims.data());
+        if(compressionLevel > 0)
+            properties.setDeflate(compressionLevel);
+        H5::DataSpace createSpace(rank, dims.data(), maxDims.data());
+        auto dataset = file.createDataSet(datasetName.c_str(), H5::PredType::NATIVE_FLOAT, createSpace, properties);
+
+        std::vector<hsize_t> count = dims;
+        count[0] = 1;
+        std::vector<hsize_t> offset(rank, 0);
+        H5::DataSpace memspace(rank, count.data());
+        while(true) {
+            std::shared_ptr<Tensor> tensor;
+            hdf5Lock.unlock();
+            {
+                std::unique_lock<std::mutex> lock(m_queueMutex);
+                m_queueNotEmpty.wait(lock, [this]() { return m_stopWriter || !m_queue.empty(); });
+                if(!m_queue.empty()) {
+                    tensor = m_queue.front();
+                    m_queue.pop_front();
+                }
+            }
+            m_queueNotFull.notify_one();
+            hdf5Lock.lock();
+            if(!tensor) // Stopped, and all frames are written
+                break;
+
+            if(offset[0] == 0) {
+                // Write spacing information
+                std::vector<hsize_t> h5shape = {(hsize_t)shape.size()};
+                H5::DataSpace spacingSpace(1, h5shape.data());
+                auto spacingDataset = file.createDataSet("spacing", H5::PredType::NATIVE_FLOAT, spacingSpace);
+                spacingDataset.write(tensor->getSpacing().data(), H5::PredType::NATIVE_FLOAT, spacingSpace, spacingSpace);
+            }
+
+            // Append frame
+            dims[0] = offset[0] + 1;
+            dataset.extend(dims.data());
+            auto filespace = dataset.getSpace();
+            filespace.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data());
+            auto access = tensor->getAccess(ACCESS_READ);
+            dataset.write(access->getRawData(), H5::PredType::NATIVE_FLOAT, memspace, filespace);
+            offset[0] += 1;
+            ++m_framesWritten;
+        }
+        file.close();
+    } catch(H5::Exception &e) {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_writerError = std::make_exception_ptr(Exception("Error writing to HDF5 file " + filename + ": " + e.getDetailMsg()));
+    } catch(...) {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_writerError = std::current_exception();
+    }
+    m_queueNotFull.notify_all();
+}
+
+void HDF5TensorExporter::finish() {
+    if(m_writerThread) {
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_stopWriter = true;
+        }
+        m_queueNotEmpty.notify_all();
+        m_writerThread->join();
+        m_writerThread.reset();
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_stopWriter = false;
+            m_queue.clear();
+        }
+        m_frameShape.clear();
+    }
+    rethrowWriterError();
+}
+
+void HDF5TensorExporter::rethrowWriterError() {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        error = m_writerError;
+        m_writerError = nullptr;
+    }
+    if(error)
+        std::rethrow_exception(error);
+}
+
+}
@@ -1,14 +1,27 @@
 #pragma once
 
 #include <FAST/Exporters/FileExporter.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <thread>
 
 namespace fast {
 
+class Tensor;
+
 /**
  * @brief Write a Tensor to a HDF5 file
  *
  * Uses the HDF5 C++ library to write a Tensor to a HDF5 file
  *
+ * In streaming mode, each tensor in a stream is appended as a frame to a chunked, extendible dataset
+ * with shape (frames, tensor shape...), without reopening the file.
+ * The frames are written by a background thread, thus the pipeline does not have to wait for the disk.
+ * The file is closed when the last frame of the stream has been written, when finish() is called,
+ * or when the exporter is destroyed.
+ *
  * <h3>Input ports</h3>
  * - 0: Tensor
  *
@@ -22,19 +35,70 @@ class FAST_EXPORT HDF5TensorExporter : public FileExporter {
          * @brief Create instance
          * @param filename Filename to open
          * @param datasetName Dataset in HDF file to open. Default is "tensor"
+         * @param streaming Append each tensor of a stream as a frame to the dataset
+         * @param compressionLevel Deflate compression level (0-9) of the dataset in streaming mode. 0 means no compression.
          * @return instance
          */
         FAST_CONSTRUCTOR(HDF5TensorExporter,
                          std::string, filename,,
-                         std::string, datasetName, = "tensor"
+                         std::string, datasetName, = "tensor",
+                         bool, streaming, = false,
+                         int, compressionLevel, = 0
         );
         void setDatasetName(std::string name);
+        /**
+         * @brief Enable or disable streaming mode
+         * @param streaming If true, each tensor is appended as a frame to the dataset.
+         *      If false, the file is overwritten each time the exporter is executed.
+         */
+        void setStreaming(bool streaming);
+        bool getStreaming() const;
+        /**
+         * @brief Set deflate compression level of the dataset in streaming mode
+         * @param level 0-9, 0 means no compression. Default is 0.
+         */
+        void setCompressionLevel(int level);
+        int getCompressionLevel() const;
+        /**
+         * @brief Set maximum number of frames waiting to be written in streaming mode.
+         * If the queue is full, the exporter blocks until the writer thread has written a frame.
+         * @param frames Default is 32
+         */
+        void setMaximumQueueSize(int frames);
+        /**
+         * @brief Get number of frames written to the file in streaming mode
+         */
+        uint64_t getNrOfFramesWritten() const;
+        /**
+         * @brief Wait for all frames to be written and close the file in streaming mode
+         *
+         * Any error which occured in the writer thread is thrown here.
+         * The next frame will start a new file.
+         */
+        void finish();
 		void loadAttributes() override;
+		~HDF5TensorExporter() override;
 	private:
 		HDF5TensorExporter();
 		void execute() override;
+		void writeFrames(std::string filename, std::string datasetName, int compressionLevel, std::vector<int> shape);
+		void rethrowWriterError();
 
 		std::string m_datasetName = "tensor";
+		bool m_streaming = false;
+		int m_compressionLevel = 0;
+		int m_maximumQueueSize = 32;
+
+		// Streaming
+		std::unique_ptr<std::thread> m_writerThread;
+		std::deque<std::shared_ptr<Tensor>> m_queue;
+		std::mutex m_queueMutex;
+		std::condition_variable m_queueNotEmpty;
+		std::condition_variable m_queueNotFull;
+		bool m_stopWriter = false;
+		std::exception_ptr m_writerError;
+		std::vector<int> m_frameShape;
+		std::atomic<uint64_t> m_framesWritten{0};
 };
 
 }
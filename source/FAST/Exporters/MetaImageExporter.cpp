@@ -1,5 +1,6 @@
 #include "MetaImageExporter.hpp"
 #include "FAST/Data/Image.hpp"
+#include "FAST/ThreadPool.hpp"
 #include <fstream>
 #include <zlib/zlib.h>
 
@@ -16,47 +17,77 @@ MetaImageExporter::MetaImageExporter(std::string filename, bool compress) : File
     setCompression(compress);
 }
 
-template <class T>
-inline std::size_t writeToRawFile(std::string filename, T * data, unsigned int numberOfElements, bool useCompression) {
-    // TODO use mapped_file_sink form boost instead
+static std::vector<uchar> deflateChunk(const uchar* data, std::size_t size, bool last) {
+    z_stream stream = {};
+    // Raw deflate data, the zlib header and checksum of the entire stream is written separately
+    if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw Exception("Unable to initialize zlib while compressing raw file");
+    // Extra bytes for the empty block added by the full flush
+    std::vector<uchar> output(deflateBound(&stream, size) + 16);
+    stream.next_in = (Bytef*)data;
+    stream.avail_in = (uInt)size;
+    stream.next_out = (Bytef*)output.data();
+    stream.avail_out = (uInt)output.size();
+    // A full flush ends the chunk on a byte boundary and resets the dictionary,
+    // thus the chunk can be decompressed independently of the previous chunks
+    int z_result = deflate(&stream, last ? Z_FINISH : Z_FULL_FLUSH);
+    const bool complete = stream.avail_in == 0 && stream.avail_out > 0;
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    if(z_result != (last ? Z_STREAM_END : Z_OK) || !complete)
+        throw Exception("Error while compressing raw file");
+    return output;
+}
+
+static std::size_t writeToRawFile(std::string filename, const void* data, std::size_t size, bool useCompression,
+                                  std::size_t chunkSize, int threads, std::vector<std::size_t>& compressedChunkSizes) {
     FILE* file = fopen(filename.c_str(), "wb");
     if(file == NULL) {
         throw Exception("Could not open file " + filename + " for writing");
     }
     std::size_t returnSize;
     if(useCompression) {
-        // Have to allocate enough memory for compression: 1.1*DATA_SIZE_IN_BYTES + 12
-        std::size_t sizeDataCompressed = compressBound(sizeof(T)*numberOfElements);
-        std::size_t sizeDataOriginal = sizeof(T)*numberOfElements;
-        Bytef* writeData = (Bytef*)malloc(sizeDataCompressed);
-        int z_result = compress(
-                (Bytef*)writeData,
-                (uLongf*)&sizeDataCompressed,
-                (Bytef*)data,
-                sizeDataOriginal
-        );
-        switch(z_result) {
-        case Z_OK:
-            break;
-        case Z_MEM_ERROR:
-            throw Exception("Out of memory while compressing raw file");
-            break;
-        case Z_BUF_ERROR:
-            throw Exception("Output buffer was not large enough while compressing raw file");
-            break;
+        // Compress chunks in parallel, and write them in order as they finish
+        const std::size_t nrOfChunks = std::max<std::size_t>(1, (size + chunkSize - 1) / chunkSize);
+        ThreadPool pool(std::min<int>(threads <= 0 ? (int)std::thread::hardware_concurrency() : threads, nrOfChunks));
+        std::vector<std::future<std::pair<std::vector<uchar>, uLong>>> futures;
+        for(std::size_t i = 0; i < nrOfChunks; ++i) {
+            futures.push_back(pool.submit([=]() {
+                const uchar* chunk = (const uchar*)data + i*chunkSize;
+                const std::size_t bytes = std::min(chunkSize, size - i*chunkSize);
+                auto checksum = adler32(adler32(0L, Z_NULL, 0), chunk, (uInt)bytes);
+                return std::make_pair(deflateChunk(chunk, bytes, i == nrOfChunks - 1), checksum);
+            }));
+        }
+        // zlib header for deflate with 32K window and default compression level
+        const uchar header[2] = {0x78, 0x9C};
+        fwrite(header, 1, 2, file);
+        returnSize = 2;
+        uLong checksum = adler32(0L, Z_NULL, 0);
+        compressedChunkSizes.clear();
+        try {
+            for(std::size_t i = 0; i < nrOfChunks; ++i) {
+                auto result = futures[i].get();
+                fwrite(result.first.data(), 1, result.first.size(), file);
+                returnSize += result.first.size();
+                compressedChunkSizes.push_back(result.first.size());
+                checksum = adler32_combine(checksum, result.second, (z_off_t)std::min(chunkSize, size - i*chunkSize));
+            }
+        } catch(...) {
+            pool.waitForAll();
+            fclose(file);
+            throw;
         }
-        // sizeDataCompressed was changed after compress call
-        fwrite(writeData, sizeDataCompressed, 1, file);
-        returnSize = sizeDataCompressed;
+        const uchar trailer[4] = {(uchar)(checksum >> 24), (uchar)(checksum >> 16), (uchar)(checksum >> 8), (uchar)checksum};
+        fwrite(trailer, 1, 4, file);
+        returnSize += 4;
         fclose(file);
-        free(writeData);
     } else {
-        returnSize = sizeof(T)*numberOfElements;
-        fwrite(data, sizeof(T), numberOfElements, file);
+        returnSize = size;
+        fwrite(data, 1, size, file);
         fclose(file);
     }
 
-
     return returnSize;
 }
 
@@ -112,38 +143,45 @@ void MetaImageExporter::execute() {
         extension = ".zraw";
     }
     std::string rawFilename = m_filename.substr(0,m_filename.length()-4) + extension;
-    const unsigned int numberOfElements = input->getWidth()*input->getHeight()*
-            input->getDepth()*input->getNrOfChannels();
+    const std::size_t size = getSizeOfDataType(input->getDataType(), input->getNrOfChannels())*
+            input->getWidth()*input->getHeight()*input->getDepth();
 
-    ImageAccess::pointer access = input->getImageAccess(ACCESS_READ);
-    void* data = access->get();
-    std::size_t compressedSize;
     switch(input->getDataType()) {
     case TYPE_FLOAT:
         mhdFile << "ElementType = MET_FLOAT\n";
-        compressedSize = writeToRawFile<float>(rawFilename,(float*)data,numberOfElements,mUseCompression);
         break;
     case TYPE_UINT8:
         mhdFile << "ElementType = MET_UCHAR\n";
-        compressedSize = writeToRawFile<uchar>(rawFilename,(uchar*)data,numberOfElements,mUseCompression);
         break;
     case TYPE_INT8:
         mhdFile << "ElementType = MET_CHAR\n";
-        compressedSize = writeToRawFile<char>(rawFilename,(char*)data,numberOfElements,mUseCompression);
         break;
     case TYPE_UINT16:
         mhdFile << "ElementType = MET_USHORT\n";
-        compressedSize = writeToRawFile<ushort>(rawFilename,(ushort*)data,numberOfElements,mUseCompression);
         break;
     case TYPE_INT16:
         mhdFile << "ElementType = MET_SHORT\n";
-        compressedSize = writeToRawFile<short>(rawFilename,(short*)data,numberOfElements,mUseCompression);
+        break;
+    case TYPE_UINT32:
+        mhdFile << "ElementType = MET_UINT\n";
+        break;
+    case TYPE_INT32:
+        mhdFile << "ElementType = MET_INT\n";
         break;
     }
 
+    ImageAccess::pointer access = input->getImageAccess(ACCESS_READ);
+    std::vector<std::size_t> compressedChunkSizes;
+    std::size_t compressedSize = writeToRawFile(rawFilename, access->get(), size, mUseCompression, m_chunkSize, m_threads, compressedChunkSizes);
+
     if(mUseCompression) {
         mhdFile << "CompressedData = True" << "\n";
         mhdFile << "CompressedDataSize = " << compressedSize << "\n";
+        mhdFile << "CompressedDataChunkSize = " << m_chunkSize << "\n";
+        mhdFile << "CompressedDataChunkSizes =";
+        for(auto chunkSize : compressedChunkSizes)
+            mhdFile << " " << chunkSize;
+        mhdFile << "\n";
     }
 
     // Add metadata
@@ -185,5 +223,27 @@ void MetaImageExporter::setMetadata(std::string key, std::string value) {
     mMetadata[key] = value;
 }
 
+void MetaImageExporter::setNumberOfThreads(int threads) {
+    if(threads < 0)
+        throw Exception("Number of threads in MetaImageExporter must be >= 0");
+    m_threads = threads;
+    mIsModified = true;
+}
+
+int MetaImageExporter::getNumberOfThreads() const {
+    return m_threads;
+}
+
+void MetaImageExporter::setCompressionChunkSize(std::size_t bytes) {
+    if(bytes == 0)
+        throw Exception("Compression chunk size in MetaImageExporter must be > 0");
+    m_chunkSize = bytes;
+    mIsModified = true;
+}
+
+std::size_t MetaImageExporter::getCompressionChunkSize() const {
+    return m_chunkSize;
+}
+
 
 }
@@ -11,6 +11,8 @@ namespace fast {
  * This exporter writes 2D and 3D images using the MetaImage format which are pairs of .mhd text files and .raw files
  * containing raw pixel data.
  * Supports compression (.zraw) using the zlib library.
+ * The image is compressed in parallel as independent chunks which are stored as a single zlib stream,
+ * thus the file can be read by any MetaImage reader, while the MetaImageImporter can decompress the chunks in parallel.
  * All meta data in the Image is stored in the .mhd text file.
  *
  * <h3>Input ports</h3>
@@ -46,12 +48,26 @@ class FAST_EXPORT MetaImageExporter : public FileExporter {
          * @param value
          */
         void setMetadata(std::string key, std::string value);
+        /**
+         * @brief Set number of threads used for compression
+         * @param threads Number of threads. If 0, the number of hardware threads is used. Default is 0.
+         */
+        void setNumberOfThreads(int threads);
+        int getNumberOfThreads() const;
+        /**
+         * @brief Set size of each independently compressed chunk
+         * @param bytes Uncompressed size of each chunk in bytes. Default is 4 MB.
+         */
+        void setCompressionChunkSize(std::size_t bytes);
+        std::size_t getCompressionChunkSize() const;
     private:
         MetaImageExporter();
         void execute();
 
         std::map<std::string, std::string> mMetadata;
         bool mUseCompression;
+        int m_threads = 0;
+        std::size_t m_chunkSize = 4*1024*1024;
 };
 
 } // end namespace fast
\ No newline at end of file
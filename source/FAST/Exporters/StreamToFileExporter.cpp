@@ -8,6 +8,22 @@
 
 namespace fast {
 
+static void writeFrame(DataObject::pointer input, std::string filename) {
+    if(auto imageInput = std::dynamic_pointer_cast<Image>(input)) {
+        auto exporter = MetaImageExporter::New();
+        exporter->enableCompression();
+        exporter->setFilename(filename + ".mhd");
+        exporter->setInputData(input);
+        exporter->update();
+    } else if(auto meshInput = std::dynamic_pointer_cast<Mesh>(input)) {
+        auto exporter = VTKMeshFileExporter::New();
+        exporter->setFilename(filename + ".vtk");
+        exporter->setInputData(input);
+        exporter->update();
+    } else {
+        throw Exception("StreamToFileExporter can only handle Image and Mesh data objects");
+    }
+}
 
 void StreamToFileExporter::setPath(std::string path) {
     m_path = path;
@@ -58,27 +74,147 @@ void StreamToFileExporter::execute() {
     if(m_frameCounter >= m_frameLimit)
         throw Exception("Maximum nr of frames (" + std::to_string(m_frameLimit) + ") reached in StreamToFileExporter");
 
+    if(!std::dynamic_pointer_cast<Image>(input) && !std::dynamic_pointer_cast<Mesh>(input))
+        throw Exception("StreamToFileExporter can only handle Image and Mesh data objects");
     std::string currentFileName = join(m_path, m_currentFolder, m_filename + "_" + std::to_string(m_frameCounter));
-    if(auto imageInput = std::dynamic_pointer_cast<Image>(input)) {
-        auto exporter = MetaImageExporter::New();
-        exporter->enableCompression();
-        exporter->setFilename(currentFileName + ".mhd");
-        exporter->setInputData(input);
-        exporter->update();
-    } else if(auto meshInput = std::dynamic_pointer_cast<Mesh>(input)) {
-        auto exporter = VTKMeshFileExporter::New();
-        exporter->setFilename(currentFileName + ".vtk");
-        exporter->setInputData(input);
-        exporter->update();
+    if(m_asynchronous) {
+        rethrowWriterError();
+        if(!m_writerThread)
+            m_writerThread = std::make_unique<std::thread>(&StreamToFileExporter::writeFrames, this);
+        bool dropped = false;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            if(m_queueFullPolicy == QueueFullPolicy::Block) {
+                m_queueChanged.wait(lock, [this]() { return (int)m_queue.size() < m_maximumQueueSize || m_writerError; });
+            } else if((int)m_queue.size() >= m_maximumQueueSize) {
+                dropped = true;
+            }
+            if(!dropped && !m_writerError)
+                m_queue.emplace_back(currentFileName, input);
+        }
+        m_queueChanged.notify_all();
+        rethrowWriterError();
+        if(dropped) {
+            m_droppedFrames += 1;
+            reportWarning() << "Write queue in StreamToFileExporter is full, dropping frame" << reportEnd();
+        } else {
+            // Dropped frames do not use a file number, nor count towards the frame limit
+            m_frameCounter += 1;
+        }
     } else {
-        throw Exception("StreamToFileExporter can only handle Image and Mesh data objects");
+        writeFrame(input, currentFileName);
+        m_writtenFrames += 1;
+        m_frameCounter += 1;
     }
-    m_frameCounter += 1;
     addOutputData(0, input);
 }
 
+void StreamToFileExporter::writeFrames() {
+    while(true) {
+        std::pair<std::string, DataObject::pointer> frame;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueChanged.wait(lock, [this]() { return m_stopWriter || !m_queue.empty(); });
+            if(m_queue.empty()) // Stopped, and all frames are written
+                break;
+            frame = m_queue.front();
+            m_queue.pop_front();
+            m_writing = true;
+        }
+        m_queueChanged.notify_all();
+        try {
+            writeFrame(frame.second, frame.first);
+            m_writtenFrames += 1;
+        } catch(...) {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_writerError = std::current_exception();
+            m_queue.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_writing = false;
+        }
+        m_queueChanged.notify_all();
+    }
+}
+
+void StreamToFileExporter::flush() {
+    {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        m_queueChanged.wait(lock, [this]() { return m_queue.empty() && !m_writing; });
+    }
+    rethrowWriterError();
+}
+
+void StreamToFileExporter::rethrowWriterError() {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        error = m_writerError;
+        m_writerError = nullptr;
+    }
+    if(error)
+        std::rethrow_exception(error);
+}
+
+StreamToFileExporter::~StreamToFileExporter() {
+    if(m_writerThread) {
+        // Write all remaining frames before stopping
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_stopWriter = true;
+        }
+        m_queueChanged.notify_all();
+        m_writerThread->join();
+    }
+    if(m_writerError)
+        reportError() << "Error occured while writing frames in StreamToFileExporter" << reportEnd();
+}
+
+void StreamToFileExporter::setAsynchronous(bool asynchronous) {
+    m_asynchronous = asynchronous;
+}
+
+bool StreamToFileExporter::getAsynchronous() const {
+    return m_asynchronous;
+}
+
+void StreamToFileExporter::setMaximumQueueSize(int frames) {
+    if(frames <= 0)
+        throw Exception("Maximum queue size in StreamToFileExporter must be > 0");
+    m_maximumQueueSize = frames;
+}
+
+int StreamToFileExporter::getMaximumQueueSize() const {
+    return m_maximumQueueSize;
+}
+
+void StreamToFileExporter::setQueueFullPolicy(QueueFullPolicy policy) {
+    m_queueFullPolicy = policy;
+}
+
+QueueFullPolicy StreamToFileExporter::getQueueFullPolicy() const {
+    return m_queueFullPolicy;
+}
+
+uint64_t StreamToFileExporter::getNrOfQueuedFrames() {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_queue.size();
+}
+
+uint64_t StreamToFileExporter::getNrOfWrittenFrames() const {
+    return m_writtenFrames;
+}
+
+uint64_t StreamToFileExporter::getNrOfDroppedFrames() const {
+    return m_droppedFrames;
+}
+
 void StreamToFileExporter::reset() {
+    flush();
     m_frameCounter = 0;
+    m_writtenFrames = 0;
+    m_droppedFrames = 0;
     m_currentFolder = "";
     m_hasStarted = false;
 }
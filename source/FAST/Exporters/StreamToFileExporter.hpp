@@ -1,16 +1,37 @@
 #pragma once
 
 #include <FAST/ProcessObject.hpp>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace fast {
 
+/**
+ * @brief What StreamToFileExporter does with a frame when its write queue is full
+ */
+enum class QueueFullPolicy {
+    Block, // Wait until the writer thread has made room in the queue
+    DropFrame // Do not write the frame
+};
+
 /**
  * @brief Write a stream of Mesh or Image data as a sequence of files.
  *
+ * By default, frames are written to disk by a background thread, thus the input data is sent to the output port
+ * without waiting for the disk. Frames waiting to be written are stored in a bounded queue,
+ * and the QueueFullPolicy decides if the exporter should block or drop frames when the queue is full.
+ *
  * <h3>Input ports</h3>
  * - 0: Image or Mesh
  *
+ * <h3>Output ports</h3>
+ * - 0: Same data as input
+ *
  * @todo Supports more data types and formats
  * @ingroup exporters
  */
@@ -38,9 +59,47 @@ class FAST_EXPORT StreamToFileExporter : public ProcessObject {
         float getRecordingDuration() const;
         void reset();
         bool isEnabled();
+        /**
+         * @brief Write frames in a background thread
+         * @param asynchronous If false, each frame is written in execute. Default is true.
+         */
+        void setAsynchronous(bool asynchronous);
+        bool getAsynchronous() const;
+        /**
+         * @brief Set maximum number of frames waiting to be written
+         * @param frames Default is 64
+         */
+        void setMaximumQueueSize(int frames);
+        int getMaximumQueueSize() const;
+        /**
+         * @brief Set what to do with a frame when the write queue is full
+         * @param policy Default is QueueFullPolicy::Block
+         */
+        void setQueueFullPolicy(QueueFullPolicy policy);
+        QueueFullPolicy getQueueFullPolicy() const;
+        /**
+         * @brief Get number of frames currently waiting to be written
+         */
+        uint64_t getNrOfQueuedFrames();
+        /**
+         * @brief Get number of frames written to disk
+         */
+        uint64_t getNrOfWrittenFrames() const;
+        /**
+         * @brief Get number of frames which were dropped because the write queue was full
+         */
+        uint64_t getNrOfDroppedFrames() const;
+        /**
+         * @brief Block until all queued frames have been written.
+         * Any error which occured in the writer thread is thrown here.
+         */
+        void flush();
+        ~StreamToFileExporter() override;
     private:
         StreamToFileExporter();
         void execute() override;
+        void writeFrames();
+        void rethrowWriterError();
 
         std::string m_path = "";
         std::string m_folder;
@@ -51,6 +110,20 @@ class FAST_EXPORT StreamToFileExporter : public ProcessObject {
         std::chrono::high_resolution_clock::time_point m_recordingStartTime;
         bool m_enabled = true;
         bool m_hasStarted = false;
+
+        // Asynchronous writing
+        bool m_asynchronous = true;
+        int m_maximumQueueSize = 64;
+        QueueFullPolicy m_queueFullPolicy = QueueFullPolicy::Block;
+        std::unique_ptr<std::thread> m_writerThread;
+        std::deque<std::pair<std::string, DataObject::pointer>> m_queue;
+        std::mutex m_queueMutex;
+        std::condition_variable m_queueChanged;
+        bool m_writing = false;
+        bool m_stopWriter = false;
+        std::exception_ptr m_writerError;
+        std::atomic<uint64_t> m_writtenFrames{0};
+        std::atomic<uint64_t> m_droppedFrames{0};
 };
 
 }
\ No newline at end of file
@@ -1,15 +1,44 @@
 #include <tiffio.h>
 #include <FAST/Data/ImagePyramid.hpp>
 #include <FAST/Data/Image.hpp>
-#include <FAST/Algorithms/ImagePatch/PatchGenerator.hpp>
+#include <FAST/Algorithms/Compression/JPEGCompression.hpp>
+#include <FAST/Algorithms/Compression/JPEGXLCompression.hpp>
+#include <FAST/ThreadPool.hpp>
 #include <QFile>
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <deque>
 #include "TIFFImagePyramidExporter.hpp"
 
+#ifndef COMPRESSION_JXL
+#define	COMPRESSION_JXL 50002
+#endif
+
 
 namespace fast {
 
 void fast::TIFFImagePyramidExporter::loadAttributes() {
     FileExporter::loadAttributes();
+    setNumberOfThreads(getIntegerAttribute("threads"));
+}
+
+void TIFFImagePyramidExporter::setCompressionQuality(int quality) {
+    if(quality < 0 || quality > 100)
+        throw Exception("Compression quality in TIFFImagePyramidExporter must be in the range 0-100");
+    m_compressionQuality = quality;
+    setModified(true);
+}
+
+void TIFFImagePyramidExporter::setNumberOfThreads(int threads) {
+    if(threads < 0)
+        throw Exception("Number of threads in TIFFImagePyramidExporter must be >= 0");
+    m_threads = threads;
+    setModified(true);
+}
+
+int TIFFImagePyramidExporter::getNumberOfThreads() const {
+    return m_threads;
 }
 
 void TIFFImagePyramidExporter::execute() {
@@ -21,21 +50,54 @@ void TIFFImagePyramidExporter::execute() {
     if(imagePyramid == nullptr) {
         reportInfo() << "Data given to TIFFImagePyramidExporter was an Image, not an ImagePyramid, converting ..." << reportEnd();
         auto image = std::dynamic_pointer_cast<Image>(input);
-        imagePyramid = ImagePyramid::create(image->getWidth(), image->getHeight(), image->getNrOfChannels(), 256, 256);
+        if(image->getDataType() != TYPE_UINT8)
+            throw Exception("TIFFImagePyramidExporter only supports 8 bit images");
+        const int tileSize = 256;
+        const int width = image->getWidth();
+        const int height = image->getHeight();
+        const int channels = image->getNrOfChannels();
+        imagePyramid = ImagePyramid::create(width, height, channels, tileSize, tileSize,
+                                            m_compressionSet ? m_compression : ImageCompression::UNSPECIFIED, m_compressionQuality);
         imagePyramid->setSpacing(image->getSpacing());
         SceneGraph::setParentNode(imagePyramid, image);
+        imagePyramid->setDeferredLevelConstruction(true);
+        imagePyramid->setTileEncodingThreads(m_threads > 0 ? m_threads : std::max(1, (int)std::thread::hardware_concurrency()));
         auto access = imagePyramid->getAccess(ACCESS_READ_WRITE);
-        for(int y = 0; y < image->getHeight(); y += 256) {
-            for(int x = 0; x < image->getWidth(); x += 256) {
-                auto width = std::min(image->getWidth() - x - 1, 256);
-                auto height = std::min(image->getHeight() - y - 1, 256);
-                access->setPatch(0, x, y, image->crop(Vector2i(x, y), Vector2i(width, height)));
+        {
+            // Cut the image into padded tiles in parallel, and add them to the pyramid in order
+            auto imageAccess = image->getImageAccess(ACCESS_READ);
+            auto data = (const uchar*)imageAccess->get();
+            ThreadPool pool(m_threads);
+            const int maxTilesInFlight = pool.getNumberOfThreads()*4;
+            std::deque<std::pair<Vector2i, std::future<Image::pointer>>> tiles;
+            auto addNextTile = [&]() {
+                access->setPatch(0, tiles.front().first.x(), tiles.front().first.y(), tiles.front().second.get());
+                tiles.pop_front();
+            };
+            for(int y = 0; y < height; y += tileSize) {
+                for(int x = 0; x < width; x += tileSize) {
+                    tiles.push_back({Vector2i(x, y), pool.submit([=]() {
+                        const std::size_t rowBytes = (std::size_t)tileSize*channels;
+                        auto tile = std::make_unique<uchar[]>(rowBytes*tileSize);
+                        std::memset(tile.get(), channels >= 3 ? 255 : 0, rowBytes*tileSize);
+                        const int copyWidth = std::min(width - x, tileSize);
+                        for(int dy = 0; dy < std::min(height - y, tileSize); ++dy)
+                            std::memcpy(&tile[dy*rowBytes], &data[((std::size_t)x + (std::size_t)(y + dy)*width)*channels], (std::size_t)copyWidth*channels);
+                        return Image::create(tileSize, tileSize, TYPE_UINT8, channels, std::move(tile));
+                    })});
+                    if((int)tiles.size() >= maxTilesInFlight)
+                        addNextTile();
+                }
             }
+            while(!tiles.empty())
+                addNextTile();
         }
+        access->finalize();
     }
 
     if(imagePyramid->usesTIFF()) {
         // If image pyramid is using TIFF backend. It is already stored on disk, we just need to copy it..
+        imagePyramid->waitForPendingTileWrites();
         if(fileExists(m_filename)) {
             // If destination file already exists, we have to remove the existing file, or copy will not run.
             QFile::remove(m_filename.c_str());
@@ -45,6 +107,9 @@ void TIFFImagePyramidExporter::execute() {
     }
     // If not, we need to do a patch based copy
 
+    if(imagePyramid->getDataType() != TYPE_UINT8)
+        throw Exception("TIFFImagePyramidExporter only supports 8 bit image pyramids");
+
     const Vector3f spacing = imagePyramid->getSpacing();
 
     ImageCompression compression = m_compression;
@@ -61,10 +126,67 @@ void TIFFImagePyramidExporter::execute() {
 
     uint photometric = PHOTOMETRIC_RGB;
     uint bitsPerSample = 8;
-    uint samplesPerPixel = 3; // RGBA image pyramid is converted to RGB with getPatchAsImage
+    int samplesPerPixel = 3; // RGBA image pyramid is converted to RGB when tiles are read
     if(imagePyramid->getNrOfChannels() == 1) {
         photometric = PHOTOMETRIC_MINISBLACK; // Photometric mask causes crash..
         samplesPerPixel = 1;
+    } else if(compression == ImageCompression::JPEG) {
+        // libjpeg stores RGB tiles as YCbCr with 4:2:0 subsampling, the tags must say so, as in ImagePyramid
+        photometric = PHOTOMETRIC_YCBCR;
+    }
+
+    // The tiles are compressed by the worker threads, and written with TIFFWriteRawTile.
+    // Thus this function must produce exactly what libtiff would have produced for the compression tag.
+    // LZW is instead encoded by libtiff when the tile is written with TIFFWriteEncodedTile.
+    const int quality = m_compressionQuality;
+    std::function<void(std::vector<uchar>&, int, int, std::vector<uchar>*)> compress;
+    uint16_t compressionTag;
+    bool encodeWithLibTIFF = false;
+    switch(compression) {
+        case ImageCompression::RAW:
+            compressionTag = COMPRESSION_NONE;
+            compress = [](std::vector<uchar>& tile, int width, int height, std::vector<uchar>* compressed) {
+                *compressed = std::move(tile);
+            };
+            break;
+        case ImageCompression::LZW:
+            compressionTag = COMPRESSION_LZW;
+            encodeWithLibTIFF = true;
+            compress = [](std::vector<uchar>& tile, int width, int height, std::vector<uchar>* compressed) {
+                *compressed = std::move(tile);
+            };
+            break;
+        case ImageCompression::DEFLATE:
+            compressionTag = COMPRESSION_ADOBE_DEFLATE;
+            compress = [](std::vector<uchar>& tile, int width, int height, std::vector<uchar>* compressed) {
+                uLongf size = compressBound(tile.size());
+                compressed->resize(size);
+                if(compress2(compressed->data(), &size, tile.data(), tile.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+                    throw Exception("Deflate compression failed in TIFFImagePyramidExporter");
+                compressed->resize(size);
+            };
+            break;
+        case ImageCompression::JPEG:
+            compressionTag = COMPRESSION_JPEG;
+            compress = [quality, samplesPerPixel](std::vector<uchar>& tile, int width, int height, std::vector<uchar>* compressed) {
+                JPEGCompression jpeg;
+                jpeg.compress(tile.data(), width, height, compressed, quality, samplesPerPixel);
+            };
+            break;
+        case ImageCompression::JPEGXL:
+            if(samplesPerPixel != 3)
+                throw Exception("JPEG XL compression in TIFFImagePyramidExporter is only supported for RGB image pyramids");
+            compressionTag = COMPRESSION_JXL;
+            compress = [quality](std::vector<uchar>& tile, int width, int height, std::vector<uchar>* compressed) {
+                JPEGXLCompression jxl;
+                jxl.compress(tile.data(), width, height, compressed, quality);
+            };
+            break;
+        case ImageCompression::JPEG2000:
+        case ImageCompression::NEURAL_NETWORK:
+        default:
+            // TODO NOT IMPLEMENTED
+            throw NotImplementedException();
     }
 
     auto tiff = TIFFOpen(m_filename.c_str(), "w8");
@@ -72,102 +194,104 @@ void TIFFImagePyramidExporter::execute() {
         throw Exception("Unable to open file " + m_filename + " in TIFFImagePyramidExporter");
     }
 
-    // For each level, we need to 1) write fields, 2) write tiles
-    // We have to go from highest res level first
-    for(int level = 0; level < imagePyramid->getNrOfLevels(); ++level) {
-        reportInfo() << "Writing level " << level << reportEnd();
-
-        // Write base tags
-        TIFFSetField(tiff, TIFFTAG_PHOTOMETRIC, photometric);
-        TIFFSetField(tiff, TIFFTAG_BITSPERSAMPLE, bitsPerSample);
-        TIFFSetField(tiff, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_UINT);
-        TIFFSetField(tiff, TIFFTAG_SAMPLESPERPIXEL, (uint16_t)samplesPerPixel);
-        TIFFSetField(tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
-        TIFFSetField(tiff, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
-
-        if(level > 0) {
-            // All levels except highest res level should have this tag?
-            TIFFSetField(tiff, TIFFTAG_SUBFILETYPE, FILETYPE_REDUCEDIMAGE);
-        }
-        switch(compression) {
-            case ImageCompression::RAW:
-                TIFFSetField(tiff, TIFFTAG_COMPRESSION, COMPRESSION_NONE);
-                break;
-            case ImageCompression::LZW:
-                TIFFSetField(tiff, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
-                break;
-            case ImageCompression::JPEG:
-                TIFFSetField(tiff, TIFFTAG_COMPRESSION, COMPRESSION_JPEG);
-                break;
-            case ImageCompression::JPEG2000:
-                // TODO NOT IMPLEMENTED
-                throw NotImplementedException();
-                TIFFSetField(tiff, TIFFTAG_COMPRESSION, COMPRESSION_JP2000);
-                break;
-            case ImageCompression::NEURAL_NETWORK:
-                TIFFSetField(tiff, TIFFTAG_COMPRESSION, 34666); // TODO What should the value be?
-                break;
-        }
+    auto access = imagePyramid->getAccess(ACCESS_READ);
+    const bool isBGRA = imagePyramid->isBGRA();
+    ThreadPool pool(m_threads);
+    // Limit nr of tiles in memory, while keeping all threads busy
+    const int maxTilesInFlight = pool.getNumberOfThreads()*4;
+    try {
+        // For each level, we need to 1) write fields, 2) write tiles
+        // We have to go from highest res level first
+        for(int level = 0; level < imagePyramid->getNrOfLevels(); ++level) {
+            reportInfo() << "Writing level " << level << reportEnd();
 
-        TIFFSetField(tiff, TIFFTAG_TILEWIDTH, imagePyramid->getLevelTileWidth(level));
-        TIFFSetField(tiff, TIFFTAG_TILELENGTH, imagePyramid->getLevelTileHeight(level));
-        TIFFSetField(tiff, TIFFTAG_IMAGEWIDTH, imagePyramid->getLevelWidth(level));
-        TIFFSetField(tiff, TIFFTAG_IMAGELENGTH, imagePyramid->getLevelHeight(level));
-        if(spacing.x() != 1 && spacing.y() != 1) { // Spacing == 1 means not set.
-            TIFFSetField(tiff, TIFFTAG_RESOLUTIONUNIT, RESUNIT_CENTIMETER);
-            float scaleX = (float) imagePyramid->getFullWidth() / imagePyramid->getLevelWidth(level);
-            float scaleY = (float) imagePyramid->getFullHeight() / imagePyramid->getLevelHeight(level);
-            TIFFSetField(tiff, TIFFTAG_XRESOLUTION,
-                         1.0f / (spacing.x() / 10) * scaleX); // Convert to cm, and adjust for level
-            TIFFSetField(tiff, TIFFTAG_YRESOLUTION,
-                         1.0f / (spacing.y() / 10) * scaleY); // Convert to cm, and adjust for level
-        }
+            // Write base tags
+            TIFFSetField(tiff, TIFFTAG_PHOTOMETRIC, photometric);
+            if(photometric == PHOTOMETRIC_YCBCR)
+                TIFFSetField(tiff, TIFFTAG_YCBCRSUBSAMPLING, 2, 2);
+            TIFFSetField(tiff, TIFFTAG_BITSPERSAMPLE, bitsPerSample);
+            TIFFSetField(tiff, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_UINT);
+            TIFFSetField(tiff, TIFFTAG_SAMPLESPERPIXEL, (uint16_t)samplesPerPixel);
+            TIFFSetField(tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+            TIFFSetField(tiff, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+
+            if(level > 0) {
+                // All levels except highest res level should have this tag?
+                TIFFSetField(tiff, TIFFTAG_SUBFILETYPE, FILETYPE_REDUCEDIMAGE);
+            }
+            TIFFSetField(tiff, TIFFTAG_COMPRESSION, compressionTag);
+
+            const int tileWidth = imagePyramid->getLevelTileWidth(level);
+            const int tileHeight = imagePyramid->getLevelTileHeight(level);
+            TIFFSetField(tiff, TIFFTAG_TILEWIDTH, tileWidth);
+            TIFFSetField(tiff, TIFFTAG_TILELENGTH, tileHeight);
+            TIFFSetField(tiff, TIFFTAG_IMAGEWIDTH, imagePyramid->getLevelWidth(level));
+            TIFFSetField(tiff, TIFFTAG_IMAGELENGTH, imagePyramid->getLevelHeight(level));
+            if(spacing.x() != 1 && spacing.y() != 1) { // Spacing == 1 means not set.
+                TIFFSetField(tiff, TIFFTAG_RESOLUTIONUNIT, RESUNIT_CENTIMETER);
+                float scaleX = (float) imagePyramid->getFullWidth() / imagePyramid->getLevelWidth(level);
+                float scaleY = (float) imagePyramid->getFullHeight() / imagePyramid->getLevelHeight(level);
+                TIFFSetField(tiff, TIFFTAG_XRESOLUTION,
+                             1.0f / (spacing.x() / 10) * scaleX); // Convert to cm, and adjust for level
+                TIFFSetField(tiff, TIFFTAG_YRESOLUTION,
+                             1.0f / (spacing.y() / 10) * scaleY); // Convert to cm, and adjust for level
+            }
 
-        std::cout << "starting patch gen" << std::endl;
-        auto generator = PatchGenerator::New();
-        generator->setInputData(imagePyramid);
-        generator->setPatchLevel(level);
-        generator->setPatchSize(imagePyramid->getLevelTileWidth(level), imagePyramid->getLevelTileHeight(level));
-        auto stream = DataStream(generator);
-
-        Image::pointer image;
-        int counter = 0;
-        while(!stream.isDone()) {
-            image = stream.getNextFrame<Image>();
-
-            // Write tile to tiff level
-            if(image->getWidth() != imagePyramid->getLevelTileWidth(level) || image->getHeight() != imagePyramid->getLevelTileHeight(level)) {
-                // Have to pad the image, TIFF expects all tiles to be equal
-                // TODO improve
-                auto paddedImage = Image::create(imagePyramid->getLevelTileWidth(level), imagePyramid->getLevelTileHeight(level), image->getDataType(), image->getNrOfChannels());
-                if(imagePyramid->getNrOfChannels() >= 3) {
-                    paddedImage->fill(255);
+            // Read and compress tiles in parallel, but write them in tile order
+            const int tilesX = imagePyramid->getLevelTilesX(level);
+            const int tilesY = imagePyramid->getLevelTilesY(level);
+            std::deque<std::future<std::vector<uchar>>> tiles;
+            uint32_t tileID = 0;
+            auto writeNextTile = [&]() {
+                auto compressed = tiles.front().get();
+                tiles.pop_front();
+                mRuntimeManager->startRegularTimer("TIFF write");
+                if(encodeWithLibTIFF) {
+                    TIFFWriteEncodedTile(tiff, tileID, compressed.data(), compressed.size());
                 } else {
-                    paddedImage->fill(0);
+                    TIFFWriteRawTile(tiff, tileID, compressed.data(), compressed.size());
                 }
-                auto device = std::dynamic_pointer_cast<OpenCLDevice>(getMainDevice());
-                {
-                    auto dest = paddedImage->getOpenCLImageAccess(ACCESS_READ_WRITE, device);
-                    auto src = image->getOpenCLImageAccess(ACCESS_READ, device);
-                    device->getCommandQueue().enqueueCopyImage(*src->get2DImage(), *dest->get2DImage(),
-                                                               createOrigoRegion(), createOrigoRegion(),
-                                                               createRegion(image->getSize()));
-                    device->getCommandQueue().finish();
+                mRuntimeManager->stopRegularTimer("TIFF write");
+                ++tileID;
+            };
+            for(int tileY = 0; tileY < tilesY; ++tileY) {
+                for(int tileX = 0; tileX < tilesX; ++tileX) {
+                    tiles.push_back(pool.submit([&access, &compress, level, tileX, tileY, tileWidth, tileHeight, samplesPerPixel, isBGRA]() {
+                        auto image = access->getPatchAsImage(level, tileX, tileY, false);
+                        auto imageAccess = image->getImageAccess(ACCESS_READ);
+                        auto data = (const uchar*)imageAccess->get();
+                        const int width = image->getWidth();
+                        const int height = image->getHeight();
+                        const int channels = image->getNrOfChannels();
+                        // TIFF expects all tiles to be equal, thus pad edge tiles.
+                        // Also remove alpha channel, and convert BGRA to RGB if needed.
+                        std::vector<uchar> tile((std::size_t)tileWidth*tileHeight*samplesPerPixel, samplesPerPixel >= 3 ? 255 : 0);
+                        for(int y = 0; y < height; ++y) {
+                            for(int x = 0; x < width; ++x) {
+                                const uchar* src = &data[((std::size_t)x + (std::size_t)y*width)*channels];
+                                uchar* dest = &tile[((std::size_t)x + (std::size_t)y*tileWidth)*samplesPerPixel];
+                                for(int c = 0; c < samplesPerPixel; ++c)
+                                    dest[c] = src[isBGRA ? 2 - c : c];
+                            }
+                        }
+                        std::vector<uchar> compressed;
+                        compress(tile, tileWidth, tileHeight, &compressed);
+                        return compressed;
+                    }));
+                    if((int)tiles.size() >= maxTilesInFlight)
+                        writeNextTile();
                 }
-                if(image->isLastFrame())
-                    paddedImage->setLastFrame("PatchGenerator");
-                image = paddedImage;
             }
-            auto data = image->getImageAccess(ACCESS_READ)->get();
-            std::size_t byteSize = getSizeOfDataType(image->getDataType(), image->getNrOfChannels())*image->getNrOfVoxels();
-            mRuntimeManager->startRegularTimer("TIFF write");
-            TIFFWriteEncodedTile(tiff, counter, data, byteSize);
-            mRuntimeManager->stopRegularTimer("TIFF write");
-            ++counter;
-            mRuntimeManager->printAll();
-        } while(!image->isLastFrame());
-
-        TIFFWriteDirectory(tiff);
+            while(!tiles.empty())
+                writeNextTile();
+
+            TIFFWriteDirectory(tiff);
+        }
+    } catch(...) {
+        // Tasks may still refer to access and compress, thus wait for them before cleaning up
+        pool.waitForAll();
+        TIFFClose(tiff);
+        throw;
     }
 
     TIFFClose(tiff);
@@ -180,6 +304,7 @@ TIFFImagePyramidExporter::TIFFImagePyramidExporter(std::string filename, ImageCo
     createInputPort<ImagePyramid>(0);
     if(compression != ImageCompression::UNSPECIFIED)
         setCompression(compression);
+    createIntegerAttribute("threads", "Threads", "Number of threads used to read and compress tiles. 0 means use all hardware threads.", m_threads);
 }
 
 void TIFFImagePyramidExporter::setCompression(ImageCompression compression) {
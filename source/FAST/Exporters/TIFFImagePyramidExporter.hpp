@@ -8,6 +8,9 @@ namespace fast {
 /**
  * @brief Export an ImagePyramid to disk in the tiled pyramid TIFF format.
  *
+ * Tiles are read and compressed in parallel on a pool of threads, and written to the file in tile order.
+ * LZW compressed tiles are encoded by libtiff in the writing thread.
+ *
  * @ingroup exporter wsi
  * @sa TIFFImagePyramidImporter
  */
@@ -19,6 +22,17 @@ public:
                      ImageCompression, compression, = ImageCompression::UNSPECIFIED
     )
     void setCompression(ImageCompression compression);
+    /**
+     * @brief Set compression quality for lossy compression (JPEG and JPEG XL)
+     * @param quality Quality 0-100. Default is 90.
+     */
+    void setCompressionQuality(int quality);
+    /**
+     * @brief Set number of threads used to read and compress tiles
+     * @param threads Number of threads. If 0, the number of hardware threads is used. Default is 0.
+     */
+    void setNumberOfThreads(int threads);
+    int getNumberOfThreads() const;
     void loadAttributes() override;
 protected:
     TIFFImagePyramidExporter();
@@ -26,6 +40,8 @@ protected:
 
     bool m_compressionSet = false;
     ImageCompression m_compression;
+    int m_compressionQuality = 90;
+    int m_threads = 0;
 };
 
 }
\ No newline at end of file
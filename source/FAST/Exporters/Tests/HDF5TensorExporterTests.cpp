@@ -1,6 +1,7 @@
 #include <FAST/Testing.hpp>
 #include <FAST/Exporters/HDF5TensorExporter.hpp>
 #include <FAST/Data/Tensor.hpp>
+#include <FAST/Importers/HDF5TensorImporter.hpp>
 
 namespace fast {
 
@@ -14,4 +15,33 @@ TEST_CASE("Write tensor as HDF5", "[fast][HDF5TensorExporter][HDF5]") {
 	exporter->update();
 }
 
-}
\ No newline at end of file
+TEST_CASE("Stream tensors to HDF5 with compression", "[fast][HDF5TensorExporter][HDF5]") {
+    const int frames = 10;
+    TensorShape shape({4, 8});
+    auto exporter = HDF5TensorExporter::create("tensor_stream.hd5", "tensor", true, 6);
+    exporter->setMaximumQueueSize(2);
+    for(int frame = 0; frame < frames; ++frame) {
+        std::vector<float> data(shape.getTotalSize(), (float)frame);
+        auto tensor = Tensor::create(data.data(), shape);
+        if(frame == frames-1)
+            tensor->setLastFrame("test");
+        exporter->connect(tensor);
+        exporter->run();
+    }
+    // Last frame closes the file
+    CHECK(exporter->getNrOfFramesWritten() == frames);
+
+    auto importer = HDF5TensorImporter::create("tensor_stream.hd5", "tensor");
+    auto result = importer->runAndGetOutputData<Tensor>();
+    auto resultShape = result->getShape();
+    REQUIRE(resultShape.getDimensions() == 3);
+    CHECK(resultShape[0] == frames);
+    CHECK(resultShape[1] == 4);
+    CHECK(resultShape[2] == 8);
+    auto access = result->getAccess(ACCESS_READ);
+    const float* data = access->getRawData();
+    for(int frame = 0; frame < frames; ++frame)
+        CHECK(data[frame*32 + 31] == (float)frame);
+}
+
+}
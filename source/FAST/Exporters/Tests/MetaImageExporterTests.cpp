@@ -349,3 +349,29 @@ TEST_CASE("Write a compressed 3D image with the MetaImageExporter", "[fast][Meta
         }
     }
 }
+
+TEST_CASE("Write a compressed 3D image in multiple chunks with the MetaImageExporter", "[fast][MetaImageExporter]") {
+    const uint width = 64, height = 48, depth = 32;
+    void* data = allocateRandomData(width*height*depth, TYPE_UINT16);
+    auto image = Image::create(width, height, depth, TYPE_UINT16, 1, Host::getInstance(), data);
+
+    auto exporter = MetaImageExporter::create("MetaImageExporterTestChunks.mhd", true);
+    exporter->setCompressionChunkSize(10000); // Last chunk is smaller than the rest
+    exporter->setNumberOfThreads(4);
+    exporter->connect(image);
+    exporter->run();
+
+    for(int threads : {1, 0}) {
+        auto importer = MetaImageImporter::create("MetaImageExporterTestChunks.mhd");
+        importer->setNumberOfThreads(threads);
+        auto image2 = importer->runAndGetOutputData<Image>();
+        CHECK(image2->getWidth() == width);
+        CHECK(image2->getHeight() == height);
+        CHECK(image2->getDepth() == depth);
+        CHECK(image2->getDataType() == TYPE_UINT16);
+        CHECK(image2->getMetadata().count("CompressedDataChunkSizes") == 0);
+        auto access = image2->getImageAccess(ACCESS_READ);
+        CHECK(compareDataArrays(data, access->get(), width*height*depth, TYPE_UINT16) == true);
+    }
+    deleteArray(data, TYPE_UINT16);
+}
@@ -0,0 +1,74 @@
+#include "FAST/Testing.hpp"
+#include "FAST/Exporters/StreamToFileExporter.hpp"
+#include "FAST/Data/Image.hpp"
+#include "FAST/Utility.hpp"
+#include <chrono>
+#include <thread>
+
+using namespace fast;
+
+TEST_CASE("StreamToFileExporter writes all frames in background thread", "[fast][StreamToFileExporter]") {
+    auto exporter = StreamToFileExporter::create("stream_to_file_test", "async_frames");
+    exporter->setMaximumQueueSize(2);
+    for(int i = 0; i < 10; ++i) {
+        auto image = Image::create(64, 64, TYPE_UINT8, 1);
+        image->fill(i);
+        exporter->connect(image);
+        auto output = exporter->runAndGetOutputData<Image>();
+        CHECK(output == image);
+        CHECK(exporter->getNrOfQueuedFrames() <= 2);
+    }
+    exporter->flush();
+    CHECK(exporter->getFrameCounter() == 10);
+    CHECK(exporter->getNrOfWrittenFrames() == 10);
+    CHECK(exporter->getNrOfDroppedFrames() == 0);
+    CHECK(exporter->getNrOfQueuedFrames() == 0);
+    for(int i = 0; i < 10; ++i)
+        CHECK(fileExists(join(exporter->getCurrentDestinationFolder(), "frame_" + std::to_string(i) + ".mhd")));
+}
+
+TEST_CASE("StreamToFileExporter drop policy never blocks", "[fast][StreamToFileExporter]") {
+    auto exporter = StreamToFileExporter::create("stream_to_file_test", "drop_frames");
+    exporter->setMaximumQueueSize(1);
+    exporter->setQueueFullPolicy(QueueFullPolicy::DropFrame);
+
+    // Stall the writer thread: it can't read the first frame while we hold a write access to it
+    auto stalledImage = Image::create(64, 64, TYPE_UINT8, 1);
+    auto stalledAccess = stalledImage->getImageAccess(ACCESS_READ_WRITE);
+    exporter->connect(stalledImage);
+    exporter->run();
+    while(exporter->getNrOfQueuedFrames() > 0) // Wait for writer thread to pick up the frame
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    // First frame fills the queue, the rest should be dropped without blocking
+    for(int i = 0; i < 10; ++i) {
+        auto image = Image::create(64, 64, TYPE_UINT8, 1);
+        image->fill(i);
+        exporter->connect(image);
+        auto start = std::chrono::high_resolution_clock::now();
+        exporter->run();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
+        CHECK(duration.count() < 1000);
+        CHECK(exporter->getNrOfQueuedFrames() == 1);
+    }
+    CHECK(exporter->getNrOfWrittenFrames() == 0);
+    CHECK(exporter->getNrOfDroppedFrames() == 9);
+    CHECK(exporter->getFrameCounter() == 2);
+
+    stalledAccess->release();
+    exporter->flush();
+    CHECK(exporter->getNrOfWrittenFrames() == 2);
+    // Dropped frames should not leave gaps in the file numbers
+    CHECK(fileExists(join(exporter->getCurrentDestinationFolder(), "frame_0.mhd")));
+    CHECK(fileExists(join(exporter->getCurrentDestinationFolder(), "frame_1.mhd")));
+}
+
+TEST_CASE("StreamToFileExporter synchronous mode", "[fast][StreamToFileExporter]") {
+    auto exporter = StreamToFileExporter::create("stream_to_file_test", "sync_frames");
+    exporter->setAsynchronous(false);
+    auto image = Image::create(64, 64, TYPE_UINT8, 1);
+    exporter->connect(image);
+    exporter->run();
+    CHECK(exporter->getNrOfWrittenFrames() == 1);
+    CHECK(exporter->getNrOfQueuedFrames() == 0);
+}
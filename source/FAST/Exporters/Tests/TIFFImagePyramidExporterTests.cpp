@@ -11,6 +11,7 @@
 #include <FAST/Algorithms/ImagePatch/PatchStitcher.hpp>
 #include <FAST/Importers/TIFFImagePyramidImporter.hpp>
 #include <FAST/Algorithms/TissueSegmentation/TissueSegmentation.hpp>
+#include <cstring>
 
 using namespace fast;
 
@@ -32,6 +33,67 @@ TEST_CASE("TIFFImagePyramidExporter", "[fast][TIFFImagePyramidExporter][wsi][vis
     exporter->getAllRuntimes()->printAll();
 }
 
+TEST_CASE("TIFFImagePyramidExporter parallel LZW export is lossless", "[fast][TIFFImagePyramidExporter][wsi]") {
+    auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
+    auto input = importer->runAndGetOutputData<ImagePyramid>();
+
+    auto exporter = TIFFImagePyramidExporter::create("image-pyramid-lzw-test.tiff", ImageCompression::LZW)
+            ->connect(input);
+    exporter->setNumberOfThreads(4);
+    exporter->run();
+
+    auto importer2 = TIFFImagePyramidImporter::create("image-pyramid-lzw-test.tiff");
+    auto output = importer2->runAndGetOutputData<ImagePyramid>();
+    REQUIRE(output->getNrOfLevels() == input->getNrOfLevels());
+    for(int level = 0; level < input->getNrOfLevels(); ++level) {
+        CHECK(output->getLevelWidth(level) == input->getLevelWidth(level));
+        CHECK(output->getLevelHeight(level) == input->getLevelHeight(level));
+    }
+
+    // Compare a tile at the lowest resolution level
+    const int level = input->getNrOfLevels()-1;
+    const int width = std::min(input->getLevelTileWidth(level), input->getLevelWidth(level));
+    const int height = std::min(input->getLevelTileHeight(level), input->getLevelHeight(level));
+    auto expected = input->getAccess(ACCESS_READ)->getPatchAsImage(level, 0, 0, width, height);
+    auto result = output->getAccess(ACCESS_READ)->getPatchAsImage(level, 0, 0, width, height);
+    REQUIRE(result->getNrOfChannels() == expected->getNrOfChannels());
+    auto expectedAccess = expected->getImageAccess(ACCESS_READ);
+    auto resultAccess = result->getImageAccess(ACCESS_READ);
+    CHECK(std::memcmp(expectedAccess->get(), resultAccess->get(), (std::size_t)width*height*expected->getNrOfChannels()) == 0);
+}
+
+TEST_CASE("TIFFImagePyramidExporter parallel JPEG export keeps colors", "[fast][TIFFImagePyramidExporter][wsi]") {
+    auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
+    auto input = importer->runAndGetOutputData<ImagePyramid>();
+
+    auto exporter = TIFFImagePyramidExporter::create("image-pyramid-jpeg-test.tiff", ImageCompression::JPEG)
+            ->connect(input);
+    exporter->setNumberOfThreads(4);
+    exporter->run();
+
+    auto importer2 = TIFFImagePyramidImporter::create("image-pyramid-jpeg-test.tiff");
+    auto output = importer2->runAndGetOutputData<ImagePyramid>();
+    REQUIRE(output->getNrOfLevels() == input->getNrOfLevels());
+
+    // JPEG is lossy, thus compare the mean absolute difference of a tile at the lowest resolution level.
+    // If the color space is wrong, the difference is large.
+    const int level = input->getNrOfLevels()-1;
+    const int width = std::min(input->getLevelTileWidth(level), input->getLevelWidth(level));
+    const int height = std::min(input->getLevelTileHeight(level), input->getLevelHeight(level));
+    auto expected = input->getAccess(ACCESS_READ)->getPatchAsImage(level, 0, 0, width, height);
+    auto result = output->getAccess(ACCESS_READ)->getPatchAsImage(level, 0, 0, width, height);
+    REQUIRE(result->getNrOfChannels() == expected->getNrOfChannels());
+    auto expectedAccess = expected->getImageAccess(ACCESS_READ);
+    auto resultAccess = result->getImageAccess(ACCESS_READ);
+    auto expectedData = (const uchar*)expectedAccess->get();
+    auto resultData = (const uchar*)resultAccess->get();
+    const std::size_t size = (std::size_t)width*height*expected->getNrOfChannels();
+    double difference = 0.0;
+    for(std::size_t i = 0; i < size; ++i)
+        difference += std::abs((int)expectedData[i] - (int)resultData[i]);
+    CHECK(difference / size < 5.0);
+}
+
 TEST_CASE("TIFFImagePyramidExporter segmentation2", "[fast][TIFFImagePyramidExporter][wsi][visual]") {
     auto importer = WholeSlideImageImporter::create(Config::getTestDataPath() + "/WSI/CMU-1.svs");
     //importer->setFilename("/home/smistad/Downloads/OS-1.tiff");
@@ -4,15 +4,18 @@
 #include <dcmtk/dcmdata/dcdeftag.h>
 #include <dcmtk/dcmimgle/dcmimage.h>
 #include "FAST/Data/Image.hpp"
+#include <FAST/ThreadPool.hpp>
+#include <algorithm>
 
 namespace fast {
 
 DICOMFileImporter::DICOMFileImporter() {
     createOutputPort<Image>(0);
+    createIntegerAttribute("threads", "Threads", "Number of threads used to decode the slices of a series. 0 means use all hardware threads.", m_threads);
 }
 
-DICOMFileImporter::DICOMFileImporter(std::string filename, bool loadSeries) : FileImporter(filename) {
-    createOutputPort<Image>(0);
+DICOMFileImporter::DICOMFileImporter(std::string filename, bool loadSeries) : DICOMFileImporter() {
+    setFilename(filename);
     setLoadSeries(loadSeries);
 }
 
@@ -21,6 +24,22 @@ void DICOMFileImporter::setLoadSeries(bool load) {
     mIsModified = true;
 }
 
+void DICOMFileImporter::setNumberOfThreads(int threads) {
+    if(threads < 0)
+        throw Exception("Number of threads in DICOMFileImporter must be >= 0");
+    m_threads = threads;
+    mIsModified = true;
+}
+
+int DICOMFileImporter::getNumberOfThreads() const {
+    return m_threads;
+}
+
+void DICOMFileImporter::loadAttributes() {
+    FileImporter::loadAttributes();
+    setNumberOfThreads(getIntegerAttribute("threads"));
+}
+
 template <class T>
 static void* readRawData(const DiPixel* pixelData) {
     const void* data = pixelData->getData();
@@ -84,41 +103,75 @@ static void* getDataFromImage(const DicomImage &image, DataType &type) {
     return data;
 }
 
-static void* inserSliceFromImage(const DicomImage &image, int width, int height, int sliceNr, void* data) {
-    const DiPixel* pixelData = image.getInterData();
-    EP_Representation rep = pixelData->getRepresentation();
-    int currentPosition = width*height*sliceNr;
-    DataType type;
-    void* sliceData;
-    switch(rep) {
-        case EPR_Sint8:
-            type = TYPE_INT8;
-            sliceData = readRawData<char>(pixelData);
-            memcpy((char*)data + currentPosition, sliceData, width*height*getSizeOfDataType(type, 1));
-            break;
-        case EPR_Uint8:
-            type = TYPE_UINT8;
-            sliceData = readRawData<uchar>(pixelData);
-            memcpy((uchar*)data + currentPosition, sliceData, width*height*getSizeOfDataType(type, 1));
-            break;
-        case EPR_Sint16:
-            type = TYPE_INT16;
-            sliceData = readRawData<short>(pixelData);
-            memcpy((short*)data + currentPosition, sliceData, width*height*getSizeOfDataType(type, 1));
-            break;
-        case EPR_Uint16:
-            type = TYPE_UINT16;
-            sliceData = readRawData<ushort>(pixelData);
-            memcpy((ushort*)data + currentPosition, sliceData, width*height*getSizeOfDataType(type, 1));
-            break;
-        case EPR_Sint32:
-        case EPR_Uint32:
-            throw Exception("Unsupported data type of 32 bit integer in DICOMFileImporter");
-            break;
+std::vector<std::string> DICOMFileImporter::getSeriesFiles(const std::string& filename, ThreadPool* pool) {
+    DcmFileFormat fileformat;
+    OFCondition status = fileformat.loadFile(filename.c_str());
+    if(!status.good())
+        throw Exception("Error: cannot read DICOM file " + filename + "(" + std::string(status.text()) + ")");
+    OFString seriesID;
+    if(!fileformat.getDataset()->findAndGetOFString(DCM_SeriesInstanceUID, seriesID).good())
+        throw Exception("Could not get series instance UID of DICOM file.");
+
+    // Get all files in directory which has same series instance UID.
+    // Only the header is needed, thus stop reading at the pixel data.
+    const std::string dirName = getDirName(filename);
+    const std::vector<std::string> files = getDirectoryList(dirName);
+    std::vector<std::pair<Sint32, std::string>> seriesFiles(files.size(), {-1, ""});
+    auto readHeader = [&](int i) {
+        const std::string file = dirName + "/" + files[i];
+        DcmFileFormat fileformat2;
+        if(!fileformat2.loadFileUntilTag(file.c_str(), EXS_Unknown, EGL_noChange, DCM_MaxReadLength, ERM_autoDetect, DCM_PixelData).good())
+            return;
+        OFString seriesID2;
+        fileformat2.getDataset()->findAndGetOFString(DCM_SeriesInstanceUID, seriesID2);
+        if(seriesID == seriesID2) {
+            Sint32 instanceNr = 0;
+            fileformat2.getDataset()->findAndGetSint32(DCM_InstanceNumber, instanceNr);
+            seriesFiles[i] = {instanceNr, file};
+        }
+    };
+    if(pool == nullptr) {
+        for(int i = 0; i < files.size(); ++i)
+            readHeader(i);
+    } else {
+        std::vector<std::future<void>> futures;
+        for(int i = 0; i < files.size(); ++i)
+            futures.push_back(pool->submit([&readHeader, i]() { readHeader(i); }));
+        // Wait for all before getting any exception, since the tasks refer to local variables
+        pool->waitForAll();
+        for(auto&& future : futures)
+            future.get();
     }
-    deleteArray(sliceData, type);
 
-    return data;
+    std::sort(seriesFiles.begin(), seriesFiles.end());
+    std::vector<std::string> result;
+    for(auto&& item : seriesFiles) {
+        if(!item.second.empty())
+            result.push_back(item.second);
+    }
+    return result;
+}
+
+void DICOMFileImporter::readSlice(const std::string& filename, void* destination, std::size_t bytes) {
+    DicomImage image(filename.c_str());
+    if(image.getStatus() != EIS_Normal)
+        throw Exception("Error reading DICOM slice " + filename + ": " + std::string(DicomImage::getString(image.getStatus())));
+    const DiPixel* pixelData = image.getInterData();
+    const DataType type = getDataType(image);
+    const std::size_t sliceBytes = pixelData->getCount()*getSizeOfDataType(type, 1);
+    if(sliceBytes > bytes)
+        throw Exception("DICOM slice " + filename + " is larger than the other slices in the series");
+    // Copy directly from the decoded pixel data to the destination
+    std::memcpy(destination, pixelData->getData(), sliceBytes);
+}
+
+DataType DICOMFileImporter::getSliceInfo(const std::string& filename, int* width, int* height) {
+    DicomImage image(filename.c_str());
+    if(image.getStatus() != EIS_Normal)
+        throw Exception("Error reading DICOM slice " + filename + ": " + std::string(DicomImage::getString(image.getStatus())));
+    *width = image.getWidth();
+    *height = image.getHeight();
+    return getDataType(image);
 }
 
 void DICOMFileImporter::execute() {
@@ -136,48 +189,39 @@ void DICOMFileImporter::execute() {
         fileformat.getDataset()->findAndGetFloat64(DCM_PixelSpacing, spacingY, 1);
         fileformat.getDataset()->findAndGetFloat64(DCM_SliceThickness, spacingZ);
         if(mLoadSeries) {
-            // Get series ID first
-            OFString seriesID;
-            if(!fileformat.getDataset()->findAndGetOFString(DCM_SeriesInstanceUID, seriesID).good())
-                throw Exception("Could not get series instance UID of DICOM file.");
-
-            // Get all files in directory which has same series instance UID
-            std::string dirName = getDirName(m_filename);
-            std::vector<std::string> files = getDirectoryList(dirName);
-            std::vector<std::string> seriesFiles;
-            for(auto&& file : files) {
-                OFString seriesID2;
-                DcmFileFormat fileformat2;
-                OFCondition status = fileformat2.loadFile((dirName + "/" + file).c_str());
-                fileformat2.getDataset()->findAndGetOFString(DCM_SeriesInstanceUID, seriesID2);
-                if(seriesID == seriesID2) {
-                    seriesFiles.push_back(dirName + "/" + file);
-                }
-            }
+            ThreadPool pool(m_threads);
+            const std::vector<std::string> seriesFiles = getSeriesFiles(m_filename, &pool);
 
             // Get size and type of image
-            DicomImage image(m_filename.c_str());
-            const int width = image.getWidth();
-            const int height = image.getHeight();
+            int width, height;
+            const DataType type = getSliceInfo(m_filename, &width, &height);
             const int depth = seriesFiles.size();
-            const DataType type = getDataType(image);
+            reportInfo() << "Loading DICOM series with " << depth << " slices" << reportEnd();
 
-			std::cout << "DEPTH: " << depth << std::endl;
             // Allocate space for volume
-            void* data = allocateDataArray(width*height*depth, type, 1);
-
-            // Get data of each slice
-            for(auto&& file : seriesFiles) {
-                DcmFileFormat fileformat2;
-                OFCondition status = fileformat2.loadFile(file.c_str());
-                Sint32 sliceNr;
-                fileformat2.getDataset()->findAndGetSint32(DCM_InstanceNumber, sliceNr);
-                inserSliceFromImage(DicomImage(file.c_str()), width, height, sliceNr-1, data);
+            auto data = allocatePixelArray((std::size_t)width*height*depth, type);
+
+            // Decode each slice in parallel directly into its position in the volume
+            const std::size_t sliceBytes = (std::size_t)width*height*getSizeOfDataType(type, 1);
+            std::vector<std::future<void>> futures;
+            for(int i = 0; i < depth; ++i) {
+                futures.push_back(pool.submit([&seriesFiles, volume = (uchar*)data.get(), sliceBytes, i]() {
+                    readSlice(seriesFiles[i], volume + i*sliceBytes, sliceBytes);
+                }));
+            }
+            try {
+                for(auto&& future : futures)
+                    future.get();
+            } catch(...) {
+                pool.waitForAll();
+                throw;
             }
 
-            auto output = Image::create(image.getWidth(), image.getHeight(), seriesFiles.size(), type, 1, data);
+            // Give the host data to the image to avoid copying the volume
+            VectorXui size(3);
+            size << width, height, depth;
+            auto output = Image::create(size, type, 1, std::move(data));
             output->setSpacing(spacingX, spacingY, spacingZ);
-            deleteArray(data, type);
             addOutputData(0, output);
         } else {
             DicomImage image(m_filename.c_str());
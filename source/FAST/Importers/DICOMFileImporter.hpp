@@ -2,13 +2,18 @@
 
 #include <FAST/Importers/FileImporter.hpp>
 #include <string>
+#include <vector>
 
 namespace fast {
 
+class ThreadPool;
+
 /**
  * @brief Read DICOM image data (both 2D and 3D).
  *
  * This importer uses the DCMTK library to load DICOM image data from disk.
+ * When loading a series, the slices are decoded in parallel directly into the output volume,
+ * see setNumberOfThreads. To get progress while a large series is being loaded, use DicomSeriesStreamer.
  *
  * @ingroup importers
  */
@@ -20,11 +25,43 @@ class FAST_EXPORT DICOMFileImporter : public FileImporter {
                          bool, loadSeries, = true
         )
         void setLoadSeries(bool load);
+        /**
+         * @brief Set number of threads used to decode the slices of a series
+         * @param threads Number of threads. If 0, the number of hardware threads is used. Default is 0.
+         */
+        void setNumberOfThreads(int threads);
+        int getNumberOfThreads() const;
+        void loadAttributes() override;
+#ifndef SWIG
+        /**
+         * @brief Find all files in the same directory as the given DICOM file which belong to the same series
+         * @param filename DICOM file
+         * @param pool Thread pool used to read the file headers. If nullptr, headers are read in the calling thread.
+         * @return files sorted by instance number
+         */
+        static std::vector<std::string> getSeriesFiles(const std::string& filename, ThreadPool* pool = nullptr);
+        /**
+         * @brief Decode a single frame DICOM file and copy its pixels to a destination buffer
+         * @param filename DICOM file
+         * @param destination Buffer which must be at least width*height*bytes per pixel large
+         * @param bytes Size of destination buffer in bytes
+         */
+        static void readSlice(const std::string& filename, void* destination, std::size_t bytes);
+        /**
+         * @brief Get the size and data type of a single frame DICOM file
+         * @param filename DICOM file
+         * @param width Set to the width of the frame
+         * @param height Set to the height of the frame
+         * @return data type of the pixels
+         */
+        static DataType getSliceInfo(const std::string& filename, int* width, int* height);
+#endif
     private:
         DICOMFileImporter();
         void execute() override;
 
         bool mLoadSeries = true;
+        int m_threads = 0;
 };
 
 }
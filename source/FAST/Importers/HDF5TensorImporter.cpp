@@ -33,6 +33,7 @@ void HDF5TensorImporter::execute() {
 
 
 	// Open file
+	std::unique_lock<std::mutex> hdf5Lock(getHDF5Mutex());
 	H5::H5File file(m_filename.c_str(), H5F_ACC_RDONLY);
 
 	auto dataset = file.openDataSet(m_datasetName.c_str());
@@ -56,6 +56,8 @@ void ImagePyramidPatchImporter::execute() {
     // We here also make sure that width and height are dividable by the tile width and height.
     auto pyramid = ImagePyramid::create(width + (image->getWidth() - width % image->getWidth()), height + (image->getHeight() - height % image->getHeight()), channels, image->getWidth(), image->getHeight());
     pyramid->setSpacing(Vector3f(spacingX, spacingY, 1.0f));
+    // All patches are written before the pyramid is used, thus build the lower resolution levels at the end
+    pyramid->setDeferredLevelConstruction(true);
 
     auto outputAccess = pyramid->getAccess(ACCESS_READ_WRITE);
 
@@ -82,6 +84,7 @@ void ImagePyramidPatchImporter::execute() {
         const auto endY = startY + patch->getHeight();
         outputAccess->setPatch(0, startX, startY, patch);
     }
+    outputAccess->finalize();
 
     addOutputData(0, pyramid);
 }
@@ -2,9 +2,21 @@
 #include "FAST/Exception.hpp"
 #include "FAST/Data/Image.hpp"
 #include "FAST/Utility.hpp"
+#include "FAST/ThreadPool.hpp"
 #include <fstream>
 #include <set>
 #include <zlib/zlib.h>
+#ifdef WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 using namespace fast;
 
 MetaImageImporter::MetaImageImporter() {
@@ -12,11 +24,39 @@ MetaImageImporter::MetaImageImporter() {
     mIsModified = true;
     createOutputPort(0, "Image");
     setMainDevice(Host::getInstance()); // Default is to put image on host
+    createBooleanAttribute("memory-mapping", "Memory mapping", "Memory map uncompressed raw files instead of reading them", m_memoryMapping);
+    createIntegerAttribute("threads", "Threads", "Number of threads used to decompress chunked raw files. 0 means use all hardware threads.", m_threads);
 }
 
-MetaImageImporter::MetaImageImporter(std::string filename) : FileImporter(filename) {
-    createOutputPort(0, "Image");
-    setMainDevice(Host::getInstance()); // Default is to put image on host
+MetaImageImporter::MetaImageImporter(std::string filename, bool memoryMapping) : MetaImageImporter() {
+    setFilename(filename);
+    setMemoryMapping(memoryMapping);
+}
+
+void MetaImageImporter::setMemoryMapping(bool memoryMapping) {
+    m_memoryMapping = memoryMapping;
+    mIsModified = true;
+}
+
+bool MetaImageImporter::getMemoryMapping() const {
+    return m_memoryMapping;
+}
+
+void MetaImageImporter::setNumberOfThreads(int threads) {
+    if(threads < 0)
+        throw Exception("Number of threads in MetaImageImporter must be >= 0");
+    m_threads = threads;
+    mIsModified = true;
+}
+
+int MetaImageImporter::getNumberOfThreads() const {
+    return m_threads;
+}
+
+void MetaImageImporter::loadAttributes() {
+    FileImporter::loadAttributes();
+    setMemoryMapping(getBooleanAttribute("memory-mapping"));
+    setNumberOfThreads(getIntegerAttribute("threads"));
 }
 
 std::vector<std::string> stringSplit(std::string str, std::string delimiter) {
@@ -37,51 +77,158 @@ std::vector<std::string> stringSplit(std::string str, std::string delimiter) {
     return values;
 }
 
-template <class T>
-static std::unique_ptr<T[]> readRawData(std::string rawFilename, std::size_t voxels, unsigned int nrOfComponents, bool compressed, std::size_t compressedFileSize) {
-    auto data = make_uninitialized_unique<T[]>(voxels*nrOfComponents);
-    if(compressed) {
-        // Read compressed data
-        std::ifstream file(rawFilename, std::ifstream::binary | std::ifstream::in);
-        if(!file.is_open())
-            throw FileNotFoundException(rawFilename);
-
-        // Determine the file length
-        file.seekg(0, std::ios_base::end);
-        std::size_t size = file.tellg();
-        file.seekg(0, std::ios_base::beg);
-
-        auto fileData = make_uninitialized_unique<Bytef[]>(size);
-        file.read((char*)&fileData[0], size);
-        file.close();
-
-        unsigned long uncompressedSize = sizeof(T)*voxels*nrOfComponents;
-		int z_result = uncompress(
-            (Bytef*)data.get(),       // destination for the uncompressed
-                                    // data.  This should be the size of
-                                    // the original data, which you should
-                                    // already know.
-
-            (uLongf *)&uncompressedSize,  // length of destination (uncompressed)
-                                    // buffer
-
-            fileData.get(),   // source buffer - the compressed data
+/**
+ * Map an entire file into memory. The returned pointer unmaps the file when deleted.
+ * If writable is true, the mapping is copy-on-write, thus the file itself is never changed.
+ */
+static unique_pixel_ptr memoryMapFile(const std::string& filename, bool writable, std::size_t& size) {
+#ifdef WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE)
+        throw FileNotFoundException(filename);
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        throw Exception("Unable to memory map empty file " + filename);
+    }
+    size = fileSize.QuadPart;
+    HANDLE mapping = CreateFileMappingA(file, NULL, writable ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if(mapping == NULL)
+        throw Exception("Unable to memory map file " + filename);
+    void* data = MapViewOfFile(mapping, writable ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // The view keeps the mapping alive
+    if(data == NULL)
+        throw Exception("Unable to memory map file " + filename);
+    return unique_pixel_ptr(data, [](void* data) { UnmapViewOfFile(data); });
+#else
+    int file = open(filename.c_str(), O_RDONLY);
+    if(file < 0)
+        throw FileNotFoundException(filename);
+    struct stat fileInfo;
+    if(fstat(file, &fileInfo) != 0 || fileInfo.st_size == 0) {
+        close(file);
+        throw Exception("Unable to memory map empty file " + filename);
+    }
+    size = fileInfo.st_size;
+    void* data = mmap(NULL, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, file, 0);
+    close(file); // The mapping is still valid after the file is closed
+    if(data == MAP_FAILED)
+        throw Exception("Unable to memory map file " + filename);
+    return unique_pixel_ptr(data, [size](void* data) { munmap(data, size); });
+#endif
+}
 
-            (uLong)compressedFileSize);   // length of compressed data in bytes
-        switch( z_result )
-        {
-        case Z_OK:
-            break;
+static void inflateChunk(const uchar* source, std::size_t sourceSize, uchar* destination, std::size_t destinationSize) {
+    z_stream stream = {};
+    if(inflateInit2(&stream, -MAX_WBITS) != Z_OK) // Raw deflate data, no zlib header
+        throw Exception("Unable to initialize zlib while decompressing raw file");
+    stream.next_in = (Bytef*)source;
+    stream.avail_in = (uInt)sourceSize;
+    stream.next_out = (Bytef*)destination;
+    stream.avail_out = (uInt)destinationSize;
+    // Chunks are ended by a full flush instead of the end of stream, except for the last one
+    int z_result = inflate(&stream, Z_SYNC_FLUSH);
+    std::size_t decompressedSize = stream.total_out;
+    inflateEnd(&stream);
+    if((z_result != Z_OK && z_result != Z_STREAM_END && z_result != Z_BUF_ERROR) || decompressedSize != destinationSize)
+        throw Exception("Error while decompressing chunk of raw file");
+}
 
-        case Z_MEM_ERROR:
-            throw Exception("Out of memory while decompressing raw file");
-            break;
+/**
+ * Decompress a zlib stream which was compressed as independent chunks separated by full flushes.
+ * Each chunk is decompressed directly into the destination in parallel.
+ */
+static void inflateChunks(const uchar* source, std::size_t sourceSize, uchar* destination, std::size_t destinationSize,
+                          std::size_t chunkSize, const std::vector<std::size_t>& compressedChunkSizes, int threads) {
+    const std::size_t nrOfChunks = compressedChunkSizes.size();
+    if(chunkSize == 0 || nrOfChunks != (destinationSize + chunkSize - 1) / chunkSize)
+        throw Exception("Chunk sizes in metaimage file do not match size of image");
+    // Offsets of each compressed chunk, after the 2 byte zlib header
+    std::vector<std::size_t> offsets(nrOfChunks);
+    std::size_t offset = 2;
+    for(std::size_t i = 0; i < nrOfChunks; ++i) {
+        offsets[i] = offset;
+        offset += compressedChunkSizes[i];
+    }
+    if(offset + 4 > sourceSize) // 4 byte adler32 checksum at the end
+        throw Exception("Compressed raw file is smaller than expected");
+
+    std::vector<uLong> checksums(nrOfChunks);
+    ThreadPool pool(std::min<int>(threads <= 0 ? std::thread::hardware_concurrency() : threads, nrOfChunks));
+    std::vector<std::future<void>> futures;
+    for(std::size_t i = 0; i < nrOfChunks; ++i) {
+        futures.push_back(pool.submit([&, i]() {
+            const std::size_t size = std::min(chunkSize, destinationSize - i*chunkSize);
+            uchar* output = destination + i*chunkSize;
+            inflateChunk(source + offsets[i], compressedChunkSizes[i], output, size);
+            checksums[i] = adler32(adler32(0L, Z_NULL, 0), output, (uInt)size);
+        }));
+    }
+    pool.waitForAll();
+    for(auto& future : futures)
+        future.get(); // Rethrows any exceptions
+
+    uLong checksum = adler32(0L, Z_NULL, 0);
+    for(std::size_t i = 0; i < nrOfChunks; ++i)
+        checksum = adler32_combine(checksum, checksums[i], (z_off_t)std::min(chunkSize, destinationSize - i*chunkSize));
+    const uchar* trailer = source + offset;
+    const uLong expectedChecksum = ((uLong)trailer[0] << 24) | ((uLong)trailer[1] << 16) | ((uLong)trailer[2] << 8) | (uLong)trailer[3];
+    if(checksum != expectedChecksum)
+        throw Exception("Checksum mismatch while decompressing raw file");
+}
 
-        case Z_BUF_ERROR:
-            throw Exception("Output buffer was not large enough while decompressing raw file");
-            break;
+static unique_pixel_ptr readRawData(std::string rawFilename, std::size_t voxels, unsigned int nrOfComponents, DataType type,
+                                    bool compressed, std::size_t compressedDataSize, std::size_t chunkSize,
+                                    const std::vector<std::size_t>& compressedChunkSizes, bool memoryMapping, int threads) {
+    const std::size_t expectedSize = voxels*getSizeOfDataType(type, nrOfComponents);
+    if(compressed) {
+        // Map compressed data instead of reading it, to avoid having both compressed and decompressed data in memory
+        std::size_t size;
+        auto fileData = memoryMapFile(rawFilename, false, size);
+        auto data = allocatePixelArray(voxels*nrOfComponents, type);
+        if(!compressedChunkSizes.empty()) {
+            inflateChunks((const uchar*)fileData.get(), size, (uchar*)data.get(), expectedSize, chunkSize, compressedChunkSizes, threads);
+        } else {
+            if(compressedDataSize == 0 || compressedDataSize > size)
+                compressedDataSize = size;
+            uLongf uncompressedSize = expectedSize;
+            int z_result = uncompress(
+                (Bytef*)data.get(),       // destination for the uncompressed
+                                        // data.  This should be the size of
+                                        // the original data, which you should
+                                        // already know.
+
+                &uncompressedSize,  // length of destination (uncompressed)
+                                        // buffer
+
+                (const Bytef*)fileData.get(),   // source buffer - the compressed data
+
+                (uLong)compressedDataSize);   // length of compressed data in bytes
+            switch( z_result )
+            {
+            case Z_OK:
+                break;
+
+            case Z_MEM_ERROR:
+                throw Exception("Out of memory while decompressing raw file");
+                break;
+
+            case Z_BUF_ERROR:
+                throw Exception("Output buffer was not large enough while decompressing raw file");
+                break;
+
+            default:
+                throw Exception("Error while decompressing raw file " + rawFilename);
+            }
         }
-        file.close();
+        return data;
+    } else if(memoryMapping) {
+        std::size_t size;
+        auto data = memoryMapFile(rawFilename, true, size);
+        if(size != expectedSize)
+            throw Exception("Unexpected file size when opening " + rawFilename + " expected: " + std::to_string(expectedSize) + " got: " + std::to_string(size));
+        return data;
     } else {
         std::ifstream file(rawFilename, std::ifstream::binary | std::ifstream::in);
         if(!file.is_open())
@@ -91,14 +238,14 @@ static std::unique_ptr<T[]> readRawData(std::string rawFilename, std::size_t vox
         file.seekg(0, std::ios_base::end);
         std::size_t size = file.tellg();
         file.seekg(0, std::ios_base::beg);
-        std::size_t expectedSize = voxels*nrOfComponents*sizeof(T);
         if(size != expectedSize)
             throw Exception("Unexpected file system when opening" + rawFilename + " expected: " + std::to_string(expectedSize) + " got: " + std::to_string(size));
 
+        auto data = allocatePixelArray(voxels*nrOfComponents, type);
         file.read((char*)data.get(), size);
         file.close();
+        return data;
     }
-    return data;
 }
 
 void MetaImageImporter::execute() {
@@ -146,6 +293,8 @@ void MetaImageImporter::execute() {
     Matrix3f transformMatrix = Matrix3f::Identity();
     bool isCompressed = false;
     std::size_t compressedDataSize = 0;
+    std::size_t compressedDataChunkSize = 0;
+    std::vector<std::size_t> compressedDataChunkSizes;
     std::map<std::string, std::string> metadata;
 
     // Blacklist of keys to avoid importing as metadata
@@ -190,7 +339,14 @@ void MetaImageImporter::execute() {
         } else if(key == "CompressedData" && value == "True") {
             isCompressed = true;
         } else if(key == "CompressedDataSize") {
-            compressedDataSize = std::stoi(value);
+            compressedDataSize = std::stoull(value);
+        } else if(key == "CompressedDataChunkSize") {
+            compressedDataChunkSize = std::stoull(value);
+        } else if(key == "CompressedDataChunkSizes") {
+            std::vector<std::string> values = split(value);
+            values.erase(std::remove(values.begin(), values.end(), ""), values.end());
+            for(auto&& chunk : values)
+                compressedDataChunkSizes.push_back(std::stoull(chunk));
         } else if(key == "ElementDataFile") {
             rawFilename = value;
             rawFilenameFound = true;
@@ -354,31 +510,34 @@ void MetaImageImporter::execute() {
         throw Exception("Error reading the mhd file", __LINE__, __FILE__);
 
 
-    Image::pointer output;
-    std::size_t voxels = size.x()*size.y();
-    if(size.size() == 3)
-        voxels *= size.z();
+    DataType type;
     if(typeName == "MET_INT") {
-        auto data = readRawData<int32_t>(rawFilename, voxels, nrOfComponents, isCompressed, compressedDataSize);
-        output = Image::create(size,TYPE_INT32,nrOfComponents,getMainDevice(),std::move(data));
+        type = TYPE_INT32;
     } else if(typeName == "MET_UINT") {
-        auto data = readRawData<uint32_t>(rawFilename, voxels, nrOfComponents, isCompressed, compressedDataSize);
-        output = Image::create(size,TYPE_UINT32,nrOfComponents,getMainDevice(),std::move(data));
+        type = TYPE_UINT32;
     } else if(typeName == "MET_SHORT") {
-        auto data = readRawData<short>(rawFilename, voxels, nrOfComponents, isCompressed, compressedDataSize);
-        output = Image::create(size,TYPE_INT16,nrOfComponents,getMainDevice(),std::move(data));
+        type = TYPE_INT16;
     } else if(typeName == "MET_USHORT") {
-        auto data = readRawData<ushort>(rawFilename, voxels, nrOfComponents, isCompressed, compressedDataSize);
-        output = Image::create(size,TYPE_UINT16,nrOfComponents,getMainDevice(),std::move(data));
+        type = TYPE_UINT16;
     } else if(typeName == "MET_CHAR") {
-        auto data = readRawData<char>(rawFilename, voxels, nrOfComponents, isCompressed, compressedDataSize);
-        output = Image::create(size,TYPE_INT8,nrOfComponents,getMainDevice(),std::move(data));
+        type = TYPE_INT8;
     } else if(typeName == "MET_UCHAR") {
-        auto data = readRawData<unsigned char>(rawFilename, voxels, nrOfComponents, isCompressed, compressedDataSize);
-        output = Image::create(size,TYPE_UINT8,nrOfComponents,getMainDevice(),std::move(data));
+        type = TYPE_UINT8;
     } else if(typeName == "MET_FLOAT") {
-        auto data = readRawData<float>(rawFilename, voxels, nrOfComponents, isCompressed, compressedDataSize);
-        output = Image::create(size,TYPE_FLOAT,nrOfComponents,getMainDevice(),std::move(data));
+        type = TYPE_FLOAT;
+    }
+
+    std::size_t voxels = size.x()*size.y();
+    if(size.size() == 3)
+        voxels *= size.z();
+    const bool memoryMapping = m_memoryMapping && getMainDevice()->isHost();
+    auto data = readRawData(rawFilename, voxels, nrOfComponents, type, isCompressed, compressedDataSize,
+                            compressedDataChunkSize, compressedDataChunkSizes, memoryMapping, m_threads);
+    Image::pointer output;
+    if(getMainDevice()->isHost()) {
+        output = Image::create(size, type, nrOfComponents, std::move(data));
+    } else {
+        output = Image::create(size, type, nrOfComponents, getMainDevice(), data.get());
     }
 
     output->setSpacing(spacing);
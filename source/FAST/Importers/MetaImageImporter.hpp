@@ -10,6 +10,8 @@ namespace fast {
  * This importer loads 2D and 3D images stored in the MetaImage format which are pairs of .mhd text files and .raw files
  * contain the raw pixel data.
  * It supports the compressed .zraw format as well using zlib.
+ * Compressed files written in chunks by the MetaImageExporter are decompressed in parallel.
+ * Uncompressed files can be memory mapped, see setMemoryMapping.
  * It also loads all meta data stored in the .mhd text file which can be retrived by Image::getMetaData
  *
  * @ingroup importers
@@ -17,10 +19,35 @@ namespace fast {
 class FAST_EXPORT  MetaImageImporter : public FileImporter {
     FAST_PROCESS_OBJECT(MetaImageImporter)
     public:
-        FAST_CONSTRUCTOR(MetaImageImporter, std::string, filename,)
+        FAST_CONSTRUCTOR(MetaImageImporter,
+                         std::string, filename,,
+                         bool, memoryMapping, = false
+        )
+        /**
+         * @brief Memory map uncompressed raw files instead of reading them
+         *
+         * The mapping is used directly as the host data of the output image, thus no copy is made,
+         * and pages are loaded from disk when they are accessed.
+         * The mapping is private: changes to the image are never written back to the file.
+         * Has no effect for compressed files, or if main device is not the host.
+         *
+         * @param memoryMapping
+         */
+        void setMemoryMapping(bool memoryMapping);
+        bool getMemoryMapping() const;
+        /**
+         * @brief Set number of threads used to decompress chunked .zraw files
+         * @param threads Number of threads. If 0, the number of hardware threads is used. Default is 0.
+         */
+        void setNumberOfThreads(int threads);
+        int getNumberOfThreads() const;
+        void loadAttributes() override;
     private:
         MetaImageImporter();
         void execute();
+
+        bool m_memoryMapping = false;
+        int m_threads = 0;
 };
 
 } // end namespace fast
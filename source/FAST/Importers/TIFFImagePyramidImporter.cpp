@@ -131,6 +131,8 @@ void TIFFImagePyramidImporter::execute() {
         }
     }
     auto image = ImagePyramid::create(tiff, levelList, (int)channels, isOMETiff);
+    // Imported pyramids are typically read by several consumers, such as renderers and patch generators
+    image->setTileCacheSize(64*1024*1024);
     if(magnification > 0)
         image->setMagnification(magnification);
     addOutputData(0, image);
@@ -43,3 +43,18 @@ TEST_CASE("Dicom image read 3D", "[DICOM][visual]") {
     CHECK_NOTHROW(window->start());
 
 }
+
+TEST_CASE("Dicom series read in parallel gives same volume as single threaded", "[DICOM][DICOMFileImporter]") {
+    std::vector<Image::pointer> volumes;
+    for(int threads : {1, 4}) {
+        auto importer = DICOMFileImporter::create(Config::getTestDataPath() + "/CT/LIDC-IDRI-0072/000001.dcm", true);
+        importer->setNumberOfThreads(threads);
+        volumes.push_back(importer->runAndGetOutputData<Image>());
+    }
+    REQUIRE(volumes[0]->getDepth() > 1);
+    REQUIRE(volumes[0]->getSize() == volumes[1]->getSize());
+    REQUIRE(volumes[0]->getDataType() == volumes[1]->getDataType());
+    auto access0 = volumes[0]->getImageAccess(ACCESS_READ);
+    auto access1 = volumes[1]->getImageAccess(ACCESS_READ);
+    CHECK(std::memcmp(access0->get(), access1->get(), volumes[0]->getNrOfVoxels()*getSizeOfDataType(volumes[0]->getDataType(), 1)) == 0);
+}
@@ -2,6 +2,7 @@
 #include "FAST/Importers/MetaImageImporter.hpp"
 #include "FAST/DeviceManager.hpp"
 #include "FAST/Data/Image.hpp"
+#include <cstring>
 
 using namespace fast;
 
@@ -80,6 +81,33 @@ TEST_CASE("Import 3D MetaImage file to host", "[fast][MetaImageImporter]") {
     CHECK(image->getDataType() == TYPE_UINT8);
 }
 
+TEST_CASE("Import 3D MetaImage file with memory mapping", "[fast][MetaImageImporter]") {
+    auto importer = MetaImageImporter::create(Config::getTestDataPath()+"US/Ball/US-3Dt_0.mhd");
+    auto image = importer->runAndGetOutputData<Image>();
+    auto mappedImporter = MetaImageImporter::create(Config::getTestDataPath()+"US/Ball/US-3Dt_0.mhd", true);
+    CHECK(mappedImporter->getMemoryMapping());
+    auto mappedImage = mappedImporter->runAndGetOutputData<Image>();
+
+    CHECK(mappedImage->getWidth() == 276);
+    CHECK(mappedImage->getHeight() == 249);
+    CHECK(mappedImage->getDepth() == 200);
+    CHECK(mappedImage->getDataType() == TYPE_UINT8);
+    {
+        auto access = image->getImageAccess(ACCESS_READ);
+        auto mappedAccess = mappedImage->getImageAccess(ACCESS_READ);
+        CHECK(std::memcmp(access->get(), mappedAccess->get(), 276*249*200) == 0);
+    }
+    {
+        // Changes to the image must not be written to the file
+        auto mappedAccess = mappedImage->getImageAccess(ACCESS_READ_WRITE);
+        std::memset(mappedAccess->get(), 0, 276*249*200);
+    }
+    auto image2 = MetaImageImporter::create(Config::getTestDataPath()+"US/Ball/US-3Dt_0.mhd", true)->runAndGetOutputData<Image>();
+    auto access = image->getImageAccess(ACCESS_READ);
+    auto access2 = image2->getImageAccess(ACCESS_READ);
+    CHECK(std::memcmp(access->get(), access2->get(), 276*249*200) == 0);
+}
+
 TEST_CASE("Import MetaImage file to OpenCL device", "[fast][MetaImageImporter]") {
     DeviceManager* deviceManager = DeviceManager::getInstance();
     OpenCLDevice::pointer device = deviceManager->getOneOpenCLDevice();
@@ -71,6 +71,8 @@ void WholeSlideImageImporter::readWithOpenSlide(std::string filename) {
     }
     auto image = ImagePyramid::create(file, levelList);
     image->setMetadata(metadata);
+    // Imported pyramids are typically read by several consumers, such as renderers and patch generators
+    image->setTileCacheSize(64*1024*1024);
 
     try {
         // Try to get spacing in microns from openslide, and convert to millimeters.
@@ -0,0 +1,158 @@
+#include "KDTree.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace fast {
+
+KDTree::KDTree(int leafSize) {
+    if(leafSize < 1)
+        throw Exception("Leaf size of KDTree must be >= 1");
+    m_leafSize = leafSize;
+}
+
+KDTree::KDTree(const MatrixXf& points, int leafSize) : KDTree(leafSize) {
+    build(points);
+}
+
+void KDTree::build(const MatrixXf& points) {
+    m_nodes.clear();
+    m_indices.resize(points.cols());
+    for(int i = 0; i < points.cols(); ++i)
+        m_indices[i] = i;
+    m_points = points;
+    if(points.cols() == 0)
+        return;
+    m_nodes.reserve(2 * points.cols() / m_leafSize + 1);
+    buildNode(0, points.cols());
+    // Store points in tree order, so that the points of a leaf are next to each other in memory
+    for(int i = 0; i < points.cols(); ++i)
+        m_points.col(i) = points.col(m_indices[i]);
+}
+
+int KDTree::buildNode(int start, int end) {
+    const int nodeIndex = m_nodes.size();
+    m_nodes.push_back({start, end, -1, 0.0f, -1, -1});
+    if(end - start <= m_leafSize)
+        return nodeIndex;
+
+    // Split along the dimension with the largest extent
+    VectorXf min = VectorXf::Constant(m_points.rows(), std::numeric_limits<float>::max());
+    VectorXf max = VectorXf::Constant(m_points.rows(), std::numeric_limits<float>::lowest());
+    for(int i = start; i < end; ++i) {
+        min = min.cwiseMin(m_points.col(m_indices[i]));
+        max = max.cwiseMax(m_points.col(m_indices[i]));
+    }
+    int dimension;
+    if((max - min).maxCoeff(&dimension) <= 0.0f) // All points are equal
+        return nodeIndex;
+
+    // Split at the median
+    const int middle = start + (end - start) / 2;
+    std::nth_element(m_indices.begin() + start, m_indices.begin() + middle, m_indices.begin() + end, [this, dimension](int a, int b) {
+        return m_points(dimension, a) < m_points(dimension, b);
+    });
+    const float splitValue = m_points(dimension, m_indices[middle]);
+    const int left = buildNode(start, middle);
+    const int right = buildNode(middle, end);
+    Node& node = m_nodes[nodeIndex]; // m_nodes may have been reallocated by the recursion
+    node.splitDimension = dimension;
+    node.splitValue = splitValue;
+    node.left = left;
+    node.right = right;
+    return nodeIndex;
+}
+
+int KDTree::getNrOfPoints() const {
+    return m_points.cols();
+}
+
+int KDTree::getNrOfDimensions() const {
+    return m_points.rows();
+}
+
+void KDTree::findNearest(int nodeIndex, const float* point, int& nearest, float& nearestSquaredDistance) const {
+    const Node& node = m_nodes[nodeIndex];
+    if(node.splitDimension < 0) {
+        const int dimensions = m_points.rows();
+        for(int i = node.start; i < node.end; ++i) {
+            const float* candidate = m_points.data() + (std::size_t)i*dimensions;
+            float squaredDistance = 0.0f;
+            for(int d = 0; d < dimensions; ++d)
+                squaredDistance += (candidate[d] - point[d])*(candidate[d] - point[d]);
+            if(squaredDistance < nearestSquaredDistance) {
+                nearestSquaredDistance = squaredDistance;
+                nearest = i;
+            }
+        }
+        return;
+    }
+    // Visit the side of the split containing the point first, and the other side only if it can contain a closer point
+    const float difference = point[node.splitDimension] - node.splitValue;
+    const int first = difference < 0.0f ? node.left : node.right;
+    const int second = difference < 0.0f ? node.right : node.left;
+    findNearest(first, point, nearest, nearestSquaredDistance);
+    if(difference*difference < nearestSquaredDistance)
+        findNearest(second, point, nearest, nearestSquaredDistance);
+}
+
+int KDTree::findNearest(const VectorXf& point, float* squaredDistance) const {
+    if(point.size() != m_points.rows())
+        throw Exception("Query point dimension does not match KDTree dimension");
+    if(m_nodes.empty())
+        return -1;
+    int nearest = -1;
+    float nearestSquaredDistance = std::numeric_limits<float>::max();
+    findNearest(0, point.data(), nearest, nearestSquaredDistance);
+    if(squaredDistance != nullptr)
+        *squaredDistance = nearestSquaredDistance;
+    return m_indices[nearest];
+}
+
+std::vector<int> KDTree::findNearest(const MatrixXf& points, std::vector<float>* squaredDistances) const {
+    if(points.cols() > 0 && points.rows() != m_points.rows())
+        throw Exception("Query point dimension does not match KDTree dimension");
+    std::vector<int> result(points.cols(), -1);
+    if(squaredDistances != nullptr)
+        squaredDistances->assign(points.cols(), std::numeric_limits<float>::max());
+    if(m_nodes.empty())
+        return result;
+#pragma omp parallel for
+    for(int i = 0; i < points.cols(); ++i) {
+        int nearest = -1;
+        float nearestSquaredDistance = std::numeric_limits<float>::max();
+        findNearest(0, points.data() + (std::size_t)i*points.rows(), nearest, nearestSquaredDistance);
+        result[i] = m_indices[nearest];
+        if(squaredDistances != nullptr)
+            (*squaredDistances)[i] = nearestSquaredDistance;
+    }
+    return result;
+}
+
+std::vector<int> KDTree::findWithinRadius(const VectorXf& point, float radius) const {
+    if(point.size() != m_points.rows())
+        throw Exception("Query point dimension does not match KDTree dimension");
+    std::vector<int> result;
+    if(m_nodes.empty())
+        return result;
+    const float squaredRadius = radius*radius;
+    std::vector<int> stack = {0};
+    while(!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if(node.splitDimension < 0) {
+            for(int i = node.start; i < node.end; ++i) {
+                if((m_points.col(i) - point).squaredNorm() <= squaredRadius)
+                    result.push_back(m_indices[i]);
+            }
+            continue;
+        }
+        const float difference = point(node.splitDimension) - node.splitValue;
+        if(difference <= radius)
+            stack.push_back(node.left);
+        if(difference >= -radius)
+            stack.push_back(node.right);
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <FAST/Data/DataTypes.hpp>
+#include <vector>
+
+namespace fast {
+
+/**
+ * @brief A k-d tree for nearest neighbour and radius search among a fixed set of points
+ *
+ * The tree is built once over a set of points of any dimension, and can then be queried from several threads at once.
+ * Used for instance by IterativeClosestPoint and CoherentPointDrift to find corresponding points.
+ */
+class FAST_EXPORT KDTree {
+    public:
+        /**
+         * @brief Create empty tree
+         * @param leafSize Maximum number of points in each leaf node
+         */
+        explicit KDTree(int leafSize = 16);
+        /**
+         * @brief Create tree
+         * @param points Matrix with one point per column
+         * @param leafSize Maximum number of points in each leaf node
+         */
+        explicit KDTree(const MatrixXf& points, int leafSize = 16);
+        /**
+         * @brief Build tree, replacing any existing points
+         * @param points Matrix with one point per column
+         */
+        void build(const MatrixXf& points);
+        int getNrOfPoints() const;
+        int getNrOfDimensions() const;
+        /**
+         * @brief Find nearest point
+         * @param point Query point, must have the same dimension as the points in the tree
+         * @param squaredDistance If not null, set to squared distance to nearest point
+         * @return index (column) of nearest point, or -1 if tree is empty
+         */
+        int findNearest(const VectorXf& point, float* squaredDistance = nullptr) const;
+        /**
+         * @brief Find nearest point for each column in a matrix. The queries are done in parallel.
+         * @param points Matrix with one query point per column
+         * @param squaredDistances If not null, filled with the squared distance to the nearest point of each query point
+         * @return index (column) of nearest point for each query point
+         */
+        std::vector<int> findNearest(const MatrixXf& points, std::vector<float>* squaredDistances = nullptr) const;
+        /**
+         * @brief Find all points within a given distance of a point
+         * @param point Query point
+         * @param radius Maximum distance
+         * @return indices (columns) of all points within the radius, in no particular order
+         */
+        std::vector<int> findWithinRadius(const VectorXf& point, float radius) const;
+    private:
+        struct Node {
+            int start; // Range of points in m_points
+            int end;
+            int splitDimension; // -1 for leaf nodes
+            float splitValue;
+            int left; // Child node indices
+            int right;
+        };
+        int buildNode(int start, int end);
+        void findNearest(int node, const float* point, int& nearest, float& nearestSquaredDistance) const;
+
+        int m_leafSize;
+        MatrixXf m_points; // Points reordered so that each node covers a contiguous range of columns
+        std::vector<int> m_indices; // Original index of each column in m_points
+        std::vector<Node> m_nodes;
+};
+
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace fast {
+
+/**
+ * @brief A thread-safe, size bounded, least recently used (LRU) cache
+ *
+ * Each entry is stored with a size in bytes. When the total size of all entries exceeds
+ * the maximum size, the least recently used entries are evicted.
+ * The cache keeps track of the number of hits and misses.
+ *
+ * @tparam Key Key type, must be hashable with std::hash
+ * @tparam Value Value type. Should be cheap to copy, e.g. a shared_ptr.
+ */
+template <class Key, class Value>
+class LRUCache {
+    public:
+        /**
+         * @brief Create cache
+         * @param maxSize Maximum total size in bytes of all entries. If 0, nothing is cached.
+         */
+        explicit LRUCache(std::size_t maxSize = 0) : m_maxSize(maxSize) {};
+        /**
+         * @brief Get a value from the cache, and mark it as most recently used
+         * @param key
+         * @param value Set to the cached value if it exists
+         * @return true if key was in the cache
+         */
+        bool get(const Key& key, Value& value);
+        /**
+         * @brief Add, or replace, an entry in the cache
+         * @param key
+         * @param value
+         * @param size Size of the entry in bytes
+         */
+        void put(const Key& key, Value value, std::size_t size);
+        /**
+         * @brief Remove an entry from the cache if it exists
+         * @param key
+         */
+        void remove(const Key& key);
+        /**
+         * @brief Remove all entries from the cache
+         */
+        void clear();
+        /**
+         * @brief Set maximum total size of the cache. Entries are evicted if the current size is larger.
+         * @param maxSize Maximum size in bytes. If 0, nothing is cached.
+         */
+        void setMaxSize(std::size_t maxSize);
+        std::size_t getMaxSize() const;
+        /**
+         * @brief Get current total size of all entries in bytes
+         */
+        std::size_t getSize() const;
+        uint64_t getHits() const;
+        uint64_t getMisses() const;
+    private:
+        struct Entry {
+            Key key;
+            Value value;
+            std::size_t size;
+        };
+        void evict();
+
+        std::list<Entry> m_entries; // Most recently used first
+        std::unordered_map<Key, typename std::list<Entry>::iterator> m_lookup;
+        std::size_t m_maxSize;
+        std::size_t m_size = 0;
+        std::atomic<uint64_t> m_hits{0};
+        std::atomic<uint64_t> m_misses{0};
+        mutable std::mutex m_mutex;
+};
+
+template <class Key, class Value>
+bool LRUCache<Key, Value>::get(const Key& key, Value& value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_lookup.find(key);
+    if(it == m_lookup.end()) {
+        ++m_misses;
+        return false;
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    value = it->second->value;
+    ++m_hits;
+    return true;
+}
+
+template <class Key, class Value>
+void LRUCache<Key, Value>::put(const Key& key, Value value, std::size_t size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Remove any existing entry first, so that an old value is never returned, even if the new value is not cached
+    auto it = m_lookup.find(key);
+    if(it != m_lookup.end()) {
+        m_size -= it->second->size;
+        m_entries.erase(it->second);
+        m_lookup.erase(it);
+    }
+    if(size > m_maxSize)
+        return;
+    m_entries.push_front({key, std::move(value), size});
+    m_lookup[key] = m_entries.begin();
+    m_size += size;
+    evict();
+}
+
+template <class Key, class Value>
+void LRUCache<Key, Value>::remove(const Key& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_lookup.find(key);
+    if(it == m_lookup.end())
+        return;
+    m_size -= it->second->size;
+    m_entries.erase(it->second);
+    m_lookup.erase(it);
+}
+
+template <class Key, class Value>
+void LRUCache<Key, Value>::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_lookup.clear();
+    m_size = 0;
+}
+
+template <class Key, class Value>
+void LRUCache<Key, Value>::setMaxSize(std::size_t maxSize) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxSize = maxSize;
+    evict();
+}
+
+template <class Key, class Value>
+std::size_t LRUCache<Key, Value>::getMaxSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxSize;
+}
+
+template <class Key, class Value>
+std::size_t LRUCache<Key, Value>::getSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+template <class Key, class Value>
+uint64_t LRUCache<Key, Value>::getHits() const {
+    return m_hits;
+}
+
+template <class Key, class Value>
+uint64_t LRUCache<Key, Value>::getMisses() const {
+    return m_misses;
+}
+
+template <class Key, class Value>
+void LRUCache<Key, Value>::evict() {
+    // Assumes mutex is locked
+    while(m_size > m_maxSize && !m_entries.empty()) {
+        auto& last = m_entries.back();
+        m_size -= last.size;
+        m_lookup.erase(last.key);
+        m_entries.pop_back();
+    }
+}
+
+}
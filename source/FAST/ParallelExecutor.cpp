@@ -0,0 +1,109 @@
+#include "ParallelExecutor.hpp"
+#include <FAST/ProcessObject.hpp>
+#include <algorithm>
+#include <unordered_map>
+
+namespace fast {
+
+ParallelExecutor::ParallelExecutor(int threads) : m_pool(threads) {
+}
+
+int ParallelExecutor::getNumberOfThreads() const {
+    return m_pool.getNumberOfThreads();
+}
+
+void ParallelExecutor::update(std::shared_ptr<ProcessObject> processObject, int executeToken) {
+    update(std::vector<std::shared_ptr<ProcessObject>>{std::move(processObject)}, executeToken);
+}
+
+namespace {
+struct Node {
+    std::shared_ptr<ProcessObject> processObject;
+    std::vector<Node*> children;
+    int remainingParents = 0;
+};
+}
+
+void ParallelExecutor::update(const std::vector<std::shared_ptr<ProcessObject>>& processObjects, int executeToken) {
+    // Build DAG of all process objects upstream of the sinks
+    std::unordered_map<ProcessObject*, std::unique_ptr<Node>> nodes;
+    std::vector<ProcessObject*> stack;
+    for(auto&& po : processObjects) {
+        if(nodes.count(po.get()) > 0)
+            continue;
+        auto node = std::make_unique<Node>();
+        node->processObject = po;
+        nodes[po.get()] = std::move(node);
+        stack.push_back(po.get());
+    }
+    while(!stack.empty()) {
+        ProcessObject* po = stack.back();
+        stack.pop_back();
+        Node* node = nodes[po].get();
+        std::vector<ProcessObject*> parents;
+        for(auto&& connection : po->mInputConnections) {
+            auto parent = connection.second->getProcessObject();
+            // Multiple input connections to the same parent only counts once
+            if(std::find(parents.begin(), parents.end(), parent.get()) != parents.end())
+                continue;
+            parents.push_back(parent.get());
+            if(nodes.count(parent.get()) == 0) {
+                auto parentNode = std::make_unique<Node>();
+                parentNode->processObject = parent;
+                nodes[parent.get()] = std::move(parentNode);
+                stack.push_back(parent.get());
+            }
+            nodes[parent.get()]->children.push_back(node);
+            node->remainingParents++;
+        }
+    }
+
+    // Execute nodes when all their parents are finished
+    std::mutex mutex;
+    std::condition_variable finishedCondition;
+    int remainingNodes = nodes.size();
+    int runningNodes = 0;
+    std::exception_ptr exception;
+    std::function<void(Node*)> submit = [&](Node* node) {
+        // Assumes mutex is locked
+        ++runningNodes;
+        m_pool.submit([&, node]() {
+            std::exception_ptr nodeException;
+            try {
+                node->processObject->update(executeToken, false);
+            } catch(...) {
+                nodeException = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --runningNodes;
+                --remainingNodes;
+                if(nodeException && !exception)
+                    exception = nodeException;
+                if(!exception) {
+                    for(Node* child : node->children) {
+                        child->remainingParents--;
+                        if(child->remainingParents == 0)
+                            submit(child);
+                    }
+                }
+                // Notify while locked, since the condition variable is destroyed when update returns
+                finishedCondition.notify_all();
+            }
+        });
+    };
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for(auto&& item : nodes) {
+            if(item.second->remainingParents == 0)
+                submit(item.second.get());
+        }
+        finishedCondition.wait(lock, [&]() {
+            return runningNodes == 0 && (remainingNodes == 0 || exception);
+        });
+    }
+    if(exception)
+        std::rethrow_exception(exception);
+}
+
+}
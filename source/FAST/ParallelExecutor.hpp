@@ -0,0 +1,53 @@
+#pragma once
+
+#include "FASTExport.hpp"
+#include <FAST/ThreadPool.hpp>
+#include <memory>
+#include <vector>
+
+namespace fast {
+
+class ProcessObject;
+
+/**
+ * @brief Updates a pipeline by executing independent process objects in parallel
+ *
+ * ProcessObject::update traverses and executes all parents recursively in the calling thread.
+ * Instead, this executor builds the directed acyclic graph (DAG) of all process objects upstream of a set
+ * of sink process objects, and executes each process object on a thread pool as soon as all of its parents
+ * have finished. Thus, independent branches of a pipeline run concurrently.
+ * Each process object is updated at most once per call, and execute tokens are respected as in ProcessObject::update.
+ *
+ * Note that process objects in different branches may be executed at the same time, thus they should not share
+ * non thread safe state.
+ *
+ * @sa ComputationThread::setParallelExecutor Pipeline::setParallelExecutor
+ */
+class FAST_EXPORT ParallelExecutor {
+    public:
+        /**
+         * @brief Create parallel executor
+         * @param threads Number of worker threads. If <= 0, the number of hardware threads is used.
+         */
+        explicit ParallelExecutor(int threads = 0);
+        /**
+         * @brief Update the pipeline up to and including the given process objects.
+         * Blocks until all process objects are done. If any process object throws, no more process objects are
+         * started, and the first exception is rethrown when all running process objects are done.
+         *
+         * @param processObjects Sink process objects
+         * @param executeToken Negative value means that the execute token is disabled.
+         */
+        void update(const std::vector<std::shared_ptr<ProcessObject>>& processObjects, int executeToken = -1);
+        /**
+         * @brief Update the pipeline up to and including the given process object.
+         * @param processObject Sink process object
+         * @param executeToken Negative value means that the execute token is disabled.
+         */
+        void update(std::shared_ptr<ProcessObject> processObject, int executeToken = -1);
+        int getNumberOfThreads() const;
+    private:
+        ThreadPool m_pool;
+};
+
+}
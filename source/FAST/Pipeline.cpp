@@ -1,6 +1,7 @@
 #include "Pipeline.hpp"
 #include "FAST/Config.hpp"
 #include "ProcessObject.hpp"
+#include "ParallelExecutor.hpp"
 #include <QDirIterator>
 #include <fstream>
 #include <QLabel>
@@ -505,15 +506,25 @@ DataObject::pointer Pipeline::getPipelineOutputData(std::string name, std::funct
     if(m_pipelineOutputData.count(name) == 0)
         throw Exception("Pipeline output data " + name + " not found.");
 
-    auto [POname, port] = m_pipelineOutputData[name];
+    auto [POname, portID] = m_pipelineOutputData[name];
     auto PO = getProcessObject(POname);
-    auto data = PO->runAndGetOutputData(port);
+    auto port = PO->getOutputPort(portID);
+    auto update = [&]() {
+        const int64_t executeToken = ++m_executeToken;
+        if(m_executor) {
+            m_executor->update(PO, executeToken);
+        } else {
+            PO->run(executeToken);
+        }
+        return port->getNextFrame();
+    };
+    auto data = update();
 
     // Check if data is "in progress"
     if(data->hasFrameData("progress")) {
         do {
             // If so, we update until it is marked as finished
-            data = PO->runAndGetOutputData(port);
+            data = update();
             if(progressFunction != nullptr) {
                 // Report progress
                 progressFunction(std::stof(data->getFrameData("progress")));
@@ -531,16 +542,36 @@ std::map<std::string, DataObject::pointer> Pipeline::getAllPipelineOutputData(st
         return {};
 
     std::map<std::string, DataObject::pointer> result;
-    int64_t executeToken = 0;
+    int64_t executeToken = ++m_executeToken;
+    std::map<std::string, DataChannel::pointer> ports;
+    if(m_executor) {
+        // Do the first update of all output process objects in parallel
+        std::vector<std::shared_ptr<ProcessObject>> POs;
+        for(auto [name, output] : m_pipelineOutputData) {
+            auto PO = getProcessObject(output.first);
+            ports[name] = PO->getOutputPort(output.second);
+            POs.push_back(PO);
+        }
+        m_executor->update(POs, executeToken);
+    }
     for(auto [name, output] : m_pipelineOutputData) {
         auto PO = getProcessObject(output.first);
-        result[name] = PO->runAndGetOutputData(output.second, executeToken);
+        if(ports.count(name) > 0) {
+            result[name] = ports[name]->getNextFrame();
+        } else {
+            result[name] = PO->runAndGetOutputData(output.second, executeToken);
+        }
         // Check if data is marked as "in progress"
         if(result[name]->hasFrameData("progress")) {
             do {
                 // If so, we update until it is marked as finished
-                executeToken++;
-                result[name] = PO->runAndGetOutputData(output.second, executeToken);
+                executeToken = ++m_executeToken;
+                if(m_executor) {
+                    m_executor->update(PO, executeToken);
+                    result[name] = ports[name]->getNextFrame();
+                } else {
+                    result[name] = PO->runAndGetOutputData(output.second, executeToken);
+                }
                 if(progressFunction != nullptr) {
                     // Report progress
                     progressFunction(std::stof(result[name]->getFrameData("progress")));
@@ -584,19 +615,30 @@ std::map<std::string, DataObject::pointer> Pipeline::run(std::map<std::string, s
     if(!isParsed())
         parse(inputData, processObjects, visualization);
 
+    // Exporters share an execute token, thus process objects shared by several exporters are only executed once
+    const int64_t executeToken = ++m_executeToken;
+    std::vector<std::shared_ptr<ProcessObject>> exporters;
     for(auto PO : getProcessObjects()) {
         if(std::dynamic_pointer_cast<Exporter>(PO.second) != nullptr) {
             // PO is an exporter, run it.
             Reporter::info() << "Found exporter " << PO.first << " (" << PO.second->getNameOfClass() << ") in pipeline, running..." << Reporter::end();
-            PO.second->run();
+            if(m_executor) {
+                exporters.push_back(PO.second);
+            } else {
+                PO.second->run(executeToken);
+            }
         }
     }
+    if(!exporters.empty())
+        m_executor->update(exporters, executeToken);
 
     std::map<std::string, std::shared_ptr<DataObject>> data;
     if(!m_views.empty()) {
         auto window = MultiViewWindow::create(0);
         for(auto&& view : getViews())
             window->addView(view);
+        if(m_executor)
+            window->getComputationThread()->setParallelExecutor(m_executor);
         window->run(); // Visualize and block here
         data = getAllPipelineOutputData();
     } else {
@@ -615,6 +657,10 @@ std::shared_ptr<Window> Pipeline::getWindow() {
     return m_window;
 }
 
+void Pipeline::setParallelExecutor(std::shared_ptr<ParallelExecutor> executor) {
+    m_executor = executor;
+}
+
 DataObject::pointer Pipeline::getPipelineOutputData(std::string name) {
     Progress progress(1000);
     progress.setText("Running pipeline");
@@ -13,6 +13,7 @@ namespace fast {
 class Renderer;
 class View;
 class Window;
+class ParallelExecutor;
 
 using StringMap = std::map<std::string, std::string>;
 using DataMap = std::map<std::string, std::shared_ptr<DataObject>>;
@@ -168,6 +169,15 @@ class FAST_EXPORT  Pipeline {
          * @return Window defined in pipeline, null if none was defined.
          */
         std::shared_ptr<Window> getWindow();
+        /**
+         * @brief Use a parallel executor to run independent branches of this pipeline concurrently
+         *
+         * If set, exporters and pipeline output data are updated using the given executor
+         * in run() and getAllPipelineOutputData().
+         *
+         * @param executor Parallel executor, set to nullptr to disable
+         */
+        void setParallelExecutor(std::shared_ptr<ParallelExecutor> executor);
     private:
         bool m_parsed = false;
         std::string mName;
@@ -181,6 +191,8 @@ class FAST_EXPORT  Pipeline {
         std::map<std::string, std::pair<std::string, uint>> m_pipelineOutputData;
         std::map<std::string, std::pair<std::string, std::shared_ptr<DataObject>>> m_pipelineInputData;
         std::shared_ptr<Window> m_window;
+        std::shared_ptr<ParallelExecutor> m_executor;
+        int64_t m_executeToken = 0; // Incremented for every update of the pipeline, thus tokens are never reused
 
         void parseProcessObject(
             std::string objectName,
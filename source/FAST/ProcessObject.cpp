@@ -4,6 +4,7 @@
 #include "FAST/Streamers/Streamer.hpp"
 #include <unordered_set>
 #include <FAST/DataChannels/QueuedDataChannel.hpp>
+#include <FAST/DataChannels/RingBufferDataChannel.hpp>
 #include <FAST/DataChannels/NewestFrameDataChannel.hpp>
 #include <FAST/DataChannels/StaticDataChannel.hpp>
 
@@ -25,12 +26,17 @@ static bool isStreamer(ProcessObject* po) {
 }
 
 void ProcessObject::update(int executeToken) {
-    // Call update on all parents
+    update(executeToken, true);
+}
+
+void ProcessObject::update(int executeToken, bool updateParents) {
+    // Call update on all parents, unless they already have been updated by ParallelExecutor
     bool newInputData = false;
     bool inputMarkedAsLastFrame = false;
     for(auto parent : mInputConnections) {
         auto port = parent.second;
-        port->getProcessObject()->update(executeToken);
+        if(updateParents)
+            port->getProcessObject()->update(executeToken);
 
         if(mLastProcessed.count(parent.first) > 0) {
             // Compare the last processed data with the new data for this data port
@@ -74,8 +80,13 @@ void ProcessObject::update(int executeToken) {
             if(port->hasCurrentData()) {
                 if(port->getFrame()->isLastFrame())
                     inputMarkedAsLastFrame = true;
+                newInputData = true;
+            } else if(isStreamer(port->getProcessObject().get())) {
+                // Streamers add data asynchronously, getInputData will block until it arrives
+                newInputData = true;
             }
-            newInputData = true;
+            // Otherwise the parent has executed without producing any output yet, e.g. a NeuralNetwork filling
+            // its inference pipeline. Executing now would block forever in getInputData.
         }
     }
 
@@ -133,9 +144,14 @@ DataChannel::pointer ProcessObject::getOutputPort(uint portID) {
     // Create DataChannel, and it to list and return it
     DataChannel::pointer dataChannel;
     if(isStreamer(this)) {
-        auto streamingMode = std::dynamic_pointer_cast<Streamer>(mPtr.lock())->getStreamingMode();
+        auto streamer = std::dynamic_pointer_cast<Streamer>(mPtr.lock());
+        auto streamingMode = streamer->getStreamingMode();
         if(streamingMode == StreamingMode::ProcessAllFrames) {
-            dataChannel = QueuedDataChannel::New();
+            if(streamer->isLockFreeOutputPort(portID)) {
+                dataChannel = RingBufferDataChannel::New();
+            } else {
+                dataChannel = QueuedDataChannel::New();
+            }
             if(m_maximumNrOfFrames > 0)
                 dataChannel->setMaximumNumberOfFrames(m_maximumNrOfFrames);
         } else if(streamingMode == StreamingMode::NewestFrameOnly) {
@@ -383,6 +399,15 @@ bool ProcessObject::hasNewInputData(uint portID) {
     return mInputConnections.at(portID)->hasCurrentData();
 }
 
+bool ProcessObject::hasStreamerParent() const {
+    for(auto&& input : mInputConnections) {
+        auto parent = input.second->getProcessObject();
+        if(isStreamer(parent.get()) || parent->hasStreamerParent())
+            return true;
+    }
+    return false;
+}
+
 int ProcessObject::getNrOfOutputPorts() const {
     return mOutputPorts.size();
 }
@@ -19,6 +19,7 @@ namespace fast {
 
 class OpenCLProgram;
 class ProcessObject;
+class ParallelExecutor;
 
 /**
  * @defgroup segmentation Segmentation
@@ -199,6 +200,17 @@ class FAST_EXPORT  ProcessObject : public AttributeObject {
         void addOutputData(uint portID, DataObject::pointer data, bool propagateLastFrameData = true, bool propagateFrameData = true);
 
         bool hasNewInputData(uint portID);
+        /**
+         * @brief Whether any of the process objects upstream of this one is a streamer
+         * @return
+         */
+        bool hasStreamerParent() const;
+        /**
+         * @brief Check for new input data and execute this PO if needed
+         * @param executeToken
+         * @param updateParents If false, parents are assumed to already have been updated with this execute token
+         */
+        void update(int executeToken, bool updateParents);
 
         virtual void waitToFinish() {};
 
@@ -253,6 +265,7 @@ class FAST_EXPORT  ProcessObject : public AttributeObject {
 
         std::mutex m_mutex;
 
+        friend class ParallelExecutor;
 };
 
 template<class DataType>
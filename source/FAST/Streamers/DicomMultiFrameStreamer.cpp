@@ -43,6 +43,7 @@ void DicomMultiFrameStreamer::load() {
     if(!fileExists(m_filename))
         throw FileNotFoundException(m_filename);
 
+    clearFrameCache();
     m_image = std::make_shared<DicomImage>(m_filename.c_str());
     if(m_image->getStatus() != EIS_Normal) {
         throw Exception("Error creating dicom image object");
@@ -120,15 +121,22 @@ void DicomMultiFrameStreamer::generateStream() {
             }
         }
         int frameNr = getCurrentFrameIndex();
-        auto frameData = make_uninitialized_unique<uchar>(3*width*height);
-        m_image->getOutputData(frameData.get(), 3*width*height, 0, frameNr);
-        auto imageFrame = Image::create(width, height, TYPE_UINT8, 3, std::move(frameData));
-        imageFrame->setSpacing(spacing);
-        if(m_convertToGrayscale) {
-            imageFrame = ColorToGrayscale::create()->connect(imageFrame)->runAndGetOutputData<Image>();
-        }
-        if(m_cropToROI && ROIfound) {
-            imageFrame = imageFrame->crop(ROIOffset, ROISize);
+        Image::pointer imageFrame;
+        DataObject::pointer cachedFrame;
+        if(getCachedFrame(frameNr, cachedFrame)) {
+            imageFrame = std::static_pointer_cast<Image>(cachedFrame);
+        } else {
+            auto frameData = make_uninitialized_unique<uchar>(3*width*height);
+            m_image->getOutputData(frameData.get(), 3*width*height, 0, frameNr);
+            imageFrame = Image::create(width, height, TYPE_UINT8, 3, std::move(frameData));
+            imageFrame->setSpacing(spacing);
+            if(m_convertToGrayscale) {
+                imageFrame = ColorToGrayscale::create()->connect(imageFrame)->runAndGetOutputData<Image>();
+            }
+            if(m_cropToROI && ROIfound) {
+                imageFrame = imageFrame->crop(ROIOffset, ROISize);
+            }
+            addCachedFrame(frameNr, imageFrame);
         }
         if(!pause) {
             if(m_framerate > 0) {
@@ -0,0 +1,150 @@
+#include "DicomSeriesStreamer.hpp"
+#include <FAST/Importers/DICOMFileImporter.hpp>
+#include <FAST/Data/Image.hpp>
+#include <FAST/ThreadPool.hpp>
+#include <dcmtk/dcmdata/dcfilefo.h>
+#include <dcmtk/dcmdata/dcdeftag.h>
+
+namespace fast {
+
+DicomSeriesStreamer::DicomSeriesStreamer() {
+    createOutputPort<Image>(0);
+    createStringAttribute("filename", "Filename", "Any DICOM file in the series to load", "");
+    createIntegerAttribute("threads", "Threads", "Number of threads used to decode slices. 0 means use all hardware threads.", m_threads);
+    createIntegerAttribute("updates", "Updates", "Number of times the volume is sent while it is being loaded", m_updates);
+}
+
+DicomSeriesStreamer::DicomSeriesStreamer(std::string filename, int threads, int updates) : DicomSeriesStreamer() {
+    setFilename(filename);
+    setNumberOfThreads(threads);
+    setNumberOfUpdates(updates);
+}
+
+void DicomSeriesStreamer::loadAttributes() {
+    setFilename(getStringAttribute("filename"));
+    setNumberOfThreads(getIntegerAttribute("threads"));
+    setNumberOfUpdates(getIntegerAttribute("updates"));
+}
+
+void DicomSeriesStreamer::setFilename(std::string filename) {
+    m_filename = filename;
+    setModified(true);
+}
+
+void DicomSeriesStreamer::setNumberOfThreads(int threads) {
+    if(threads < 0)
+        throw Exception("Number of threads in DicomSeriesStreamer must be >= 0");
+    m_threads = threads;
+    setModified(true);
+}
+
+void DicomSeriesStreamer::setNumberOfUpdates(int updates) {
+    if(updates < 1)
+        throw Exception("Number of updates in DicomSeriesStreamer must be >= 1");
+    m_updates = updates;
+    setModified(true);
+}
+
+float DicomSeriesStreamer::getProgress() const {
+    return m_progress;
+}
+
+void DicomSeriesStreamer::execute() {
+    if(m_filename.empty())
+        throw Exception("DicomSeriesStreamer needs filename to be set");
+    if(!fileExists(m_filename))
+        throw FileNotFoundException(m_filename);
+
+    startStream();
+    waitForFirstFrame();
+}
+
+void DicomSeriesStreamer::generateStream() {
+    try {
+        m_progress = 0.0f;
+        DcmFileFormat fileformat;
+        OFCondition status = fileformat.loadFile(m_filename.c_str());
+        if(!status.good())
+            throw Exception("Error: cannot read DICOM file " + m_filename + "(" + std::string(status.text()) + ")");
+        Float64 spacingX = 1;
+        Float64 spacingY = 1;
+        Float64 spacingZ = 1;
+        fileformat.getDataset()->findAndGetFloat64(DCM_PixelSpacing, spacingX, 0);
+        fileformat.getDataset()->findAndGetFloat64(DCM_PixelSpacing, spacingY, 1);
+        fileformat.getDataset()->findAndGetFloat64(DCM_SliceThickness, spacingZ);
+
+        ThreadPool pool(m_threads);
+        const std::vector<std::string> seriesFiles = DICOMFileImporter::getSeriesFiles(m_filename, &pool);
+
+        // Decode the first slice to get size and type
+        const int depth = seriesFiles.size();
+        int width, height;
+        const DataType type = DICOMFileImporter::getSliceInfo(m_filename, &width, &height);
+        const std::size_t sliceBytes = (std::size_t)width*height*getSizeOfDataType(type, 1);
+        const std::size_t volumeBytes = sliceBytes*depth;
+        VectorXui size(3);
+        size << width, height, depth;
+
+        auto volume = allocatePixelArray((std::size_t)width*height*depth, type);
+        std::memset(volume.get(), 0, volumeBytes);
+
+        // Decode slices in parallel into separate buffers. Each slice is copied into the volume as soon as it is done,
+        // in order, so that the volume is never accessed by more than one thread.
+        std::vector<std::future<std::unique_ptr<uchar[]>>> futures;
+        for(int i = 0; i < depth; ++i) {
+            futures.push_back(pool.submit([file = seriesFiles[i], sliceBytes]() {
+                auto slice = make_uninitialized_unique<uchar[]>(sliceBytes);
+                DICOMFileImporter::readSlice(file, slice.get(), sliceBytes);
+                return slice;
+            }));
+        }
+        const int slicesPerUpdate = std::max(1, depth / m_updates);
+        for(int i = 0; i < depth; ++i) {
+            auto slice = futures[i].get();
+            std::memcpy((uchar*)volume.get() + i*sliceBytes, slice.get(), sliceBytes);
+            m_progress = (float)(i + 1) / depth;
+            if((i + 1) % slicesPerUpdate != 0 && i != depth - 1)
+                continue;
+            {
+                std::lock_guard<std::mutex> lock(m_stopMutex);
+                if(m_stop)
+                    break;
+            }
+            // Each update is a new image, so that images already sent downstream are not modified.
+            // The last image gets the volume itself, the others get a copy of the slices loaded so far.
+            Image::pointer image;
+            if(i == depth - 1) {
+                image = Image::create(size, type, 1, std::move(volume));
+                image->setLastFrame(getNameOfClass());
+            } else {
+                auto copy = allocatePixelArray((std::size_t)width*height*depth, type);
+                std::memcpy(copy.get(), volume.get(), volumeBytes);
+                image = Image::create(size, type, 1, std::move(copy));
+            }
+            image->setSpacing(spacingX, spacingY, spacingZ);
+            image->setFrameData("progress", std::to_string(m_progress));
+            try {
+                addOutputData(0, image);
+                frameAdded();
+            } catch(ThreadStopped& e) {
+                break;
+            }
+        }
+        // Wait for any remaining decoding, in case the stream was stopped
+        pool.waitForAll();
+    } catch(std::exception &e) {
+        // Exception happened in thread. Stop pipeline, and propagate error message.
+        for(auto item : mOutputConnections) {
+            for(auto output : item.second) {
+                output.lock()->stop(e.what());
+            }
+        }
+        frameAdded(); // To unlock if happens before first frame
+    }
+}
+
+DicomSeriesStreamer::~DicomSeriesStreamer() {
+    stop();
+}
+
+}
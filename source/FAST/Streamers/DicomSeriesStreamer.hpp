@@ -0,0 +1,59 @@
+#pragma once
+
+#include <FAST/Streamers/Streamer.hpp>
+#include <atomic>
+
+namespace fast {
+
+/**
+ * @brief Load a DICOM series in the background and stream the volume while it is being loaded
+ *
+ * The slices of the series are decoded in parallel, and copied into one volume.
+ * A copy of the volume is sent downstream several times while loading, with the frame data "progress"
+ * set to the fraction of slices loaded (0.0-1.0), so that it can be visualized and progress reported
+ * before the entire series is loaded. Slices not loaded yet are zero.
+ * The last volume, which is marked as last frame, contains all slices.
+ *
+ * <h3>Output ports</h3>
+ * - 0: Image
+ *
+ * @ingroup streamers
+ * @sa DICOMFileImporter
+ */
+class FAST_EXPORT DicomSeriesStreamer : public Streamer {
+    FAST_PROCESS_OBJECT(DicomSeriesStreamer)
+    public:
+        /**
+         * @brief Create instance
+         * @param filename Any DICOM file in the series to load
+         * @param threads Number of threads used to decode slices. If 0, the number of hardware threads is used.
+         * @param updates Number of times the volume is sent downstream while it is being loaded
+         * @return instance
+         */
+        FAST_CONSTRUCTOR(DicomSeriesStreamer,
+                         std::string, filename,,
+                         int, threads, = 0,
+                         int, updates, = 10
+        );
+        void setFilename(std::string filename);
+        void setNumberOfThreads(int threads);
+        void setNumberOfUpdates(int updates);
+        /**
+         * @brief Get fraction of slices loaded
+         * @return progress 0.0-1.0
+         */
+        float getProgress() const;
+        void loadAttributes() override;
+        ~DicomSeriesStreamer();
+    private:
+        DicomSeriesStreamer();
+        void execute() override;
+        void generateStream() override;
+
+        std::string m_filename;
+        int m_threads = 0;
+        int m_updates = 10;
+        std::atomic<float> m_progress{0.0f};
+};
+
+}
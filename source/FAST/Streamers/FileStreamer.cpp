@@ -1,8 +1,10 @@
 
 #include "FAST/Exception.hpp"
 #include "FileStreamer.hpp"
+#include <FAST/ThreadPool.hpp>
 #include <fstream>
 #include <chrono>
+#include <deque>
 #include "FAST/Data/Image.hpp" // TODO should not be here
 
 namespace fast {
@@ -15,12 +17,14 @@ void FileStreamer::loadAttributes() {
         disableLooping();
     }
     setFramerate(getIntegerAttribute("framerate"));
+    setReadAheadFrames(getIntegerAttribute("read-ahead"));
 }
 
 FileStreamer::FileStreamer() {
     createStringAttribute("fileformat", "Fileformat", "Fileformat for streaming e.g. /path/to/data/frame_#.xx", "");
     createBooleanAttribute("loop", "Loop", "Loop streaming", false);
     createIntegerAttribute("framerate", "Framerate", "Framerate", -1);
+    createIntegerAttribute("read-ahead", "Read ahead", "Number of frames to read ahead in parallel", m_readAheadFrames);
     mNrOfReplays = 0;
     mIsModified = true;
     mStartNumber = 0;
@@ -89,6 +93,7 @@ void FileStreamer::setFilenameFormat(std::string str) {
 
     mFilenameFormats.clear();
     mFilenameFormats.push_back(str);
+    clearFrameCache();
 }
 
 void FileStreamer::setFilenameFormats(std::vector<std::string> strs) {
@@ -97,6 +102,7 @@ void FileStreamer::setFilenameFormats(std::vector<std::string> strs) {
             throw Exception("Filename format must include a hash tag # which will be replaced by a integer starting from 0.");
     }
     mFilenameFormats = strs;
+    clearFrameCache();
 }
 
 void FileStreamer::generateStream() {
@@ -127,6 +133,54 @@ void FileStreamer::generateStream() {
         m_currentFrameIndex = 0;
     }
 
+    // Read ahead: The next frames are read by a thread pool and handed out in order.
+    // Frames are identified by filename, thus frames which are not used due to seeking or restarting are discarded.
+    std::unique_ptr<ThreadPool> readAheadPool;
+    if(m_readAheadFrames > 0)
+        readAheadPool = std::make_unique<ThreadPool>(m_readAheadFrames);
+    std::deque<std::pair<std::string, std::future<DataObject::pointer>>> readAheadQueue;
+    auto readAhead = [&](const std::string& filename) {
+        readAheadQueue.emplace_back(filename, readAheadPool->submit([this, filename]() -> DataObject::pointer {
+            {
+                std::lock_guard<std::mutex> lock(m_stopMutex);
+                if(m_stop)
+                    return nullptr;
+            }
+            return getDataFrame(filename);
+        }));
+    };
+    auto readDataFrame = [&](uint64_t i, int sequence, bool pause) {
+        const std::string filename = getFilename(i, sequence);
+        if(!readAheadPool || pause) // While paused, the same frame may be read several times
+            return getDataFrame(filename);
+        while(!readAheadQueue.empty() && readAheadQueue.front().first != filename)
+            readAheadQueue.pop_front();
+        // The queue now contains consecutive frames starting with frame i
+        for(int k = readAheadQueue.size(); k <= m_readAheadFrames; ++k) {
+            uint64_t next = i + k*mStepSize;
+            if(k > 0 && mMaximumNrOfFrames > 0 && next >= mMaximumNrOfFrames)
+                break;
+            readAhead(getFilename(next, sequence));
+        }
+        auto future = std::move(readAheadQueue.front().second);
+        readAheadQueue.pop_front();
+        auto dataFrame = future.get(); // Rethrows any exception, e.g. FileNotFoundException
+        if(!dataFrame) // Stream was stopped before frame was read
+            throw ThreadStopped();
+        return dataFrame;
+    };
+    auto getNextDataFrame = [&](uint64_t i, int sequence, bool pause) {
+        const int64_t cacheIndex = ((int64_t)sequence << 32) + (int64_t)i;
+        DataObject::pointer dataFrame;
+        if(getCachedFrame(cacheIndex, dataFrame)) {
+            dataFrame->removeLastFrame(getNameOfClass()); // Last frame is set again below if needed
+            return dataFrame;
+        }
+        dataFrame = readDataFrame(i, sequence, pause);
+        addCachedFrame(cacheIndex, dataFrame);
+        return dataFrame;
+    };
+
     int replays = 0;
     int currentSequence = 0;
     auto previousTime = std::chrono::high_resolution_clock::now();
@@ -150,7 +204,7 @@ void FileStreamer::generateStream() {
         std::string filename = getFilename(i, currentSequence);
         try {
             reportInfo() << "Filestreamer reading " << filename << reportEnd();
-            DataObject::pointer dataFrame = getDataFrame(filename);
+            DataObject::pointer dataFrame = getNextDataFrame(i, currentSequence, pause);
 
             // Timing
             if(!pause) {
@@ -264,6 +318,7 @@ void FileStreamer::setStartNumber(uint startNumber) {
 
 void FileStreamer::setZeroFilling(uint digits) {
     mZeroFillDigits = digits;
+    clearFrameCache();
 }
 
 void FileStreamer::enableLooping() {
@@ -284,4 +339,14 @@ void FileStreamer::setUseTimestamp(bool use) {
     mUseTimestamp = use;
 }
 
+void FileStreamer::setReadAheadFrames(int frames) {
+    if(frames < 0)
+        throw Exception("Number of frames to read ahead in FileStreamer must be >= 0");
+    m_readAheadFrames = frames;
+}
+
+int FileStreamer::getReadAheadFrames() const {
+    return m_readAheadFrames;
+}
+
 } // end namespace fast
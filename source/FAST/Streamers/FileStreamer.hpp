@@ -39,6 +39,17 @@ class FAST_EXPORT FileStreamer : public RandomAccessStreamer {
          * @param use
          */
         void setUseTimestamp(bool use);
+        /**
+         * @brief Set number of frames to read ahead
+         *
+         * The next frames are read concurrently by a pool of worker threads while the current frame is being
+         * processed, and are handed out in order. Thus getDataFrame must be thread-safe if this is larger than 0.
+         *
+         * @param frames Number of frames to read ahead. If 0, frames are read one by one in the streaming thread.
+         *      Default is 4.
+         */
+        void setReadAheadFrames(int frames);
+        int getReadAheadFrames() const;
 
         ~FileStreamer();
 
@@ -61,6 +72,7 @@ class FAST_EXPORT FileStreamer : public RandomAccessStreamer {
         uint mStepSize;
 
         bool mUseTimestamp = true;
+        int m_readAheadFrames = 4;
 
         std::vector<std::string> mFilenameFormats;
         std::string mTimestampFilename;
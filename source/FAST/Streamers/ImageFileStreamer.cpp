@@ -41,6 +41,7 @@ DataObject::pointer ImageFileStreamer::getDataFrame(std::string filename) {
 
 void ImageFileStreamer::setGrayscale(bool grayscale) {
     m_grayscale = grayscale;
+    clearFrameCache();
 }
 
 void ImageFileStreamer::loadAttributes() {
@@ -1,4 +1,6 @@
 #include "RandomAccessStreamer.hpp"
+#include <FAST/Data/Image.hpp>
+#include <FAST/Data/Mesh.hpp>
 
 namespace fast {
 
@@ -100,4 +102,36 @@ bool RandomAccessStreamer::getLooping() const {
     return m_loop;
 }
 
-}
\ No newline at end of file
+void RandomAccessStreamer::setFrameCacheSize(std::size_t bytes) {
+    m_frameCache.setMaxSize(bytes);
+}
+
+std::size_t RandomAccessStreamer::getFrameCacheSize() const {
+    return m_frameCache.getMaxSize();
+}
+
+void RandomAccessStreamer::clearFrameCache() {
+    m_frameCache.clear();
+}
+
+bool RandomAccessStreamer::getCachedFrame(int64_t index, DataObject::pointer& frame) {
+    if(m_frameCache.getMaxSize() == 0)
+        return false;
+    return m_frameCache.get(index, frame);
+}
+
+void RandomAccessStreamer::addCachedFrame(int64_t index, DataObject::pointer frame) {
+    if(m_frameCache.getMaxSize() == 0)
+        return;
+    m_frameCache.put(index, frame, getFrameSizeInBytes(frame));
+}
+
+std::size_t RandomAccessStreamer::getFrameSizeInBytes(DataObject::pointer frame) {
+    if(auto image = std::dynamic_pointer_cast<Image>(frame))
+        return (std::size_t)image->getNrOfVoxels()*getSizeOfDataType(image->getDataType(), image->getNrOfChannels());
+    if(auto mesh = std::dynamic_pointer_cast<Mesh>(frame)) // Position, normal, color and label per vertex
+        return (std::size_t)mesh->getNrOfVertices()*10*sizeof(float) + mesh->getNrOfTriangles()*3*sizeof(uint) + mesh->getNrOfLines()*2*sizeof(uint);
+    return sizeof(*frame);
+}
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <FAST/Streamers/Streamer.hpp>
+#include <FAST/LRUCache.hpp>
 
 namespace fast {
 
@@ -24,7 +25,40 @@ class FAST_EXPORT RandomAccessStreamer : public Streamer {
 		virtual bool getLooping() const;
 		void frameAdded() override;
         virtual void waitForUnpause();
+        /**
+         * @brief Set maximum size of the in-memory cache of frames
+         *
+         * Frames which have been streamed are kept in memory up to this size, and are reused instead of being
+         * read again when looping or when the current frame index is changed.
+         * The least recently used frames are evicted first.
+         * Note that cached frames are sent again as is, thus they should not be modified by the pipeline.
+         *
+         * @param bytes Maximum size in bytes. If 0, no frames are cached. Default is 0.
+         */
+        void setFrameCacheSize(std::size_t bytes);
+        std::size_t getFrameCacheSize() const;
+        /**
+         * @brief Remove all frames from the frame cache
+         */
+        void clearFrameCache();
 	protected:
+        /**
+         * Get a frame from the frame cache
+         * @param index Frame index
+         * @param frame Set to the cached frame if it exists
+         * @return true if frame was in the cache
+         */
+        bool getCachedFrame(int64_t index, DataObject::pointer& frame);
+        /**
+         * Add a frame to the frame cache, if enabled
+         * @param index Frame index
+         * @param frame
+         */
+        void addCachedFrame(int64_t index, DataObject::pointer frame);
+        /**
+         * Estimate the memory size of a frame in bytes
+         */
+        static std::size_t getFrameSizeInBytes(DataObject::pointer frame);
 		int m_framerate = -1;
 		bool m_pause = false;
 		bool m_pauseAfterOneFrame = false;
@@ -33,6 +67,7 @@ class FAST_EXPORT RandomAccessStreamer : public Streamer {
 		std::condition_variable m_pauseCV;
 		int m_currentFrameIndex = 0;
 		bool m_loop = false;
+		LRUCache<int64_t, DataObject::pointer> m_frameCache;
 };
 
 }
\ No newline at end of file
@@ -60,6 +60,21 @@ void Streamer::setStreamingMode(StreamingMode mode) {
     m_streamingMode = mode;
 }
 
+void Streamer::setLockFreeOutputPort(uint portID, bool lockFree) {
+    validateOutputPortExists(portID);
+    if(m_outputPOs.count(portID) > 0)
+        throw Exception("setLockFreeOutputPort must be called before getOutputPort");
+    if(lockFree) {
+        m_lockFreeOutputPorts.insert(portID);
+    } else {
+        m_lockFreeOutputPorts.erase(portID);
+    }
+}
+
+bool Streamer::isLockFreeOutputPort(uint portID) const {
+    return m_lockFreeOutputPorts.count(portID) > 0;
+}
+
 DataChannel::pointer Streamer::getOutputPort(uint portID) {
     if(m_outputPOs.count(portID) == 0) {
         auto channel = ProcessObject::getOutputPort(portID);
@@ -4,6 +4,7 @@
 #include "FAST/Data/DataTypes.hpp"
 #include "FAST/Exception.hpp"
 #include <thread>
+#include <set>
 
 namespace fast {
 
@@ -54,6 +55,17 @@ class FAST_EXPORT Streamer : public ProcessObject {
 
         void setStreamingMode(StreamingMode mode);
         StreamingMode getStreamingMode() const;
+        /**
+         * @brief Use a lock-free ring buffer for the data channel of an output port
+         *
+         * This reduces the overhead per frame, but the output port must only have one consumer.
+         * Only used when streaming mode is ProcessAllFrames. Must be called before getOutputPort.
+         *
+         * @param portID Output port
+         * @param lockFree
+         */
+        void setLockFreeOutputPort(uint portID, bool lockFree = true);
+        bool isLockFreeOutputPort(uint portID) const;
 
         virtual DataChannel::pointer getOutputPort(uint portID = 0) override;
     protected:
@@ -88,6 +100,7 @@ class FAST_EXPORT Streamer : public ProcessObject {
         std::condition_variable m_firstFrameCondition;
 
         std::map<uint, std::shared_ptr<ProcessObject>> m_outputPOs;
+        std::set<uint> m_lockFreeOutputPorts;
 
 
 };
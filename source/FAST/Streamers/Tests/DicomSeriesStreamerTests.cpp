@@ -0,0 +1,36 @@
+#include <FAST/Testing.hpp>
+#include <FAST/Streamers/DicomSeriesStreamer.hpp>
+#include <FAST/Importers/DICOMFileImporter.hpp>
+#include <FAST/Data/Image.hpp>
+#include <FAST/DataStream.hpp>
+
+using namespace fast;
+
+TEST_CASE("DicomSeriesStreamer streams volume with progress until series is loaded", "[fast][DICOM][DicomSeriesStreamer]") {
+    const std::string filename = Config::getTestDataPath() + "/CT/LIDC-IDRI-0072/000001.dcm";
+    auto streamer = DicomSeriesStreamer::create(filename, 4, 5);
+    auto stream = DataStream(streamer);
+
+    Image::pointer volume;
+    float previousProgress = 0.0f;
+    int updates = 0;
+    while(!stream.isDone()) {
+        auto next = stream.getNextFrame<Image>();
+        CHECK(next != volume); // A new image is sent for each update
+        volume = next;
+        const float progress = std::stof(volume->getFrameData("progress"));
+        CHECK(progress > previousProgress);
+        previousProgress = progress;
+        ++updates;
+    }
+    CHECK(updates >= 1);
+    CHECK(previousProgress == Approx(1.0f));
+    CHECK(volume->isLastFrame());
+
+    auto importer = DICOMFileImporter::create(filename, true);
+    auto expected = importer->runAndGetOutputData<Image>();
+    REQUIRE(volume->getSize() == expected->getSize());
+    auto access0 = volume->getImageAccess(ACCESS_READ);
+    auto access1 = expected->getImageAccess(ACCESS_READ);
+    CHECK(std::memcmp(access0->get(), access1->get(), expected->getNrOfVoxels()*getSizeOfDataType(expected->getDataType(), 1)) == 0);
+}
@@ -4,6 +4,7 @@
 #include "FAST/Streamers/ImageFileStreamer.hpp"
 #include "FAST/Tests/DummyObjects.hpp"
 #include "FAST/Data/Image.hpp"
+#include "FAST/DataStream.hpp"
 
 using namespace fast;
 
@@ -17,3 +18,35 @@ TEST_CASE("No hash tag in filename format given to ImageFileStreamer", "[fast][I
     CHECK_THROWS(mhdStreamer->setFilenameFormat("asd"));
 }
 
+
+TEST_CASE("ImageFileStreamer with read ahead streams the same frames in order", "[fast][ImageFileStreamer]") {
+    const std::string format = Config::getTestDataPath() + "US/CarotidArtery/Right/US-2D_#.mhd";
+    std::vector<std::vector<float>> averageIntensities;
+    for(int readAhead : {0, 8}) {
+        auto streamer = ImageFileStreamer::create(format, false, false);
+        streamer->setReadAheadFrames(readAhead);
+        auto stream = DataStream(streamer);
+        std::vector<float> intensities;
+        while(!stream.isDone()) {
+            auto image = stream.getNextFrame<Image>();
+            intensities.push_back(image->calculateAverageIntensity());
+        }
+        averageIntensities.push_back(intensities);
+    }
+    REQUIRE(averageIntensities[0].size() > 1);
+    REQUIRE(averageIntensities[0].size() == averageIntensities[1].size());
+    for(int i = 0; i < averageIntensities[0].size(); ++i)
+        CHECK(averageIntensities[0][i] == Approx(averageIntensities[1][i]));
+}
+
+TEST_CASE("ImageFileStreamer with frame cache reuses frames when looping", "[fast][ImageFileStreamer]") {
+    auto streamer = ImageFileStreamer::create(Config::getTestDataPath() + "US/CarotidArtery/Right/US-2D_#.mhd", true, false);
+    streamer->setFrameCacheSize(256*1024*1024);
+    const int frames = streamer->getNrOfFrames();
+    auto stream = DataStream(streamer);
+    std::vector<Image::pointer> images;
+    for(int i = 0; i < 2*frames; ++i)
+        images.push_back(stream.getNextFrame<Image>());
+    for(int i = 0; i < frames; ++i)
+        CHECK(images[i] == images[i + frames]);
+}
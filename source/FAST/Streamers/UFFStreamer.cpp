@@ -4,6 +4,8 @@
 #include <H5Cpp.h>
 #include <FAST/Algorithms/Ultrasound/ScanConverter.hpp>
 #include <FAST/Algorithms/Ultrasound/EnvelopeAndLogCompressor.hpp>
+#include <FAST/ThreadPool.hpp>
+#include <deque>
 
 namespace fast {
 
@@ -28,34 +30,45 @@ public:
     std::string dataGroupName;
     int numFrames;
     bool polarCoordinates;
-    std::vector<Image::pointer> dataScanconverted;
-    std::vector<Image::pointer> iqData;
 
     std::vector<float> azimuth_axis;
     std::vector<float> depth_axis;
 
     bool hasGrayscaleData() {
-        return !dataScanconverted.empty();
+        return isScanConverted;
     }
 };
 
 class UFFReader {
     public:
         UFFReader();
+        ~UFFReader();
         void open(std::string filename);
         void close();
-        std::string findHDF5BeamformedDataGroupName();
+        /**
+         * Read parameters and the number of frames. Frames are read later with readFrame.
+         */
         std::shared_ptr<UFFData> getUFFData();
+        /**
+         * Read a single frame from the file using a hyperslab selection.
+         */
+        Image::pointer readFrame(std::shared_ptr<UFFData> dataStruct, int frameNr);
 
     private:
         H5::H5File mFile;
+        H5::DataSet mDataset; // Scan converted data
+        H5::DataSet mRealDataset; // IQ data
+        H5::DataSet mImagDataset; // IQ data
+        int mNrOfDimensions;
+        std::string findHDF5BeamformedDataGroupName();
         void getAxisNames(H5::Group scanGroup, std::shared_ptr<UFFData> dataStruct);
         void getImageSize(H5::Group scanGroup, std::shared_ptr<UFFData> dataStruct);
         void getSpacing(H5::Group scanGroup, std::shared_ptr<UFFData> dataStruct);
         H5::Group getDataGroupAndIsScanconverted(std::shared_ptr<UFFData> dataStruct);
-        void readData(H5::Group dataGroup, std::shared_ptr<UFFData> dataStruct);
-        void readNotScanconvertedData(H5::Group dataGroup, std::shared_ptr<UFFData> dataStruct);
-        void readScanconvertedData(H5::Group dataGroup, std::shared_ptr<UFFData> dataStruct);
+        void openData(H5::Group dataGroup, std::shared_ptr<UFFData> dataStruct);
+        void selectFrame(H5::DataSpace& dataspace, std::shared_ptr<UFFData> dataStruct, int frameNr);
+        Image::pointer readNotScanconvertedFrame(std::shared_ptr<UFFData> dataStruct, int frameNr);
+        Image::pointer readScanconvertedFrame(std::shared_ptr<UFFData> dataStruct, int frameNr);
 };
 
 //Operator function to be used with H5Literate
@@ -72,14 +85,31 @@ static std::string readStringAttribute(const H5::Attribute& att) {
     return result;
 }
 
+// The HDF5 library is not thread-safe, thus all public methods of UFFReader hold the HDF5 lock
+
 UFFReader::UFFReader() {
 }
 
+UFFReader::~UFFReader() {
+    // Close all HDF5 objects while holding the lock, instead of in the member destructors
+    std::lock_guard<std::mutex> lock(getHDF5Mutex());
+    try {
+        mDataset.close();
+        mRealDataset.close();
+        mImagDataset.close();
+        mFile.close();
+    } catch(H5::Exception &e) {
+        Reporter::warning() << "Error closing UFF file: " << e.getDetailMsg() << Reporter::end();
+    }
+}
+
 void UFFReader::open(std::string filename) {
+    std::lock_guard<std::mutex> lock(getHDF5Mutex());
     mFile = H5::H5File(filename.c_str(), H5F_ACC_RDONLY);
 }
 
 void UFFReader::close() {
+    std::lock_guard<std::mutex> lock(getHDF5Mutex());
     mFile.close();
 }
 
@@ -104,6 +134,7 @@ std::string UFFReader::findHDF5BeamformedDataGroupName() {
 }
 
 std::shared_ptr<UFFData> UFFReader::getUFFData() {
+    std::lock_guard<std::mutex> lock(getHDF5Mutex());
     auto retVal = std::make_shared<UFFData>();
     retVal->groupName = findHDF5BeamformedDataGroupName();
 
@@ -115,11 +146,28 @@ std::shared_ptr<UFFData> UFFReader::getUFFData() {
     H5::Group dataGroup = getDataGroupAndIsScanconverted(retVal);
     getSpacing(scanGroup, retVal);
 
-    readData(dataGroup, retVal);
+    openData(dataGroup, retVal);
 
     return retVal;
 }
 
+Image::pointer UFFReader::readFrame(std::shared_ptr<UFFData> dataStruct, int frameNr) {
+    if(frameNr < 0 || frameNr >= dataStruct->numFrames)
+        throw Exception("Frame " + std::to_string(frameNr) + " is out of range in UFF file");
+    Image::pointer image;
+    {
+        std::lock_guard<std::mutex> lock(getHDF5Mutex());
+        if(dataStruct->isScanConverted) {
+            image = readScanconvertedFrame(dataStruct, frameNr);
+        } else {
+            image = readNotScanconvertedFrame(dataStruct, frameNr);
+        }
+    }
+    if(frameNr == dataStruct->numFrames-1)
+        image->setLastFrame("UFFStreamer");
+    return image;
+}
+
 void UFFReader::getAxisNames(H5::Group scanGroup, std::shared_ptr<UFFData> dataStruct) {
     auto classAttribute = scanGroup.openAttribute("class");
     auto className = readStringAttribute(classAttribute);
@@ -222,136 +270,92 @@ H5::Group UFFReader::getDataGroupAndIsScanconverted(std::shared_ptr<UFFData> dat
     return dataGroup;
 }
 
-void UFFReader::readData(H5::Group dataGroup, std::shared_ptr<UFFData> dataStruct) {
-
-    if(dataStruct->isScanConverted)
-        readScanconvertedData(dataGroup, dataStruct);
-    else
-        readNotScanconvertedData(dataGroup, dataStruct);
-}
-
-
-void UFFReader::readNotScanconvertedData(H5::Group dataGroup, std::shared_ptr<UFFData> dataStruct) {
-    auto dataset = dataGroup.openDataSet("imag");
-    auto dataspace = dataset.getSpace();
-    hsize_t dims_out[4];
-    int ndims = dataspace.getSimpleExtentDims(dims_out, NULL);
-
-    if(ndims != 4 && ndims != 2) {
-        throw Exception("Exepected 4 or 2 dimensions in UFF file, got " + std::to_string(ndims));
-    }
-
-    int frameCount = dims_out[0];
-    Reporter::info() << "Number of frames in UFF file: " << frameCount << Reporter::end();
-    dataStruct->numFrames = frameCount;//TODO
-
-    auto imagDataset = dataGroup.openDataSet("imag");
-    auto imagDataspace = imagDataset.getSpace();
-    auto realDataset = dataGroup.openDataSet("real");
-    auto realDataspace = realDataset.getSpace();
-
-    std::vector<hsize_t> count;
-    std::vector<hsize_t> blockSize;
-    std::vector<hsize_t> offset;
-    if(ndims == 4) {
-        count = { 1, 1, 1, 1 }; // how many blocks to extract
-        blockSize = { 1, 1, 1, hsize_t(dataStruct->width * dataStruct->height) }; // block
-        offset = { 0, 0, 0, 0 };   // hyperslab offset in the file
+void UFFReader::openData(H5::Group dataGroup, std::shared_ptr<UFFData> dataStruct) {
+    H5::DataSpace dataspace;
+    if(dataStruct->isScanConverted) {
+        mDataset = dataGroup.openDataSet("data");
+        dataspace = mDataset.getSpace();
     } else {
-        count = { 1, 1 }; // how many blocks to extract
-        blockSize = { 1, hsize_t(dataStruct->width * dataStruct->height) }; // block
-        offset = { 0, 0 };   // hyperslab offset in the file
+        mImagDataset = dataGroup.openDataSet("imag");
+        mRealDataset = dataGroup.openDataSet("real");
+        dataspace = mImagDataset.getSpace();
     }
-
-    H5::DataSpace memspace(ndims, blockSize.data());
-
-    //dataStruct.dataNotScanconverted.resize(frameCount);//Make room for pointers in vector
-    dataStruct->iqData.resize(frameCount);//Make room for pointers in vector
-
-    for(int frameNr = 0; frameNr < frameCount; ++frameNr) {
-        //std::cout << "Extracting frame " << frameNr << " in UFF file" << std::endl;
-        // Extract 1 frame
-        auto imaginary = std::make_unique<float[]>(dataStruct->width * dataStruct->height);
-        auto real = std::make_unique<float[]>(dataStruct->width * dataStruct->height);
-        offset[0] = frameNr;
-        imagDataspace.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data(), NULL, blockSize.data());
-        imagDataset.read(imaginary.get(), H5::PredType::NATIVE_FLOAT, memspace, imagDataspace);
-        realDataspace.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data(), NULL, blockSize.data());
-        realDataset.read(real.get(), H5::PredType::NATIVE_FLOAT, memspace, realDataspace);
-
-        int dataSize = dataStruct->width * dataStruct->height;
-        auto complex_image = make_uninitialized_unique<float[]>(dataSize*2);
-
-        for(int y = 0; y < dataStruct->height; ++y) {
-            for(int x = 0; x < dataStruct->width; ++x) {
-                int pos = x + y * dataStruct->width;
-                int pos2 = y + x * dataStruct->height;
-                complex_image[pos*2] = real[pos2];
-                complex_image[pos*2+1] = imaginary[pos2];
-            }
-        }
-        auto image = Image::create(dataStruct->width, dataStruct->height, TYPE_FLOAT, 2, std::move(complex_image));
-        if(frameNr == frameCount-1)
-            image->setLastFrame("UFFStreamer");
-        dataStruct->iqData[frameNr] = image;
-    }//for
-}
-
-void UFFReader::readScanconvertedData(H5::Group dataGroup, std::shared_ptr<UFFData> dataStruct) {
-    auto dataset = dataGroup.openDataSet("data");
-    auto dataspace = dataset.getSpace();
     hsize_t dims_out[4];
-    int ndims = dataspace.getSimpleExtentDims(dims_out, NULL);
-
-    if(ndims != 4 && ndims != 2) {
-        throw Exception("Exepected 4 or 2 dimensions in UFF file, got " + std::to_string(ndims));
+    mNrOfDimensions = dataspace.getSimpleExtentNdims();
+    if(mNrOfDimensions != 4 && mNrOfDimensions != 2) {
+        throw Exception("Exepected 4 or 2 dimensions in UFF file, got " + std::to_string(mNrOfDimensions));
     }
+    dataspace.getSimpleExtentDims(dims_out, NULL);
 
     int frameCount = dims_out[0];
     Reporter::info() << "Number of frames in UFF file: " << frameCount << Reporter::end();
-
     dataStruct->numFrames = frameCount;
+}
 
+void UFFReader::selectFrame(H5::DataSpace& dataspace, std::shared_ptr<UFFData> dataStruct, int frameNr) {
     std::vector<hsize_t> count;
     std::vector<hsize_t> blockSize;
     std::vector<hsize_t> offset;
-    if(ndims == 4) {
+    if(mNrOfDimensions == 4) {
         count = { 1, 1, 1, 1 }; // how many blocks to extract
         blockSize = { 1, 1, 1, hsize_t(dataStruct->width * dataStruct->height) }; // block
-        offset = { 0, 0, 0, 0 };   // hyperslab offset in the file
+        offset = { hsize_t(frameNr), 0, 0, 0 };   // hyperslab offset in the file
     } else {
         count = { 1, 1 }; // how many blocks to extract
         blockSize = { 1, hsize_t(dataStruct->width * dataStruct->height) }; // block
-        offset = { 0, 0 };   // hyperslab offset in the file
+        offset = { hsize_t(frameNr), 0 };   // hyperslab offset in the file
     }
+    dataspace.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data(), NULL, blockSize.data());
+}
 
-    H5::DataSpace memspace(4, blockSize.data());
-
-    dataStruct->dataScanconverted.resize(frameCount);//Make room for pointers in vector
-
-    for (int frameNr = 0; frameNr < frameCount; ++frameNr) {
-        //std::cout << "Extracting frame " << frameNr << " in UFF file" << std::endl;
-        // Extract 1 frame
-        auto data = std::make_unique<unsigned char[]>(dataStruct->width * dataStruct->height);
-        offset[0] = frameNr;
-        dataspace.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data(), NULL, blockSize.data());
-        dataset.read(data.get(), H5::PredType::NATIVE_UCHAR, memspace, dataspace);
-
-        int dataSize = dataStruct->width * dataStruct->height;
-        auto image_data = make_uninitialized_unique<uchar[]>(dataSize);
-        for (int y = 0; y < dataStruct->height; ++y) {
-            for (int x = 0; x < dataStruct->width; ++x) {
-                //TODO: Should axes be swapped?
-                int pos = y + x * dataStruct->height;
-                image_data[x + y * dataStruct->width] = data[pos];
-            }
+Image::pointer UFFReader::readNotScanconvertedFrame(std::shared_ptr<UFFData> dataStruct, int frameNr) {
+    const hsize_t dataSize = dataStruct->width * dataStruct->height;
+    H5::DataSpace memspace(1, &dataSize);
+    auto imagDataspace = mImagDataset.getSpace();
+    auto realDataspace = mRealDataset.getSpace();
+
+    // Extract 1 frame
+    auto imaginary = make_uninitialized_unique<float[]>(dataSize);
+    auto real = make_uninitialized_unique<float[]>(dataSize);
+    selectFrame(imagDataspace, dataStruct, frameNr);
+    mImagDataset.read(imaginary.get(), H5::PredType::NATIVE_FLOAT, memspace, imagDataspace);
+    selectFrame(realDataspace, dataStruct, frameNr);
+    mRealDataset.read(real.get(), H5::PredType::NATIVE_FLOAT, memspace, realDataspace);
+
+    auto complex_image = make_uninitialized_unique<float[]>(dataSize*2);
+
+    for(int y = 0; y < dataStruct->height; ++y) {
+        for(int x = 0; x < dataStruct->width; ++x) {
+            int pos = x + y * dataStruct->width;
+            int pos2 = y + x * dataStruct->height;
+            complex_image[pos*2] = real[pos2];
+            complex_image[pos*2+1] = imaginary[pos2];
         }
-        auto image = Image::create(dataStruct->width, dataStruct->height, TYPE_UINT8, 1, std::move(image_data));
-        image->setSpacing(dataStruct->spacing.x(), dataStruct->spacing.y(), dataStruct->spacing.z());
-        if(frameNr == frameCount-1)
-            image->setLastFrame("UFFStreamer");
-        dataStruct->dataScanconverted[frameNr] = image;
-    }//for
+    }
+    return Image::create(dataStruct->width, dataStruct->height, TYPE_FLOAT, 2, std::move(complex_image));
+}
+
+Image::pointer UFFReader::readScanconvertedFrame(std::shared_ptr<UFFData> dataStruct, int frameNr) {
+    const hsize_t dataSize = dataStruct->width * dataStruct->height;
+    H5::DataSpace memspace(1, &dataSize);
+    auto dataspace = mDataset.getSpace();
+
+    // Extract 1 frame
+    auto data = make_uninitialized_unique<unsigned char[]>(dataSize);
+    selectFrame(dataspace, dataStruct, frameNr);
+    mDataset.read(data.get(), H5::PredType::NATIVE_UCHAR, memspace, dataspace);
+
+    auto image_data = make_uninitialized_unique<uchar[]>(dataSize);
+    for (int y = 0; y < dataStruct->height; ++y) {
+        for (int x = 0; x < dataStruct->width; ++x) {
+            //TODO: Should axes be swapped?
+            int pos = y + x * dataStruct->height;
+            image_data[x + y * dataStruct->width] = data[pos];
+        }
+    }
+    auto image = Image::create(dataStruct->width, dataStruct->height, TYPE_UINT8, 1, std::move(image_data));
+    image->setSpacing(dataStruct->spacing.x(), dataStruct->spacing.y(), dataStruct->spacing.z());
+    return image;
 }
 
 void UFFStreamer::load() {
@@ -362,9 +366,10 @@ void UFFStreamer::load() {
     if(!fileExists(m_filename))
         throw FileNotFoundException(m_filename);
 
-    auto uffReader = UFFReader();
-    uffReader.open(m_filename);
-    m_uffData = uffReader.getUFFData();
+    // Only parameters are read here, frames are read one by one while streaming
+    m_uffReader = std::make_shared<UFFReader>();
+    m_uffReader->open(m_filename);
+    m_uffData = m_uffReader->getUFFData();
 }
 
 void UFFStreamer::execute() {
@@ -413,9 +418,22 @@ void UFFStreamer::loadAttributes() {
 
 void UFFStreamer::setFilename(std::string filename) {
 	m_filename = filename;
+	m_uffData.reset();
+	m_uffReader.reset();
+	clearFrameCache();
 	setModified(true);
 }
 
+void UFFStreamer::setReadAheadFrames(int frames) {
+    if(frames < 0)
+        throw Exception("Number of frames to read ahead in UFFStreamer must be >= 0");
+    m_readAheadFrames = frames;
+}
+
+int UFFStreamer::getReadAheadFrames() const {
+    return m_readAheadFrames;
+}
+
 void UFFStreamer::setName(std::string name) {
 	m_name = name;
 	setModified(true);
@@ -428,6 +446,46 @@ void UFFStreamer::generateStream() {
         m_currentFrameIndex = 0;
     }
 
+    // All frames are read by a single background thread, which holds the HDF5 lock while reading.
+    // It reads the next frames ahead while the current frame is processed.
+    ThreadPool readerThread(1);
+    std::deque<std::pair<int, std::shared_future<Image::pointer>>> readAheadQueue;
+    auto readAhead = [&](int frameNr) {
+        readAheadQueue.emplace_back(frameNr, readerThread.submit([this, frameNr]() -> Image::pointer {
+            {
+                std::lock_guard<std::mutex> lock(m_stopMutex);
+                if(m_stop)
+                    return nullptr;
+            }
+            return m_uffReader->readFrame(m_uffData, frameNr);
+        }).share());
+    };
+    auto getFrame = [&](int frameNr) -> Image::pointer {
+        DataObject::pointer cachedFrame;
+        if(getCachedFrame(frameNr, cachedFrame))
+            return std::static_pointer_cast<Image>(cachedFrame);
+        while(!readAheadQueue.empty() && readAheadQueue.front().first != frameNr)
+            readAheadQueue.pop_front();
+        if(readAheadQueue.empty())
+            readAhead(frameNr);
+        // The current frame is kept at the front of the queue, since it is requested again while paused
+        int next = readAheadQueue.back().first + 1;
+        while((int)readAheadQueue.size() <= m_readAheadFrames) {
+            if(next >= m_uffData->numFrames) {
+                if(!m_loop)
+                    break;
+                next = 0;
+            }
+            readAhead(next);
+            ++next;
+        }
+        auto image = readAheadQueue.front().second.get();
+        if(!image) // Stream was stopped before frame was read
+            throw ThreadStopped();
+        addCachedFrame(frameNr, image);
+        return image;
+    };
+
     while (true){
         bool pause = getPause();
         if(pause)
@@ -447,11 +505,11 @@ void UFFStreamer::generateStream() {
         float startTheta = m_uffData->azimuth_axis.front();
         float stopTheta = m_uffData->azimuth_axis.back();
 
-        Image::pointer image ;
-        if(m_uffData->hasGrayscaleData()) {
-            image = m_uffData->dataScanconverted[frameNr];
-        } else {
-            image = m_uffData->iqData[frameNr];
+        Image::pointer image;
+        try {
+            image = getFrame(frameNr);
+        } catch(ThreadStopped &e) {
+            break;
         }
         image->updateModifiedTimestamp();
 
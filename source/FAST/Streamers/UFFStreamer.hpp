@@ -9,12 +9,16 @@ namespace fast {
 class ScanConverter;
 class EnvelopeAndLogCompressor;
 class UFFData;
+class UFFReader;
 
 /**
  * @brief Stream ultrasound file format (UFF) data
  *
  * A streamer for reading data stored in the ultrasound file format (UFF)
  * which is essentially and HDF5 file with ultrasound image/beam data.
+ * Frames are read from the file when they are needed, and the next frames are read ahead in the background,
+ * thus startup time and memory usage does not depend on the length of the recording.
+ * Use setFrameCacheSize to keep frames in memory when looping.
  *
  * There is GUI tool called the 'UFFviewer' which uses the UFF streamer,
  * enabling you to load and play with UFF data without programming.
@@ -71,6 +75,16 @@ class FAST_EXPORT UFFStreamer : public RandomAccessStreamer {
          * @brief Set name of which HDF5 group to stream.
          */
         void setName(std::string name);
+        /**
+         * @brief Set number of frames to read ahead
+         *
+         * Frames are read from the file one at a time when needed. A background thread reads the next frames
+         * ahead while the current frame is processed.
+         *
+         * @param frames Number of frames to read ahead. Default is 4.
+         */
+        void setReadAheadFrames(int frames);
+        int getReadAheadFrames() const;
         void loadAttributes() override;
         ~UFFStreamer();
 
@@ -81,6 +95,8 @@ class FAST_EXPORT UFFStreamer : public RandomAccessStreamer {
         std::string m_filename;
         std::string m_name;
         std::shared_ptr<UFFData> m_uffData;
+        std::shared_ptr<UFFReader> m_uffReader;
+        int m_readAheadFrames = 4;
         float m_dynamicRange = 60;
         float m_gain = 10;
         bool m_doScanConversion = true;
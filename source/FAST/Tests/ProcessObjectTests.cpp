@@ -1,5 +1,6 @@
 #include <FAST/Testing.hpp>
 #include "DummyObjects.hpp"
+#include <FAST/ParallelExecutor.hpp>
 
 using namespace fast;
 
@@ -27,6 +28,30 @@ TEST_CASE("Simple pipeline with stream", "[process_all_frames][ProcessObject][fa
     CHECK(timestep == 20);
 }
 
+TEST_CASE("Simple pipeline with stream and lock-free output port", "[process_all_frames][ProcessObject][fast]") {
+    auto streamer = DummyStreamer::New();
+    streamer->setSleepTime(1);
+    streamer->setTotalFrames(20);
+    streamer->setLockFreeOutputPort(0);
+
+    auto po = DummyProcessObject::New();
+    po->setInputConnection(streamer->getOutputPort());
+
+    auto port = po->getOutputPort();
+
+    bool lastFrame = false;
+    int timestep = 0;
+    while(!lastFrame) {
+        po->update();
+        auto image = port->getNextFrame<DummyDataObject>();
+        lastFrame = image->isLastFrame();
+        CHECK(image->getID() == timestep);
+        timestep++;
+    }
+    CHECK(timestep == 20);
+    CHECK_THROWS(streamer->setLockFreeOutputPort(0, false));
+}
+
 TEST_CASE("Two step pipeline with stream", "[two_step][process_all_frames][ProcessObject][fast]") {
     auto streamer = DummyStreamer::New();
     streamer->setSleepTime(10);
@@ -406,6 +431,44 @@ TEST_CASE("Stream with multiple receiver POs PROCESS_ALL", "[process_all_frames]
 }
 
 
+TEST_CASE("Stream with multiple receiver POs PROCESS_ALL using ParallelExecutor", "[process_all_frames][ParallelExecutor][ProcessObject][fast]") {
+    const int frames = 20;
+    auto streamer = DummyStreamer::New();
+    streamer->setSleepTime(10);
+    streamer->setTotalFrames(frames);
+
+    auto po1 = DummyProcessObject::New();
+    po1->setInputConnection(streamer->getOutputPort());
+    auto po2 = DummyProcessObject::New();
+    po2->setInputConnection(streamer->getOutputPort());
+    auto po3 = DummyProcessObject::New();
+    po3->setInputConnection(po2->getOutputPort());
+
+    auto port1 = po1->getOutputPort();
+    auto port2 = po3->getOutputPort();
+
+    ParallelExecutor executor(2);
+    int timestep = 0;
+    while(timestep < frames) {
+        // Update both branches in parallel
+        executor.update({po1, po3}, timestep);
+
+        auto image1 = port1->getNextFrame<DummyDataObject>();
+        auto image2 = port2->getNextFrame<DummyDataObject>();
+
+        CHECK(image1->getID() == timestep);
+        CHECK(image2->getID() == timestep);
+        timestep++;
+    }
+}
+
+TEST_CASE("ParallelExecutor rethrows exception from process object", "[ParallelExecutor][ProcessObject][fast]") {
+    auto po = DummyProcessObject::New();
+    po->setIsModified();
+    ParallelExecutor executor(2);
+    CHECK_THROWS(executor.update(po));
+}
+
 TEST_CASE("Stream with multiple receiver POs, NEWEST_FRAME", "[ProcessObject][fast]") {
     const int frames = 20;
     auto streamer = DummyStreamer::New();
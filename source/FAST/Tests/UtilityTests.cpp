@@ -1,5 +1,8 @@
 #include "FAST/Testing.hpp"
 #include "FAST/Utility.hpp"
+#include "FAST/LRUCache.hpp"
+#include "FAST/ThreadPool.hpp"
+#include "FAST/KDTree.hpp"
 
 using namespace fast;
 
@@ -89,4 +92,78 @@ TEST_CASE("createDirectories", "[createDirectories][utility][fast]") {
     CHECK_NOTHROW(createDirectories(name4));
     CHECK(isDir(name4));
 #endif
-}
\ No newline at end of file
+}
+
+TEST_CASE("LRUCache evicts least recently used entries", "[LRUCache][utility]") {
+    LRUCache<int, int> cache(30);
+    cache.put(1, 10, 10);
+    cache.put(2, 20, 10);
+    cache.put(3, 30, 10);
+    int value;
+    REQUIRE(cache.get(1, value)); // 1 is now most recently used
+    CHECK(value == 10);
+    cache.put(4, 40, 10); // Should evict 2
+    CHECK_FALSE(cache.get(2, value));
+    CHECK(cache.get(3, value));
+    CHECK(cache.get(4, value));
+    CHECK(cache.getSize() == 30);
+    CHECK(cache.getHits() == 3);
+    CHECK(cache.getMisses() == 1);
+
+    cache.setMaxSize(10);
+    CHECK(cache.getSize() == 10);
+    CHECK(cache.get(4, value));
+    cache.remove(4);
+    CHECK(cache.getSize() == 0);
+}
+
+TEST_CASE("LRUCache removes existing entry when new value is too large", "[LRUCache][utility]") {
+    LRUCache<int, int> cache(10);
+    cache.put(1, 10, 5);
+    cache.put(1, 20, 20);
+    int value;
+    CHECK_FALSE(cache.get(1, value));
+    CHECK(cache.getSize() == 0);
+}
+
+TEST_CASE("ThreadPool runs all tasks", "[ThreadPool][utility]") {
+    ThreadPool pool(4);
+    std::vector<std::future<int>> results;
+    for(int i = 0; i < 100; ++i)
+        results.push_back(pool.submit([i]() { return i*i; }));
+    for(int i = 0; i < 100; ++i)
+        CHECK(results[i].get() == i*i);
+
+    auto future = pool.submit([]() -> int { throw Exception("Error in task"); });
+    CHECK_THROWS_AS(future.get(), Exception);
+    pool.waitForAll();
+}
+
+TEST_CASE("KDTree finds same points as brute force search", "[KDTree][utility]") {
+    MatrixXf points = MatrixXf::Random(3, 1000);
+    KDTree tree(points, 8);
+    REQUIRE(tree.getNrOfPoints() == 1000);
+    MatrixXf queries = MatrixXf::Random(3, 100);
+    std::vector<float> squaredDistances;
+    auto nearest = tree.findNearest(queries, &squaredDistances);
+    for(int i = 0; i < queries.cols(); ++i) {
+        float minDistance = std::numeric_limits<float>::max();
+        std::vector<int> withinRadius;
+        for(int j = 0; j < points.cols(); ++j) {
+            const float distance = (points.col(j) - queries.col(i)).squaredNorm();
+            minDistance = std::min(minDistance, distance);
+            if(distance <= 0.2f*0.2f)
+                withinRadius.push_back(j);
+        }
+        CHECK((points.col(nearest[i]) - queries.col(i)).squaredNorm() == Approx(minDistance));
+        CHECK(squaredDistances[i] == Approx(minDistance));
+        CHECK(tree.findNearest(VectorXf(queries.col(i))) == nearest[i]);
+        auto result = tree.findWithinRadius(queries.col(i), 0.2f);
+        std::sort(result.begin(), result.end());
+        CHECK(result == withinRadius);
+    }
+
+    KDTree empty;
+    CHECK(empty.findNearest(VectorXf::Zero(0)) == -1);
+    CHECK_THROWS_AS(tree.findNearest(VectorXf::Zero(2)), Exception);
+}
@@ -0,0 +1,54 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+namespace fast {
+
+ThreadPool::ThreadPool(int threads) {
+    if(threads <= 0)
+        threads = std::max(1, (int)std::thread::hardware_concurrency());
+    for(int i = 0; i < threads; ++i)
+        m_threads.emplace_back(&ThreadPool::run, this);
+}
+
+void ThreadPool::run() {
+    while(true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskCondition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+            if(m_stop && m_tasks.empty())
+                return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            ++m_activeTasks;
+        }
+        // Exceptions are stored in the future by packaged_task, so this will not throw
+        task();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeTasks;
+        }
+        m_finishedCondition.notify_all();
+    }
+}
+
+void ThreadPool::waitForAll() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finishedCondition.wait(lock, [this] { return m_tasks.empty() && m_activeTasks == 0; });
+}
+
+int ThreadPool::getNumberOfThreads() const {
+    return m_threads.size();
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_taskCondition.notify_all();
+    for(auto& thread : m_threads)
+        thread.join();
+}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "FASTExport.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace fast {
+
+/**
+ * @brief A simple fixed size pool of worker threads
+ *
+ * Tasks are executed in FIFO order by the first available worker.
+ * Each submitted task returns a std::future which can be used to retrieve the result,
+ * or an exception thrown by the task.
+ * The destructor waits for all submitted tasks to finish before joining the threads.
+ */
+class FAST_EXPORT ThreadPool {
+    public:
+        /**
+         * @brief Create a thread pool
+         * @param threads Number of worker threads. If <= 0, the number of hardware threads is used.
+         */
+        explicit ThreadPool(int threads = 0);
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        /**
+         * @brief Submit a task to the pool
+         * @tparam F Callable type
+         * @param function Callable with no arguments
+         * @return future for the result of the callable
+         */
+        template <class F>
+        std::future<std::invoke_result_t<std::decay_t<F>>> submit(F&& function);
+        /**
+         * @brief Block until all submitted tasks have finished
+         */
+        void waitForAll();
+        /**
+         * @brief Get number of worker threads in this pool
+         * @return nr of threads
+         */
+        int getNumberOfThreads() const;
+        ~ThreadPool();
+    private:
+        void run();
+
+        std::vector<std::thread> m_threads;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_taskCondition;
+        std::condition_variable m_finishedCondition;
+        int m_activeTasks = 0;
+        bool m_stop = false;
+};
+
+template <class F>
+std::future<std::invoke_result_t<std::decay_t<F>>> ThreadPool::submit(F&& function) {
+    typedef std::invoke_result_t<std::decay_t<F>> ReturnType;
+    // std::function requires a copyable callable, thus the packaged_task is wrapped in a shared_ptr
+    auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<F>(function));
+    auto future = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.emplace_back([task]() { (*task)(); });
+    }
+    m_taskCondition.notify_one();
+    return future;
+}
+
+}
@@ -1177,6 +1177,11 @@ uint64_t fileSize(std::string filename) {
     return stat_buf.st_size;
 }
 
+std::mutex& getHDF5Mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
 std::string generateRandomString(int length) {
     static auto& chrs = "0123456789"
                         "abcdefghijklmnopqrstuvwxyz"
@@ -5,6 +5,7 @@
 #include <functional>
 #include <cctype>
 #include <locale>
+#include <mutex>
 
 // This file contains a set of utility functions
 
@@ -198,6 +199,15 @@ FAST_EXPORT bool fileExists(std::string filename);
  */
 FAST_EXPORT uint64_t fileSize(std::string filename);
 
+/**
+ * @brief Get the mutex which must be held for all calls to the HDF5 library
+ *
+ * The HDF5 library is not thread-safe. Thus all HDF5 calls in FAST, including destruction of HDF5 objects,
+ * are serialized with this mutex, also when they are made from different threads and process objects.
+ * @return mutex
+ */
+FAST_EXPORT std::mutex& getHDF5Mutex();
+
 /**
  * Returns a list of all files in a directory
  * @param path
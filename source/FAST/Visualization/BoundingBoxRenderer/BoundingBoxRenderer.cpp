@@ -2,6 +2,7 @@
 #include "FAST/Data/BoundingBox.hpp"
 #include "FAST/Data/SpatialDataObject.hpp"
 #include <FAST/Visualization/View.hpp>
+#include <limits>
 
 namespace fast {
 
@@ -22,6 +23,8 @@ BoundingBoxRenderer::BoundingBoxRenderer(float borderSize, std::map<uint, Color>
 
 BoundingBoxRenderer::~BoundingBoxRenderer() {
 	glDeleteBuffers(1, &m_colorsUBO);
+    for(auto&& EBO : m_visibleLinesEBO)
+        glDeleteBuffers(1, &EBO.second);
 }
 
 void BoundingBoxRenderer::setBorderSize(float borderSize) {
@@ -44,6 +47,17 @@ void BoundingBoxRenderer::draw(Matrix4f perspectiveMatrix, Matrix4f viewingMatri
     auto colorsIndex = glGetUniformBlockIndex(getShaderProgram(), "Colors");   
 	glUniformBlockBinding(getShaderProgram(), colorsIndex, 0);
     glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_colorsUBO); 
+    // Find corners of the view in world coordinates, to only draw the boxes which are visible.
+    // Unprojecting the corners at z=0 is only valid for an orthographic projection, thus culling is skipped otherwise.
+    const bool orthographic = perspectiveMatrix(3, 0) == 0 && perspectiveMatrix(3, 1) == 0 && perspectiveMatrix(3, 2) == 0;
+    const Matrix4f inverseViewProjection = (perspectiveMatrix*viewingMatrix).inverse();
+    std::vector<Vector3f> viewCorners;
+    for(float x : {-1.0f, 1.0f}) {
+        for(float y : {-1.0f, 1.0f}) {
+            const Vector4f corner = inverseViewProjection*Vector4f(x, y, 0, 1);
+            viewCorners.push_back(corner.head(3)/corner.w());
+        }
+    }
     // For all input data
     for(auto it : dataToRender) {
         auto boxes = std::static_pointer_cast<BoundingBoxSet>(it.second);
@@ -54,6 +68,34 @@ void BoundingBoxRenderer::draw(Matrix4f perspectiveMatrix, Matrix4f viewingMatri
         if(boxes->getNrOfLines() == 0)
             continue;
 
+        Affine3f transform = Affine3f::Identity();
+        // If rendering is in 2D mode we skip any transformations
+        if(!mode2D) {
+            transform = SceneGraph::getEigenTransformFromData(it.second);
+        }
+
+        const std::size_t nrOfBoxes = boxes->getNrOfLines() / 4;
+        std::vector<uint> visibleBoxes;
+        if(orthographic) {
+            // Map the view to the coordinate system of the data
+            const Affine3f inverseTransform = transform.inverse();
+            Vector2f viewMin = Vector2f::Constant(std::numeric_limits<float>::max());
+            Vector2f viewMax = Vector2f::Constant(std::numeric_limits<float>::lowest());
+            for(const auto& corner : viewCorners) {
+                const Vector2f dataCorner = (inverseTransform*corner).head(2);
+                viewMin = viewMin.cwiseMin(dataCorner);
+                viewMax = viewMax.cwiseMax(dataCorner);
+            }
+            // Query spatial index for boxes in view. Pad with border size, since borders are drawn outside the box.
+            auto hostAccess = boxes->getAccess(ACCESS_READ);
+            visibleBoxes = hostAccess->getBoundingBoxesInRegion(
+                    viewMin - Vector2f::Constant(borderSize),
+                    viewMax + Vector2f::Constant(borderSize)
+            );
+            if(visibleBoxes.empty())
+                continue;
+        }
+
         // TODO if VAO already exists, and data has not changed...
 
         // Delete old VAO
@@ -66,15 +108,10 @@ void BoundingBoxRenderer::draw(Matrix4f perspectiveMatrix, Matrix4f viewingMatri
         mVAO[it.first] = VAO_ID;
         glBindVertexArray(VAO_ID);
 
-        Affine3f transform = Affine3f::Identity();
-        // If rendering is in 2D mode we skip any transformations
-        if(!mode2D) {
-            transform = SceneGraph::getEigenTransformFromData(it.second);
-        }
         setShaderUniform("transform", transform);
 
         Color color = m_defaultColor;
-        
+
         auto access = boxes->getOpenGLAccess(ACCESS_READ);
 
         // Coordinates
@@ -94,9 +131,30 @@ void BoundingBoxRenderer::draw(Matrix4f perspectiveMatrix, Matrix4f viewingMatri
 		glVertexAttribIPointer(1, 1, GL_UNSIGNED_BYTE, sizeof(uchar), nullptr);
         glEnableVertexAttribArray(1);
 
-		GLuint EBO = access->getLinesEBO();
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-		glDrawElements(GL_LINES, boxes->getNrOfLines() * 2, GL_UNSIGNED_INT, nullptr);
+		if(orthographic && visibleBoxes.size() < nrOfBoxes / 2) {
+            // Only a small part of the set is visible, thus create a line index buffer for the visible boxes only
+            std::vector<uint> lines;
+            lines.reserve(visibleBoxes.size()*8);
+            for(uint box : visibleBoxes) {
+                const uint vertex = box*4;
+                for(uint i = 0; i < 4; ++i) {
+                    lines.push_back(vertex + i);
+                    lines.push_back(vertex + (i + 1) % 4);
+                }
+            }
+            if(m_visibleLinesEBO.count(it.first) == 0) {
+                GLuint EBO;
+                glGenBuffers(1, &EBO);
+                m_visibleLinesEBO[it.first] = EBO;
+            }
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_visibleLinesEBO[it.first]);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, lines.size()*sizeof(uint), lines.data(), GL_STREAM_DRAW);
+            glDrawElements(GL_LINES, lines.size(), GL_UNSIGNED_INT, nullptr);
+		} else {
+            GLuint EBO = access->getLinesEBO();
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+            glDrawElements(GL_LINES, boxes->getNrOfLines() * 2, GL_UNSIGNED_INT, nullptr);
+		}
         glBindVertexArray(0);
     }
     deactivateShader();
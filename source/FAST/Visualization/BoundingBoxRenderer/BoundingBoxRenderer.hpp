@@ -42,6 +42,7 @@ class FAST_EXPORT BoundingBoxRenderer : public LabelColorRenderer {
         std::unordered_map<uint, float> mInputWidths;
         std::unordered_map<uint, bool> mInputDrawOnTop;
         std::unordered_map<uint, uint> mVAO;
+        std::unordered_map<uint, uint> m_visibleLinesEBO;
 
         float m_borderSize;
 };
@@ -1,6 +1,7 @@
 #include "ComputationThread.hpp"
 #include "SimpleWindow.hpp"
 #include "View.hpp"
+#include <FAST/ParallelExecutor.hpp>
 #include <QGLContext>
 #include <QApplication>
 #include <QMessageBox>
@@ -40,10 +41,12 @@ void ComputationThread::run() {
 		bool canUpdate = false;
         std::vector<View*> mViews;
         std::vector<std::shared_ptr<ProcessObject>> processObjects;
+        std::shared_ptr<ParallelExecutor> executor;
         {
             std::unique_lock<std::mutex> lock(mUpdateThreadMutex); // this locks the mutex
             mViews = getViews();
             processObjects = getProcessObjects();
+            executor = m_executor;
             if(mStop)
                 break;
             if(processObjects.size() > 0)
@@ -61,6 +64,18 @@ void ComputationThread::run() {
 		bool isStreaming = false;
 		bool isDone = true;
         try {
+            if(executor) {
+                // Update all process objects and renderer inputs in parallel first.
+                // The update calls below will then not re-execute anything because of the execute token.
+                std::vector<std::shared_ptr<ProcessObject>> sinks = processObjects;
+                for(View *view : mViews) {
+                    for(auto renderer : view->getRenderers()) {
+                        for(int i = 0; i < renderer->getNrOfInputConnections(); ++i)
+                            sinks.push_back(renderer->getInputPort(i)->getProcessObject());
+                    }
+                }
+                executor->update(sinks, executeToken);
+            }
             for(auto po : processObjects) {
                 po->update(executeToken);
                 for(int i = 0; i < po->getNrOfInputConnections(); ++i) {
@@ -275,6 +290,11 @@ void ComputationThread::setPipeline(const Pipeline &pipeline) {
     m_signalFinished = true;
 }
 
+void ComputationThread::setParallelExecutor(std::shared_ptr<ParallelExecutor> executor) {
+    std::lock_guard<std::mutex> lock(mUpdateThreadMutex);
+    m_executor = executor;
+}
+
 void ComputationThread::reset() {
     std::lock_guard<std::mutex> lock(mUpdateThreadMutex);
     m_signalFinished = true;
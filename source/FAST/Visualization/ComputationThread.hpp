@@ -13,6 +13,7 @@ namespace fast {
 
 class ProcessObject;
 class View;
+class ParallelExecutor;
 
 class FAST_EXPORT ComputationThread : public QObject, public Object {
     Q_OBJECT
@@ -49,6 +50,15 @@ class FAST_EXPORT ComputationThread : public QObject, public Object {
          * @param pipeline
          */
         void setPipeline(const Pipeline& pipeline);
+        /**
+         * @brief Use a parallel executor to update the process objects and renderer inputs of this thread
+         *
+         * Independent branches of the pipelines are then executed concurrently.
+         * Renderers are still updated in this thread.
+         *
+         * @param executor Parallel executor, set to nullptr to disable
+         */
+        void setParallelExecutor(std::shared_ptr<ParallelExecutor> executor);
         void reset();
     public Q_SLOTS:
         void run();
@@ -78,6 +88,7 @@ class FAST_EXPORT ComputationThread : public QObject, public Object {
 
         std::vector<View*> m_views;
         std::vector<std::shared_ptr<ProcessObject>> m_processObjects;
+        std::shared_ptr<ParallelExecutor> m_executor;
 
         bool mStop = false;
         bool m_signalFinished = true;